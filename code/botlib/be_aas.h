@@ -201,3 +201,11 @@ typedef struct aas_predictroute_s
 	int numareas;			//number of areas predicted ahead
 	int time;				//time predicted ahead (in hundreth of a sec)
 } aas_predictroute_t;
+
+//route that is likely to be queried this frame, see AAS_PrepareRoutes
+typedef struct aas_routequery_s
+{
+	int areanum;			//area to route from
+	int goalareanum;		//area to route to
+	int travelflags;		//travel flags used for the route
+} aas_routequery_t;
@@ -72,6 +72,8 @@ bsp_trace_t AAS_Trace(	vec3_t start,
 								int contentmask);
 //returns the contents at the given point
 int AAS_PointContents(vec3_t point);
+//sets the lock for point contents checks from job threads
+void AAS_SetPointContentsLock(void *lock);
 //returns true when p2 is in the PVS of p1
 qboolean AAS_inPVS(vec3_t p1, vec3_t p2);
 //returns true when p2 is in the PHS of p1
@@ -89,6 +89,8 @@ typedef struct bsp_s
 	//bsp entities
 	int numentities;
 	bsp_entity_t entities[MAX_BSPENTITIES];
+	//lock for point contents checks from job threads
+	void *pointcontentslock;
 } bsp_t;
 
 //global bsp
@@ -117,9 +119,27 @@ bsp_trace_t AAS_Trace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int pa
 //===========================================================================
 int AAS_PointContents(vec3_t point)
 {
-	return botimport.PointContents(point);
+	int contents;
+
+	if (!bspworld.pointcontentslock) return botimport.PointContents(point);
+	botimport.LockMutex(bspworld.pointcontentslock);
+	contents = botimport.PointContents(point);
+	botimport.UnlockMutex(bspworld.pointcontentslock);
+	return contents;
 } //end of the function AAS_PointContents
 //===========================================================================
+// the engine point contents check isn't thread safe, the lock is set while
+// it is called from job threads
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_SetPointContentsLock(void *lock)
+{
+	bspworld.pointcontentslock = lock;
+} //end of the function AAS_SetPointContentsLock
+//===========================================================================
 //
 // Parameter:				-
 // Returns:					-
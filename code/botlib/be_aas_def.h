@@ -41,6 +41,10 @@ Suite 120, Rockville, Maryland 20850 USA.
 #define AAS_DEBUG
 
 #define	MAX_CLIENTS			64
+//maximum number of jobs creating routing caches at the same time
+#define MAX_ROUTINGJOBS		16
+//number of routing cache shards for the portal caches
+#define NUM_PORTALCACHESHARDS	16
 
 #define DF_AASENTNUMBER(x)		(x - aasworld.entities)
 #define DF_NUMBERAASENT(x)		(&aasworld.entities[x])
@@ -139,6 +143,7 @@ typedef struct aas_settings_s
 typedef struct aas_routingcache_s
 {
 	byte type;									//portal or area cache
+	byte precomputed;							//read from the route cache file, never freed
 	float time;									//last time accessed or updated
 	int size;									//size of the routing cache
 	int cluster;								//cluster the cache is for
@@ -149,7 +154,7 @@ typedef struct aas_routingcache_s
 	struct aas_routingcache_s *prev, *next;
 	struct aas_routingcache_s *time_prev, *time_next;
 	unsigned char *reachabilities;				//reachabilities used for routing
-	unsigned short int traveltimes[1];			//travel time for every area (variable sized)
+	unsigned short int *traveltimes;			//travel time for every area
 } aas_routingcache_t;
 
 //fields for the routing algorithm
@@ -165,6 +170,19 @@ typedef struct aas_routingupdate_s
 	struct aas_routingupdate_s *prev;
 } aas_routingupdate_t;
 
+//part of the routing cache with its own lock, one for the area caches of
+//every cluster and a fixed number for the portal caches
+typedef struct aas_routingshard_s
+{
+	void *lock;									//NULL without job threads
+	aas_routingcache_t *oldestcache;			//start of cache list sorted on time
+	aas_routingcache_t *newestcache;			//end of cache list sorted on time
+	aas_routingupdate_t *update;				//routing update fields
+	int hits;									//cache lookups that found a cache
+	int misses;									//cache lookups that created a cache
+	int evictions;								//caches freed to save memory
+} aas_routingshard_t;
+
 //reversed reachability link
 typedef struct aas_reversedlink_s
 {
@@ -231,6 +249,11 @@ typedef struct aas_s
 	//nodes of the bsp tree
 	int numnodes;
 	aas_node_t *nodes;
+	//grid with the node to start point and line queries in every cell
+	vec3_t areagridmins;
+	float areagridcellsize;
+	int areagridsize[3];
+	int *areagrid;
 	//cluster portals
 	int numportals;
 	aas_portal_t *portals;
@@ -258,7 +281,6 @@ typedef struct aas_s
 	int *areacontentstravelflags;
 	//routing update
 	aas_routingupdate_t *areaupdate;
-	aas_routingupdate_t *portalupdate;
 	//number of routing updates during a frame (reset every frame)
 	int frameroutingupdates;
 	//reversed reachability links
@@ -268,9 +290,18 @@ typedef struct aas_s
 	//array of size numclusters with cluster cache
 	aas_routingcache_t ***clusterareacache;
 	aas_routingcache_t **portalcache;
-	//cache list sorted on time
-	aas_routingcache_t *oldestcache;		// start of cache list sorted on time
-	aas_routingcache_t *newestcache;		// end of cache list sorted on time
+	//routing cache shards
+	aas_routingshard_t *clustershards;			//one for every cluster
+	aas_routingshard_t portalshards[NUM_PORTALCACHESHARDS];
+	void *routingmemorylock;					//protects routing cache memory
+	//routing caches read from the route cache file
+	int numprecomputedcaches;
+	int precomputedcachesize;
+	void *precomputedcachefile;					//mapped route cache file
+	byte *changedareas;							//areas enabled or disabled since the file was read
+	int *clusterchangedareas;					//number of changed areas in every cluster
+	int numchangedareas;
+	int evictshard;								//next shard to free a cache from
 	//maximum travel time through portal areas
 	int *portalmaxtraveltimes;
 	//areas the reachabilities go through
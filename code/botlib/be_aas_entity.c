@@ -51,6 +51,37 @@ Suite 120, Rockville, Maryland 20850 USA.
 #include "be_interface.h"
 #include "be_aas_def.h"
 
+//maximum number of areas an entity is checked against before relinking
+#define MAX_ENTITYAREAS			64
+
+//===========================================================================
+// returns true if the entity with the new bounding box would be linked
+// into other areas than the ones it's linked into now
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static qboolean AAS_EntityAreasChanged(aas_entity_t *ent, vec3_t absmins, vec3_t absmaxs)
+{
+	int i, numareas, areas[MAX_ENTITYAREAS];
+	vec3_t mins, maxs, newabsmins, newabsmaxs;
+	aas_link_t *link;
+
+	if (!ent->areas) return qtrue;
+	//same bounding box as AAS_LinkEntityClientBBox with PRESENCE_NORMAL
+	AAS_PresenceTypeBoundingBox(PRESENCE_NORMAL, mins, maxs);
+	VectorSubtract(absmins, maxs, newabsmins);
+	VectorSubtract(absmaxs, mins, newabsmaxs);
+	numareas = AAS_BoxAreaNums(newabsmins, newabsmaxs, areas, MAX_ENTITYAREAS);
+	if (numareas >= MAX_ENTITYAREAS) return qtrue;
+	//the entity links are in the reversed order the areas were visited
+	for (i = numareas - 1, link = ent->areas; link; link = link->next_area, i--)
+	{
+		if (i < 0 || areas[i] != link->areanum) return qtrue;
+	} //end for
+	return i >= 0;
+} //end of the function AAS_EntityAreasChanged
 //===========================================================================
 //
 // Parameter:				-
@@ -93,10 +124,14 @@ int AAS_UpdateEntity(int entnum, bot_entitystate_t *state)
 		//don't link the world model
 		if (entnum != ENTITYNUM_WORLD)
 		{
-			//unlink the entity
-			AAS_UnlinkFromAreas(ent->areas);
-			//relink the entity to the AAS areas (use the larges bbox)
-			ent->areas = AAS_LinkEntityClientBBox(state->absmins, state->absmaxs, entnum, PRESENCE_NORMAL);
+			//only relink when the entity entered or left an area
+			if (AAS_EntityAreasChanged(ent, state->absmins, state->absmaxs))
+			{
+				//unlink the entity
+				AAS_UnlinkFromAreas(ent->areas);
+				//relink the entity to the AAS areas (use the larges bbox)
+				ent->areas = AAS_LinkEntityClientBBox(state->absmins, state->absmaxs, entnum, PRESENCE_NORMAL);
+			} //end if
 			//unlink the entity from the BSP leaves
 			AAS_UnlinkFromBSPLeaves(ent->leaves);
 			//link the entity to the world BSP tree
@@ -106,6 +141,47 @@ int AAS_UpdateEntity(int entnum, bot_entitystate_t *state)
 	return BLERR_NOERROR;
 } //end of the function AAS_UpdateEntity
 //===========================================================================
+// updates the entities in the list and unlinks all other entities, the
+// entity numbers must be in ascending order
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+int AAS_UpdateEntities(int *entnums, bot_entitystate_t *states, int numentities)
+{
+	int i, entnum, nextentnum;
+
+	if (!aasworld.loaded)
+	{
+		botimport.Print(PRT_MESSAGE, "AAS_UpdateEntities: not loaded\n");
+		return BLERR_NOAASFILE;
+	} //end if
+	//
+	nextentnum = 0;
+	for (i = 0; i < numentities; i++)
+	{
+		entnum = entnums[i];
+		if (entnum < nextentnum || entnum >= aasworld.maxentities)
+		{
+			botimport.Print(PRT_ERROR, "AAS_UpdateEntities: invalid entity number %d\n", entnum);
+			return BLERR_INVALIDENTITYNUMBER;
+		} //end if
+		//unlink the entities that aren't in the list
+		for (; nextentnum < entnum; nextentnum++)
+		{
+			AAS_UpdateEntity(nextentnum, NULL);
+		} //end for
+		AAS_UpdateEntity(entnum, &states[i]);
+		nextentnum = entnum + 1;
+	} //end for
+	for (; nextentnum < aasworld.maxentities; nextentnum++)
+	{
+		AAS_UpdateEntity(nextentnum, NULL);
+	} //end for
+	return BLERR_NOERROR;
+} //end of the function AAS_UpdateEntities
+//===========================================================================
 //
 // Parameter:				-
 // Returns:					-
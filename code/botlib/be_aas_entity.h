@@ -46,5 +46,7 @@ void AAS_UnlinkInvalidEntities(void);
 void AAS_ResetEntityLinks(void);
 //updates an entity
 int AAS_UpdateEntity(int ent, bot_entitystate_t *state);
+//updates the listed entities and unlinks all others
+int AAS_UpdateEntities(int *entnums, bot_entitystate_t *states, int numentities);
 #endif //AASINTERN
 
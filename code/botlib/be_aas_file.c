@@ -223,6 +223,7 @@ void AAS_DumpAASData(void)
 	aasworld.numnodes = 0;
 	if (aasworld.nodes) FreeMemory(aasworld.nodes);
 	aasworld.nodes = NULL;
+	AAS_FreeAreaGrid();
 	aasworld.numportals = 0;
 	if (aasworld.portals) FreeMemory(aasworld.portals);
 	aasworld.portals = NULL;
@@ -164,14 +164,15 @@ int AAS_StartFrame(float time)
 	AAS_ContinueInit(time);
 	//
 	aasworld.frameroutingupdates = 0;
+	//routing cache hits, misses and evictions
+	if (LibVarGetValue("showcacheupdates"))
+	{
+		AAS_RoutingInfo();
+		LibVarSet("showcacheupdates", "0");
+	} //end if
 	//
 	if (botDeveloper)
 	{
-		if (LibVarGetValue("showcacheupdates"))
-		{
-			AAS_RoutingInfo();
-			LibVarSet("showcacheupdates", "0");
-		} //end if
 		if (LibVarGetValue("showmemoryusage"))
 		{
 			PrintUsedMemorySize();
@@ -190,6 +191,18 @@ int AAS_StartFrame(float time)
 		LibVarSet("saveroutingcache", "0");
 	} //end if
 	//
+	if (LibVarGetValue("routingbenchmark"))
+	{
+		AAS_RoutingBenchmark();
+		LibVarSet("routingbenchmark", "0");
+	} //end if
+	//
+	if (LibVarGetValue("precomputeroutecache"))
+	{
+		AAS_PrecomputeRouteCache();
+		LibVarSet("precomputeroutecache", "0");
+	} //end if
+	//
 	aasworld.numframes++;
 	return BLERR_NOERROR;
 } //end of the function AAS_StartFrame
@@ -284,6 +297,8 @@ int AAS_LoadMap(const char *mapname)
 	AAS_InitAASLinkHeap();
 	//initialize the AAS linked entities for the new map
 	AAS_InitAASLinkedEntities();
+	//initialize the grid used to speed up point and line queries
+	AAS_InitAreaGrid();
 	//initialize reachability for the new map
 	AAS_InitReachability();
 	//initialize the alternative routing
@@ -89,6 +89,15 @@ int reach_strafejump;	//strafe jump (just normal jump but further)
 int reach_rocketjump;	//rocket jump
 int reach_bfgjump;		//bfg jump
 int reach_jumppad;		//jump pads
+//the counters of the reachabilities
+#define MAX_REACHABILITYCOUNTERS		19
+int *reachcounters[MAX_REACHABILITYCOUNTERS] = {
+	&reach_swim, &reach_equalfloor, &reach_step, &reach_walk, &reach_barrier,
+	&reach_waterjump, &reach_walkoffledge, &reach_jump, &reach_ladder,
+	&reach_teleport, &reach_elevator, &reach_funcbob, &reach_grapple,
+	&reach_doublejump, &reach_rampjump, &reach_strafejump, &reach_rocketjump,
+	&reach_bfgjump, &reach_jumppad
+};
 //if true grapple reachabilities are skipped
 int calcgrapplereach;
 //linked reachability
@@ -110,6 +119,43 @@ aas_lreachability_t *nextreachability;	//next free reachability from the heap
 aas_lreachability_t **areareachability;	//reachability links for every area
 int numlreachabilities;
 
+//maximum number of jobs calculating reachabilities at the same time
+#define MAX_REACHABILITYJOBS		16
+//number of reachabilities in a chunk of a reachability job heap
+#define REACHABILITYCHUNKSIZE		256
+
+//reachability created by a reachability job
+typedef struct aas_jobreachability_s
+{
+	aas_lreachability_t reach;		//must be first
+	int area1num, area2num;			//areas the reachabilities were checked for
+	int areanum;					//area the reachability is stored for
+	int checkareanum;				//area that may not have reachabilities with area1num
+	int *counter;					//number of reachabilities of the type
+} aas_jobreachability_t;
+
+//part of the reachability heap of a reachability job
+typedef struct aas_reachabilitychunk_s
+{
+	int numreachabilities;
+	aas_jobreachability_t reachabilities[REACHABILITYCHUNKSIZE];
+	struct aas_reachabilitychunk_s *next;
+} aas_reachabilitychunk_t;
+
+//reachability job calculating the reachabilities between an area range and
+//all other areas, the reachabilities are merged in area order afterwards
+typedef struct aas_reachabilityjob_s
+{
+	int firstarea, lastarea;					//areas of the job
+	int area1num, area2num;						//areas being checked
+	int checkareanum;							//area found by the ladder checks
+	aas_reachabilitychunk_t *firstchunk;		//reachability heap of the job
+	aas_reachabilitychunk_t *lastchunk;
+} aas_reachabilityjob_t;
+
+//protects memory allocation while reachability jobs run
+void *reachabilityjoblock;
+
 //===========================================================================
 // returns the surface area of the given face
 //
@@ -521,6 +567,78 @@ void AAS_FreeReachability(aas_lreachability_t *lreach)
 	numlreachabilities--;
 } //end of the function AAS_FreeReachability
 //===========================================================================
+// returns a reachability link for the areas being checked, a reachability
+// job takes it from its own heap
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+aas_lreachability_t *AAS_AllocPairReachability(aas_reachabilityjob_t *job)
+{
+	aas_reachabilitychunk_t *chunk;
+	aas_jobreachability_t *jobreach;
+
+	if (!job) return AAS_AllocReachability();
+	//
+	chunk = job->lastchunk;
+	if (!chunk || chunk->numreachabilities >= REACHABILITYCHUNKSIZE)
+	{
+		botimport.LockMutex(reachabilityjoblock);
+		chunk = (aas_reachabilitychunk_t *) GetMemory(sizeof(aas_reachabilitychunk_t));
+		botimport.UnlockMutex(reachabilityjoblock);
+		chunk->numreachabilities = 0;
+		chunk->next = NULL;
+		if (job->lastchunk) job->lastchunk->next = chunk;
+		else job->firstchunk = chunk;
+		job->lastchunk = chunk;
+	} //end if
+	jobreach = &chunk->reachabilities[chunk->numreachabilities++];
+	Com_Memset(jobreach, 0, sizeof(aas_jobreachability_t));
+	jobreach->area1num = job->area1num;
+	jobreach->area2num = job->area2num;
+	jobreach->checkareanum = job->checkareanum;
+	return &jobreach->reach;
+} //end of the function AAS_AllocPairReachability
+//===========================================================================
+// stores the reachability link for the given area, a reachability job
+// only remembers the area until the links are merged
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_LinkPairReachability(aas_reachabilityjob_t *job, int areanum, aas_lreachability_t *lreach)
+{
+	aas_jobreachability_t *jobreach;
+
+	if (!job)
+	{
+		lreach->next = areareachability[areanum];
+		areareachability[areanum] = lreach;
+		return;
+	} //end if
+	jobreach = (aas_jobreachability_t *) lreach;
+	jobreach->areanum = areanum;
+} //end of the function AAS_LinkPairReachability
+//===========================================================================
+// counts the reachability link, a reachability job leaves the counting to
+// the merge so only the links that are kept are counted
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_CountPairReachability(aas_reachabilityjob_t *job, aas_lreachability_t *lreach, int *counter)
+{
+	if (!job)
+	{
+		(*counter)++;
+		return;
+	} //end if
+	((aas_jobreachability_t *) lreach)->counter = counter;
+} //end of the function AAS_CountPairReachability
+//===========================================================================
 // returns qtrue if the area has reachability links
 //
 // Parameter:				-
@@ -840,7 +958,7 @@ int AAS_NearbySolidOrGap(vec3_t start, vec3_t end)
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-int AAS_Reachability_Swim(int area1num, int area2num)
+int AAS_Reachability_Swim(aas_reachabilityjob_t *job, int area1num, int area2num)
 {
 	int i, j, face1num, face2num, side1;
 	aas_area_t *area1, *area2;
@@ -882,7 +1000,7 @@ int AAS_Reachability_Swim(int area1num, int area2num)
 					//
 					face1 = &aasworld.faces[face1num];
 					//create a new reachability link
-					lreach = AAS_AllocReachability();
+					lreach = AAS_AllocPairReachability(job);
 					if (!lreach) return qfalse;
 					lreach->areanum = area2num;
 					lreach->facenum = face1num;
@@ -897,9 +1015,8 @@ int AAS_Reachability_Swim(int area1num, int area2num)
 						lreach->traveltime += 200;
 					//if (!(AAS_PointContents(start) & MASK_WATER)) lreach->traveltime += 500;
 					//link the reachability
-					lreach->next = areareachability[area1num];
-					areareachability[area1num] = lreach;
-					reach_swim++;
+					AAS_LinkPairReachability(job, area1num, lreach);
+					AAS_CountPairReachability(job, lreach, &reach_swim);
 					return qtrue;
 				} //end if
 			} //end if
@@ -915,7 +1032,7 @@ int AAS_Reachability_Swim(int area1num, int area2num)
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-int AAS_Reachability_EqualFloorHeight(int area1num, int area2num)
+int AAS_Reachability_EqualFloorHeight(aas_reachabilityjob_t *job, int area1num, int area2num)
 {
 	int i, j, edgenum, edgenum1, edgenum2, foundreach, side;
 	float height, bestheight, length, bestlength;
@@ -1023,7 +1140,7 @@ int AAS_Reachability_EqualFloorHeight(int area1num, int area2num)
 	if (foundreach)
 	{
 		//create a new reachability link
-		lreach = AAS_AllocReachability();
+		lreach = AAS_AllocPairReachability(job);
 		if (!lreach) return qfalse;
 		lreach->areanum = lr.areanum;
 		lreach->facenum = lr.facenum;
@@ -1032,8 +1149,7 @@ int AAS_Reachability_EqualFloorHeight(int area1num, int area2num)
 		VectorCopy(lr.end, lreach->end);
 		lreach->traveltype = lr.traveltype;
 		lreach->traveltime = lr.traveltime;
-		lreach->next = areareachability[area1num];
-		areareachability[area1num] = lreach;
+		AAS_LinkPairReachability(job, area1num, lreach);
 		//if going into a crouch area
 		if (!AAS_AreaCrouch(area1num) && AAS_AreaCrouch(area2num))
 		{
@@ -1049,7 +1165,7 @@ int AAS_Reachability_EqualFloorHeight(int area1num, int area2num)
 		//avoid rather small areas
 		//if (AAS_AreaGroundFaceArea(lreach->areanum) < 500) lreach->traveltime += 100;
 		//
-		reach_equalfloor++;
+		AAS_CountPairReachability(job, lreach, &reach_equalfloor);
 		return qtrue;
 	} //end if
 	return qfalse;
@@ -1061,7 +1177,7 @@ int AAS_Reachability_EqualFloorHeight(int area1num, int area2num)
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2num)
+int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(aas_reachabilityjob_t *job, int area1num, int area2num)
 {
 	int i, j, k, l, edge1num, edge2num, areas[10], numareas;
 	int ground_bestarea2groundedgenum, ground_foundreach;
@@ -1366,7 +1482,7 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 		if (ground_bestdist >= 0 && ground_bestdist < aassettings.phys_maxstep)
 		{
 			//create walk reachability from area1 to area2
-			lreach = AAS_AllocReachability();
+			lreach = AAS_AllocPairReachability(job);
 			if (!lreach) return qfalse;
 			lreach->areanum = area2num;
 			lreach->facenum = 0;
@@ -1380,8 +1496,7 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 			{
 				lreach->traveltime += aassettings.rs_startcrouch;
 			} //end if
-			lreach->next = areareachability[area1num];
-			areareachability[area1num] = lreach;
+			AAS_LinkPairReachability(job, area1num, lreach);
 			//NOTE: if there's nearby solid or a gap area after this area
 			/*
 			if (!AAS_NearbySolidOrGap(lreach->start, lreach->end))
@@ -1392,7 +1507,7 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 			//avoid rather small areas
 			//if (AAS_AreaGroundFaceArea(lreach->areanum) < 500) lreach->traveltime += 100;
 			//
-			reach_step++;
+			AAS_CountPairReachability(job, lreach, &reach_step);
 			return qtrue;
 		} //end if
 	} //end if
@@ -1433,7 +1548,7 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 						(aasworld.areasettings[area2num].presencetype & PRESENCE_NORMAL))
 				{
 					//create water jump reachability from area1 to area2
-					lreach = AAS_AllocReachability();
+					lreach = AAS_AllocPairReachability(job);
 					if (!lreach) return qfalse;
 					lreach->areanum = area2num;
 					lreach->facenum = 0;
@@ -1442,10 +1557,9 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 					VectorMA(water_bestend, INSIDEUNITS_WATERJUMP, water_bestnormal, lreach->end);
 					lreach->traveltype = TRAVEL_WATERJUMP;
 					lreach->traveltime = aassettings.rs_waterjump;
-					lreach->next = areareachability[area1num];
-					areareachability[area1num] = lreach;
+					AAS_LinkPairReachability(job, area1num, lreach);
 					//we've got another waterjump reachability
-					reach_waterjump++;
+					AAS_CountPairReachability(job, lreach, &reach_waterjump);
 					return qtrue;
 				} //end if
 			} //end if
@@ -1481,7 +1595,7 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 				if (!AAS_AreaCrouch(area1num) && !AAS_AreaCrouch(area2num))
 				{
 					//create barrier jump reachability from area1 to area2
-					lreach = AAS_AllocReachability();
+					lreach = AAS_AllocPairReachability(job);
 					if (!lreach) return qfalse;
 					lreach->areanum = area2num;
 					lreach->facenum = 0;
@@ -1490,10 +1604,9 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 					VectorMA(ground_bestend, INSIDEUNITS_WALKEND, ground_bestnormal, lreach->end);
 					lreach->traveltype = TRAVEL_BARRIERJUMP;
 					lreach->traveltime = aassettings.rs_barrierjump;//AAS_BarrierJumpTravelTime();
-					lreach->next = areareachability[area1num];
-					areareachability[area1num] = lreach;
+					AAS_LinkPairReachability(job, area1num, lreach);
 					//we've got another barrierjump reachability
-					reach_barrier++;
+					AAS_CountPairReachability(job, lreach, &reach_barrier);
 					return qtrue;
 				} //end if
 			} //end if
@@ -1528,7 +1641,7 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 			if (ground_bestdist > -aassettings.phys_maxstep)
 			{
 				//create walk reachability from area1 to area2
-				lreach = AAS_AllocReachability();
+				lreach = AAS_AllocPairReachability(job);
 				if (!lreach) return qfalse;
 				lreach->areanum = area2num;
 				lreach->facenum = 0;
@@ -1537,10 +1650,9 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 				VectorMA(ground_bestend, INSIDEUNITS_WALKEND, ground_bestnormal, lreach->end);
 				lreach->traveltype = TRAVEL_WALK;
 				lreach->traveltime = 1;
-				lreach->next = areareachability[area1num];
-				areareachability[area1num] = lreach;
+				AAS_LinkPairReachability(job, area1num, lreach);
 				//we've got another walk reachability
-				reach_walk++;
+				AAS_CountPairReachability(job, lreach, &reach_walk);
 				return qtrue;
 			} //end if
 			// if no maximum fall height set or less than the max
@@ -1567,7 +1679,7 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 						if (i >= numareas)
 						{
 							//create a walk off ledge reachability from area1 to area2
-							lreach = AAS_AllocReachability();
+							lreach = AAS_AllocPairReachability(job);
 							if (!lreach) return qfalse;
 							lreach->areanum = area2num;
 							lreach->facenum = 0;
@@ -1588,10 +1700,9 @@ int AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(int area1num, int area2
 									lreach->traveltime += aassettings.rs_falldamage10;
 								} //end if
 							} //end if
-							lreach->next = areareachability[area1num];
-							areareachability[area1num] = lreach;
+							AAS_LinkPairReachability(job, area1num, lreach);
 							//
-							reach_walkoffledge++;
+							AAS_CountPairReachability(job, lreach, &reach_walkoffledge);
 							//NOTE: don't create a weapon (rl, bfg) jump reachability here
 							//because it interferes with other reachabilities
 							//like the ladder reachability
@@ -2110,7 +2221,7 @@ float AAS_ClosestEdgePoints(vec3_t v1, vec3_t v2, vec3_t v3, vec3_t v4,
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-int AAS_Reachability_Jump(int area1num, int area2num)
+int AAS_Reachability_Jump(aas_reachabilityjob_t *job, int area1num, int area2num)
 {
 	int i, j, k, l, face1num, face2num, edge1num, edge2num, traveltype;
 	int stopevent, areas[10], numareas;
@@ -2332,7 +2443,7 @@ int AAS_Reachability_Jump(int area1num, int area2num)
 		Log_Write("jump reachability between %d and %d\r\n", area1num, area2num);
 #endif //REACH_DEBUG
 		//create a new reachability link
-		lreach = AAS_AllocReachability();
+		lreach = AAS_AllocPairReachability(job);
 		if (!lreach) return qfalse;
 		lreach->areanum = area2num;
 		lreach->facenum = 0;
@@ -2364,13 +2475,12 @@ int AAS_Reachability_Jump(int area1num, int area2num)
 				lreach->traveltime += aassettings.rs_falldamage10;
 			} //end if
 		} //end if
-		lreach->next = areareachability[area1num];
-		areareachability[area1num] = lreach;
+		AAS_LinkPairReachability(job, area1num, lreach);
 		//
 		if ((traveltype & TRAVELTYPE_MASK) == TRAVEL_JUMP)
-			reach_jump++;
+			AAS_CountPairReachability(job, lreach, &reach_jump);
 		else
-			reach_walkoffledge++;
+			AAS_CountPairReachability(job, lreach, &reach_walkoffledge);
 	} //end if
 	return qfalse;
 } //end of the function AAS_Reachability_Jump
@@ -2381,7 +2491,7 @@ int AAS_Reachability_Jump(int area1num, int area2num)
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-int AAS_Reachability_Ladder(int area1num, int area2num)
+int AAS_Reachability_Ladder(aas_reachabilityjob_t *job, int area1num, int area2num)
 {
 	int i, j, k, l, edge1num, edge2num, sharededgenum = 0, lowestedgenum = 0;
 	int face1num, face2num, ladderface1num = 0, ladderface2num = 0;
@@ -2485,7 +2595,7 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 					&& abs(DotProduct(sharededgevec, up)) < 0.7)
 		{
 			//create a new reachability link
-			lreach = AAS_AllocReachability();
+			lreach = AAS_AllocPairReachability(job);
 			if (!lreach) return qfalse;
 			lreach->areanum = area2num;
 			lreach->facenum = ladderface1num;
@@ -2495,12 +2605,11 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 			VectorMA(area2point, -3, plane1->normal, lreach->end);
 			lreach->traveltype = TRAVEL_LADDER;
 			lreach->traveltime = 10;
-			lreach->next = areareachability[area1num];
-			areareachability[area1num] = lreach;
+			AAS_LinkPairReachability(job, area1num, lreach);
 			//
-			reach_ladder++;
+			AAS_CountPairReachability(job, lreach, &reach_ladder);
 			//create a new reachability link
-			lreach = AAS_AllocReachability();
+			lreach = AAS_AllocPairReachability(job);
 			if (!lreach) return qfalse;
 			lreach->areanum = area1num;
 			lreach->facenum = ladderface2num;
@@ -2510,10 +2619,9 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 			VectorMA(area1point, -3, plane1->normal, lreach->end);
 			lreach->traveltype = TRAVEL_LADDER;
 			lreach->traveltime = 10;
-			lreach->next = areareachability[area2num];
-			areareachability[area2num] = lreach;
+			AAS_LinkPairReachability(job, area2num, lreach);
 			//
-			reach_ladder++;
+			AAS_CountPairReachability(job, lreach, &reach_ladder);
 			//
 			return qtrue;
 		} //end if
@@ -2523,7 +2631,7 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 		if (ladderface1vertical && (ladderface2->faceflags & FACE_GROUND))
 		{
 			//create a new reachability link
-			lreach = AAS_AllocReachability();
+			lreach = AAS_AllocPairReachability(job);
 			if (!lreach) return qfalse;
 			lreach->areanum = area2num;
 			lreach->facenum = ladderface1num;
@@ -2534,12 +2642,11 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 			VectorMA(lreach->end, -15, plane1->normal, lreach->end);
 			lreach->traveltype = TRAVEL_LADDER;
 			lreach->traveltime = 10;
-			lreach->next = areareachability[area1num];
-			areareachability[area1num] = lreach;
+			AAS_LinkPairReachability(job, area1num, lreach);
 			//
-			reach_ladder++;
+			AAS_CountPairReachability(job, lreach, &reach_ladder);
 			//create a new reachability link
-			lreach = AAS_AllocReachability();
+			lreach = AAS_AllocPairReachability(job);
 			if (!lreach) return qfalse;
 			lreach->areanum = area1num;
 			lreach->facenum = ladderface2num;
@@ -2548,10 +2655,9 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 			VectorCopy(area1point, lreach->end);
 			lreach->traveltype = TRAVEL_WALKOFFLEDGE;
 			lreach->traveltime = 10;
-			lreach->next = areareachability[area2num];
-			areareachability[area2num] = lreach;
+			AAS_LinkPairReachability(job, area2num, lreach);
 			//
-			reach_walkoffledge++;
+			AAS_CountPairReachability(job, lreach, &reach_walkoffledge);
 			//
 			return qtrue;
 		} //end if
@@ -2619,8 +2725,11 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 				//if the height is jumpable
 				if (start[2] - trace.endpos[2] < maxjumpheight)
 				{
+					//reachabilities created for the same block of areas
+					//aren't visible to a job so the merge checks again
+					if (job) job->checkareanum = area2num;
 					//create a new reachability link
-					lreach = AAS_AllocReachability();
+					lreach = AAS_AllocPairReachability(job);
 					if (!lreach) return qfalse;
 					lreach->areanum = area2num;
 					lreach->facenum = ladderface1num;
@@ -2629,12 +2738,11 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 					VectorCopy(trace.endpos, lreach->end);
 					lreach->traveltype = TRAVEL_LADDER;
 					lreach->traveltime = 10;
-					lreach->next = areareachability[area1num];
-					areareachability[area1num] = lreach;
+					AAS_LinkPairReachability(job, area1num, lreach);
 					//
-					reach_ladder++;
+					AAS_CountPairReachability(job, lreach, &reach_ladder);
 					//create a new reachability link
-					lreach = AAS_AllocReachability();
+					lreach = AAS_AllocPairReachability(job);
 					if (!lreach) return qfalse;
 					lreach->areanum = area1num;
 					lreach->facenum = ladderface1num;
@@ -2646,10 +2754,9 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 					lreach->end[2] += 10;
 					lreach->traveltype = TRAVEL_JUMP;
 					lreach->traveltime = 10;
-					lreach->next = areareachability[area2num];
-					areareachability[area2num] = lreach;
+					AAS_LinkPairReachability(job, area2num, lreach);
 					//
-					reach_jump++;	
+					AAS_CountPairReachability(job, lreach, &reach_jump);
 					//
 					return qtrue;
 #ifdef REACH_DEBUG
@@ -2685,7 +2792,7 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 												| AREACONTENTS_LAVA)) continue;
 					//
 					//create a new reachability link
-					lreach = AAS_AllocReachability();
+					lreach = AAS_AllocPairReachability(job);
 					if (!lreach) return qfalse;
 					lreach->areanum = area1num;
 					lreach->facenum = ladderface1num;
@@ -2695,10 +2802,9 @@ int AAS_Reachability_Ladder(int area1num, int area2num)
 					lreach->end[2] += 5;
 					lreach->traveltype = TRAVEL_JUMP;
 					lreach->traveltime = 10;
-					lreach->next = areareachability[area2num];
-					areareachability[area2num] = lreach;
+					AAS_LinkPairReachability(job, area2num, lreach);
 					//
-					reach_jump++;
+					AAS_CountPairReachability(job, lreach, &reach_jump);
 					//
 					Log_Write("jump far to ladder reach between %d and %d\r\n", area2num, area1num);
 					//
@@ -4340,6 +4446,337 @@ void AAS_StoreReachability(void)
 	} //end for
 } //end of the function AAS_StoreReachability
 //===========================================================================
+// checks for walk, swim, step, barrier, ladder and jump reachabilities from
+// the area to all other areas
+//
+// Parameter:				job			: reachability job or NULL
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_AreaPairReachabilities(aas_reachabilityjob_t *job, int i)
+{
+	int j;
+
+	//loop over the areas
+	for (j = 1; j < aasworld.numareas; j++)
+	{
+		if (i == j) continue;
+		//never create reachabilities from teleporter or jumppad areas to regular areas
+		if (aasworld.areasettings[i].contents & (AREACONTENTS_TELEPORTER|AREACONTENTS_JUMPPAD))
+		{
+			if (!(aasworld.areasettings[j].contents & (AREACONTENTS_TELEPORTER|AREACONTENTS_JUMPPAD)))
+			{
+				continue;
+			} //end if
+		} //end if
+		//if there already is a reachability link from area i to j
+		if (AAS_ReachabilityExists(i, j)) continue;
+		//
+		if (job)
+		{
+			job->area1num = i;
+			job->area2num = j;
+			job->checkareanum = 0;
+		} //end if
+		//check for a swim reachability
+		if (AAS_Reachability_Swim(job, i, j)) continue;
+		//check for a simple walk on equal floor height reachability
+		if (AAS_Reachability_EqualFloorHeight(job, i, j)) continue;
+		//check for step, barrier, waterjump and walk off ledge reachabilities
+		if (AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(job, i, j)) continue;
+		//check for ladder reachabilities
+		if (AAS_Reachability_Ladder(job, i, j)) continue;
+		//check for a jump reachability
+		if (AAS_Reachability_Jump(job, i, j)) continue;
+	} //end for
+} //end of the function AAS_AreaPairReachabilities
+//===========================================================================
+// checks for grapple hook and weapon jump reachabilities from the area to
+// all other areas, these use engine traces so they never run on a job
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_AreaWeaponReachabilities(int i)
+{
+	int j;
+
+	//never create these reachabilities from teleporter or jumppad areas
+	if (aasworld.areasettings[i].contents & (AREACONTENTS_TELEPORTER|AREACONTENTS_JUMPPAD))
+	{
+		return;
+	} //end if
+	//loop over the areas
+	for (j = 1; j < aasworld.numareas; j++)
+	{
+		if (i == j) continue;
+		//
+		if (AAS_ReachabilityExists(i, j)) continue;
+		//check for a grapple hook reachability
+		if (calcgrapplereach) AAS_Reachability_Grapple(i, j);
+		//check for a weapon jump reachability
+		AAS_Reachability_WeaponJump(i, j);
+	} //end for
+} //end of the function AAS_AreaWeaponReachabilities
+//===========================================================================
+// calculates the reachabilities from the areas of a reachability job,
+// runs on a job thread
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_ReachabilityJob(void *data)
+{
+	int i;
+	aas_reachabilityjob_t *job;
+
+	job = (aas_reachabilityjob_t *) data;
+	for (i = job->firstarea; i < job->lastarea; i++)
+	{
+		//only create jumppad reachabilities from jumppad areas
+		if (aasworld.areasettings[i].contents & AREACONTENTS_JUMPPAD)
+		{
+			continue;
+		} //end if
+		AAS_AreaPairReachabilities(job, i);
+	} //end for
+} //end of the function AAS_ReachabilityJob
+//===========================================================================
+// stores the reachabilities the jobs created for the area in the same order
+// the serial calculation would, the checks that depend on the existing
+// reachabilities are done again so the result is the same as the serial
+// calculation
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_MergeAreaReachabilities(aas_reachabilitychunk_t **chunk, int *index, int areanum)
+{
+	int area2num, checkareanum, keep, jump;
+	aas_jobreachability_t *jobreach;
+	aas_lreachability_t *lreach;
+
+	while (*chunk)
+	{
+		if (*index >= (*chunk)->numreachabilities)
+		{
+			*chunk = (*chunk)->next;
+			*index = 0;
+			continue;
+		} //end if
+		jobreach = &(*chunk)->reachabilities[*index];
+		if (jobreach->area1num != areanum) break;
+		//the reachabilities of an area pair are only kept if the serial
+		//calculation would have checked the pair
+		area2num = jobreach->area2num;
+		keep = !AAS_ReachabilityExists(areanum, area2num);
+		//the ladder only jumps up to the ladder from an area found with a
+		//trace if there are no reachabilities between the areas yet, the
+		//serial calculation continues with the jump check otherwise
+		jump = qfalse;
+		checkareanum = jobreach->checkareanum;
+		if (keep && checkareanum)
+		{
+			if (AAS_ReachabilityExists(areanum, checkareanum) ||
+					AAS_ReachabilityExists(checkareanum, areanum))
+			{
+				keep = qfalse;
+				jump = qtrue;
+			} //end if
+		} //end if
+		while (*chunk)
+		{
+			if (*index >= (*chunk)->numreachabilities)
+			{
+				*chunk = (*chunk)->next;
+				*index = 0;
+				continue;
+			} //end if
+			jobreach = &(*chunk)->reachabilities[*index];
+			if (jobreach->area1num != areanum || jobreach->area2num != area2num) break;
+			(*index)++;
+			if (!keep) continue;
+			lreach = AAS_AllocReachability();
+			if (!lreach) return;
+			*lreach = jobreach->reach;
+			lreach->next = areareachability[jobreach->areanum];
+			areareachability[jobreach->areanum] = lreach;
+			if (jobreach->counter) (*jobreach->counter)++;
+		} //end while
+		if (jump) AAS_Reachability_Jump(NULL, areanum, area2num);
+	} //end while
+} //end of the function AAS_MergeAreaReachabilities
+//===========================================================================
+// compares two lists of reachabilities of an area up to the reachability
+// that was first before they were created, returns the first reachability
+// that differs or NULL if the lists are the same
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static aas_lreachability_t *AAS_FirstDifferentReachability(aas_lreachability_t *lreach,
+											aas_lreachability_t *lreach2, aas_lreachability_t *first)
+{
+	for (; lreach != first && lreach2 != first; lreach = lreach->next, lreach2 = lreach2->next)
+	{
+		if (lreach->areanum != lreach2->areanum ||
+				lreach->facenum != lreach2->facenum ||
+				lreach->edgenum != lreach2->edgenum ||
+				!VectorCompare(lreach->start, lreach2->start) ||
+				!VectorCompare(lreach->end, lreach2->end) ||
+				lreach->traveltype != lreach2->traveltype ||
+				lreach->traveltime != lreach2->traveltime)
+		{
+			return lreach;
+		} //end if
+	} //end for
+	if (lreach != first) return lreach;
+	if (lreach2 != first) return lreach2;
+	return NULL;
+} //end of the function AAS_FirstDifferentReachability
+//===========================================================================
+// calculates the reachabilities for the block of areas again without the
+// jobs and prints the areas the reachabilities differ for, the serial
+// reachabilities replace the ones the jobs calculated
+//
+// Parameter:				previous	: reachabilities before the block
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_CheckReachabilityJobs(aas_lreachability_t **previous, int firstarea, int lastarea)
+{
+	int i, numdiffs, counters[MAX_REACHABILITYCOUNTERS];
+	aas_lreachability_t **threaded, *lreach, *nextlreach;
+
+	threaded = (aas_lreachability_t **) GetMemory(aasworld.numareas * sizeof(aas_lreachability_t *));
+	Com_Memcpy(threaded, areareachability, aasworld.numareas * sizeof(aas_lreachability_t *));
+	Com_Memcpy(areareachability, previous, aasworld.numareas * sizeof(aas_lreachability_t *));
+	//the merge already counted the reachabilities of the block
+	for (i = 0; i < MAX_REACHABILITYCOUNTERS; i++)
+	{
+		counters[i] = *reachcounters[i];
+	} //end for
+	for (i = firstarea; i < lastarea; i++)
+	{
+		//only create jumppad reachabilities from jumppad areas
+		if (aasworld.areasettings[i].contents & AREACONTENTS_JUMPPAD)
+		{
+			continue;
+		} //end if
+		AAS_AreaPairReachabilities(NULL, i);
+		AAS_AreaWeaponReachabilities(i);
+	} //end for
+	for (i = 0; i < MAX_REACHABILITYCOUNTERS; i++)
+	{
+		*reachcounters[i] = counters[i];
+	} //end for
+	//compare the reachabilities and free the ones of the jobs
+	numdiffs = 0;
+	for (i = 1; i < aasworld.numareas; i++)
+	{
+		lreach = AAS_FirstDifferentReachability(threaded[i], areareachability[i], previous[i]);
+		if (lreach)
+		{
+			botimport.Print(PRT_WARNING, "area %d: threaded reachability to area %d differs from the serial one\n",
+								i, lreach->areanum);
+			numdiffs++;
+		} //end if
+		for (lreach = threaded[i]; lreach != previous[i]; lreach = nextlreach)
+		{
+			nextlreach = lreach->next;
+			AAS_FreeReachability(lreach);
+		} //end for
+	} //end for
+	FreeMemory(threaded);
+	if (numdiffs)
+	{
+		botimport.Print(PRT_WARNING, "reachabilities of areas %d to %d: %d areas differ\n", firstarea, lastarea - 1, numdiffs);
+	} //end if
+	else
+	{
+		botimport.Print(PRT_MESSAGE, "reachabilities of areas %d to %d: threaded and serial are the same\n", firstarea, lastarea - 1);
+	} //end else
+} //end of the function AAS_CheckReachabilityJobs
+//===========================================================================
+// calculates the reachabilities for the next block of areas on the job
+// threads and merges them in area order, the result is the same as the
+// serial calculation
+//
+// Parameter:				numjobs		: maximum number of jobs
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_ContinueInitReachabilityJobs(int numjobs)
+{
+	int i, j, firstarea, lastarea, counter, index;
+	aas_reachabilityjob_t jobs[MAX_REACHABILITYJOBS];
+	aas_reachabilitychunk_t *chunk, *nextchunk;
+	aas_lreachability_t **previous;
+
+	if (numjobs > botimport.NumJobThreads() + 1) numjobs = botimport.NumJobThreads() + 1;
+	if (numjobs > MAX_REACHABILITYJOBS) numjobs = MAX_REACHABILITYJOBS;
+	//the next block of areas, large enough to keep all jobs busy
+	firstarea = aasworld.numreachabilityareas;
+	lastarea = firstarea + aasworld.numareas / 50 + numjobs * 8;
+	if (lastarea > aasworld.numareas) lastarea = aasworld.numareas;
+	//
+	reachabilityjoblock = botimport.CreateMutex();
+	AAS_SetPointContentsLock(reachabilityjoblock);
+	Com_Memset(jobs, 0, sizeof(jobs));
+	counter = 0;
+	for (i = 0; i < numjobs; i++)
+	{
+		jobs[i].firstarea = firstarea + i * (lastarea - firstarea) / numjobs;
+		jobs[i].lastarea = firstarea + (i + 1) * (lastarea - firstarea) / numjobs;
+		if (i) botimport.AddJob(AAS_ReachabilityJob, &jobs[i], &counter);
+	} //end for
+	AAS_ReachabilityJob(&jobs[0]);
+	botimport.WaitJobs(&counter);
+	AAS_SetPointContentsLock(NULL);
+	botimport.DestroyMutex(reachabilityjoblock);
+	reachabilityjoblock = NULL;
+	//remember the reachabilities before the block to compare the threaded
+	//reachabilities with the serial ones
+	previous = NULL;
+	if (LibVarValue("reachabilitycheck", "0"))
+	{
+		previous = (aas_lreachability_t **) GetMemory(aasworld.numareas * sizeof(aas_lreachability_t *));
+		Com_Memcpy(previous, areareachability, aasworld.numareas * sizeof(aas_lreachability_t *));
+	} //end if
+	//merge the reachabilities in area order
+	for (i = 0; i < numjobs; i++)
+	{
+		chunk = jobs[i].firstchunk;
+		index = 0;
+		for (j = jobs[i].firstarea; j < jobs[i].lastarea; j++)
+		{
+			AAS_MergeAreaReachabilities(&chunk, &index, j);
+			//only create jumppad reachabilities from jumppad areas
+			if (aasworld.areasettings[j].contents & AREACONTENTS_JUMPPAD)
+			{
+				continue;
+			} //end if
+			AAS_AreaWeaponReachabilities(j);
+		} //end for
+		for (chunk = jobs[i].firstchunk; chunk; chunk = nextchunk)
+		{
+			nextchunk = chunk->next;
+			FreeMemory(chunk);
+		} //end for
+	} //end for
+	//
+	if (previous)
+	{
+		AAS_CheckReachabilityJobs(previous, firstarea, lastarea);
+		FreeMemory(previous);
+	} //end if
+	aasworld.numreachabilityareas = lastarea;
+} //end of the function AAS_ContinueInitReachabilityJobs
+//===========================================================================
 //
 // TRAVEL_WALK					100%	equal floor height + steps
 // TRAVEL_CROUCH				100%
@@ -4366,7 +4803,7 @@ void AAS_StoreReachability(void)
 //===========================================================================
 int AAS_ContinueInitReachability(float time)
 {
-	int i, j, todo, start_time;
+	int i, todo, start_time, numjobs;
 	static float framereachability, reachability_delay;
 	static int lastpercentage;
 
@@ -4384,8 +4821,14 @@ int AAS_ContinueInitReachability(float time)
 	//number of areas to calculate reachability for this cycle
 	todo = aasworld.numreachabilityareas + (int) framereachability;
 	start_time = Sys_MilliSeconds();
+	//calculate the reachabilities on the job threads
+	numjobs = (int) LibVarValue("reachabilitythreads", "0");
+	if (numjobs > 0 && aasworld.numreachabilityareas < aasworld.numareas)
+	{
+		AAS_ContinueInitReachabilityJobs(numjobs);
+	} //end if
 	//loop over the areas
-	for (i = aasworld.numreachabilityareas; i < aasworld.numareas && i < todo; i++)
+	else for (i = aasworld.numreachabilityareas; i < aasworld.numareas && i < todo; i++)
 	{
 		aasworld.numreachabilityareas++;
 		//only create jumppad reachabilities from jumppad areas
@@ -4393,47 +4836,8 @@ int AAS_ContinueInitReachability(float time)
 		{
 			continue;
 		} //end if
-		//loop over the areas
-		for (j = 1; j < aasworld.numareas; j++)
-		{
-			if (i == j) continue;
-			//never create reachabilities from teleporter or jumppad areas to regular areas
-			if (aasworld.areasettings[i].contents & (AREACONTENTS_TELEPORTER|AREACONTENTS_JUMPPAD))
-			{
-				if (!(aasworld.areasettings[j].contents & (AREACONTENTS_TELEPORTER|AREACONTENTS_JUMPPAD)))
-				{
-					continue;
-				} //end if
-			} //end if
-			//if there already is a reachability link from area i to j
-			if (AAS_ReachabilityExists(i, j)) continue;
-			//check for a swim reachability
-			if (AAS_Reachability_Swim(i, j)) continue;
-			//check for a simple walk on equal floor height reachability
-			if (AAS_Reachability_EqualFloorHeight(i, j)) continue;
-			//check for step, barrier, waterjump and walk off ledge reachabilities
-			if (AAS_Reachability_Step_Barrier_WaterJump_WalkOffLedge(i, j)) continue;
-			//check for ladder reachabilities
-			if (AAS_Reachability_Ladder(i, j)) continue;
-			//check for a jump reachability
-			if (AAS_Reachability_Jump(i, j)) continue;
-		} //end for
-		//never create these reachabilities from teleporter or jumppad areas
-		if (aasworld.areasettings[i].contents & (AREACONTENTS_TELEPORTER|AREACONTENTS_JUMPPAD))
-		{
-			continue;
-		} //end if
-		//loop over the areas
-		for (j = 1; j < aasworld.numareas; j++)
-		{
-			if (i == j) continue;
-			//
-			if (AAS_ReachabilityExists(i, j)) continue;
-			//check for a grapple hook reachability
-			if (calcgrapplereach) AAS_Reachability_Grapple(i, j);
-			//check for a weapon jump reachability
-			AAS_Reachability_WeaponJump(i, j);
-		} //end for
+		AAS_AreaPairReachabilities(NULL, i);
+		AAS_AreaWeaponReachabilities(i);
 		//if the calculation took more time than the max reachability delay
 		if (Sys_MilliSeconds() - start_time > (int) reachability_delay) break;
 		//
@@ -66,6 +66,20 @@ Suite 120, Rockville, Maryland 20850 USA.
 //maximum number of routing updates each frame
 #define MAX_FRAMEROUTINGUPDATES		10
 
+//route queries run by one routing job
+typedef struct aas_routingjob_s
+{
+	aas_routequery_t *queries;			//routes to look up
+	int numqueries;						//number of routes
+} aas_routingjob_t;
+
+//areas a route cache precomputation job creates the routing caches for
+typedef struct aas_precomputejob_s
+{
+	int firstarea;						//first area of the job
+	int areastep;						//step to the next area of the job
+} aas_precomputejob_t;
+
 
 /*
 
@@ -84,28 +98,138 @@ Suite 120, Rockville, Maryland 20850 USA.
 
 */
 
-#ifdef ROUTING_DEBUG
-int numareacacheupdates;
-int numportalcacheupdates;
-#endif //ROUTING_DEBUG
-
+//total size of the routing cache and the budget for it, protected by the
+//routing memory lock
 int routingcachesize;
 int max_routingcachesize;
 
+//===========================================================================
+// returns shard number i, the cluster shards come first and then the portal
+// cache shards
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE aas_routingshard_t *AAS_RoutingShard(int i)
+{
+	if (i < aasworld.numclusters) return &aasworld.clustershards[i];
+	return &aasworld.portalshards[i - aasworld.numclusters];
+} //end of the function AAS_RoutingShard
+//===========================================================================
+// returns the shard holding the portal caches of the given goal area
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE aas_routingshard_t *AAS_PortalCacheShard(int areanum)
+{
+	return &aasworld.portalshards[areanum & (NUM_PORTALCACHESHARDS - 1)];
+} //end of the function AAS_PortalCacheShard
+//===========================================================================
+// returns the shard the given routing cache is in
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE aas_routingshard_t *AAS_CacheShard(aas_routingcache_t *cache)
+{
+	if (cache->type == CACHETYPE_AREA) return &aasworld.clustershards[cache->cluster];
+	return AAS_PortalCacheShard(cache->areanum);
+} //end of the function AAS_CacheShard
+//===========================================================================
+// shard locks are only created when there are job threads
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE void AAS_LockShard(aas_routingshard_t *shard)
+{
+	if (shard->lock) botimport.LockMutex(shard->lock);
+} //end of the function AAS_LockShard
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE void AAS_UnlockShard(aas_routingshard_t *shard)
+{
+	if (shard->lock) botimport.UnlockMutex(shard->lock);
+} //end of the function AAS_UnlockShard
+//===========================================================================
+// releases a cache returned by AAS_GetAreaRoutingCache or
+// AAS_GetPortalRoutingCache
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE void AAS_ReleaseRoutingCache(aas_routingcache_t *cache)
+{
+	AAS_UnlockShard(AAS_CacheShard(cache));
+} //end of the function AAS_ReleaseRoutingCache
+//===========================================================================
+// the routing memory lock protects routing cache allocation and
+// routingcachesize, it is taken last when other locks are held
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE void AAS_LockRoutingMemory(void)
+{
+	if (aasworld.routingmemorylock) botimport.LockMutex(aasworld.routingmemorylock);
+} //end of the function AAS_LockRoutingMemory
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE void AAS_UnlockRoutingMemory(void)
+{
+	if (aasworld.routingmemorylock) botimport.UnlockMutex(aasworld.routingmemorylock);
+} //end of the function AAS_UnlockRoutingMemory
 //===========================================================================
 //
 // Parameter:			-
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-#ifdef ROUTING_DEBUG
 void AAS_RoutingInfo(void)
 {
-	botimport.Print(PRT_MESSAGE, "%d area cache updates\n", numareacacheupdates);
-	botimport.Print(PRT_MESSAGE, "%d portal cache updates\n", numportalcacheupdates);
-	botimport.Print(PRT_MESSAGE, "%d bytes routing cache\n", routingcachesize);
+	int i, hits[2], misses[2], evictions[2];
+	aas_routingshard_t *shard;
+
+	if (!aasworld.clustershards) return;
+	//
+	hits[0] = hits[1] = misses[0] = misses[1] = evictions[0] = evictions[1] = 0;
+	for (i = 0; i < aasworld.numclusters + NUM_PORTALCACHESHARDS; i++)
+	{
+		shard = AAS_RoutingShard(i);
+		AAS_LockShard(shard);
+		hits[i >= aasworld.numclusters] += shard->hits;
+		misses[i >= aasworld.numclusters] += shard->misses;
+		evictions[i >= aasworld.numclusters] += shard->evictions;
+		AAS_UnlockShard(shard);
+	} //end for
+	botimport.Print(PRT_MESSAGE, "area cache: %d hits, %d updates, %d evictions\n", hits[0], misses[0], evictions[0]);
+	botimport.Print(PRT_MESSAGE, "portal cache: %d hits, %d updates, %d evictions\n", hits[1], misses[1], evictions[1]);
+	AAS_LockRoutingMemory();
+	botimport.Print(PRT_MESSAGE, "%d of %d bytes routing cache\n", routingcachesize, max_routingcachesize);
+	AAS_UnlockRoutingMemory();
+	botimport.Print(PRT_MESSAGE, "%d precomputed routing caches in %d bytes, default travel flags only\n",
+						aasworld.numprecomputedcaches, aasworld.precomputedcachesize);
+	if (aasworld.numchangedareas)
+	{
+		botimport.Print(PRT_MESSAGE, "%d areas changed since the precomputed caches were read\n",
+						aasworld.numchangedareas);
+	} //end if
 } //end of the function AAS_RoutingInfo
-#endif //ROUTING_DEBUG
 //===========================================================================
 // returns the number of the area in the cluster
 // assumes the given area is in the given cluster or a portal of the cluster
@@ -204,12 +328,12 @@ int AAS_TravelFlagForType(int traveltype)
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-void AAS_UnlinkCache(aas_routingcache_t *cache)
+static void AAS_UnlinkCache(aas_routingshard_t *shard, aas_routingcache_t *cache)
 {
 	if (cache->time_next) cache->time_next->time_prev = cache->time_prev;
-	else aasworld.newestcache = cache->time_prev;
+	else shard->newestcache = cache->time_prev;
 	if (cache->time_prev) cache->time_prev->time_next = cache->time_next;
-	else aasworld.oldestcache = cache->time_next;
+	else shard->oldestcache = cache->time_next;
 	cache->time_next = NULL;
 	cache->time_prev = NULL;
 } //end of the function AAS_UnlinkCache
@@ -219,20 +343,20 @@ void AAS_UnlinkCache(aas_routingcache_t *cache)
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-void AAS_LinkCache(aas_routingcache_t *cache)
+static void AAS_LinkCache(aas_routingshard_t *shard, aas_routingcache_t *cache)
 {
-	if (aasworld.newestcache)
+	if (shard->newestcache)
 	{
-		aasworld.newestcache->time_next = cache;
-		cache->time_prev = aasworld.newestcache;
+		shard->newestcache->time_next = cache;
+		cache->time_prev = shard->newestcache;
 	} //end if
 	else
 	{
-		aasworld.oldestcache = cache;
+		shard->oldestcache = cache;
 		cache->time_prev = NULL;
 	} //end else
 	cache->time_next = NULL;
-	aasworld.newestcache = cache;
+	shard->newestcache = cache;
 } //end of the function AAS_LinkCache
 //===========================================================================
 //
@@ -242,11 +366,91 @@ void AAS_LinkCache(aas_routingcache_t *cache)
 //===========================================================================
 void AAS_FreeRoutingCache(aas_routingcache_t *cache)
 {
-	AAS_UnlinkCache(cache);
+	//the precomputed caches are in the route cache file memory
+	if (cache->precomputed) return;
+	AAS_UnlinkCache(AAS_CacheShard(cache), cache);
+	AAS_LockRoutingMemory();
 	routingcachesize -= cache->size;
 	FreeMemory(cache);
+	AAS_UnlockRoutingMemory();
 } //end of the function AAS_FreeRoutingCache
 //===========================================================================
+// the precomputed caches hold the travel times with the areas enabled and
+// disabled as they were when the route cache file was read, keeps count of
+// the areas that changed since in every cluster
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_ChangePrecomputedArea(int areanum)
+{
+	int clusternum, change;
+	aas_portal_t *portal;
+
+	if (!aasworld.changedareas) return;
+	//
+	aasworld.changedareas[areanum] ^= 1;
+	change = aasworld.changedareas[areanum] ? 1 : -1;
+	aasworld.numchangedareas += change;
+	clusternum = aasworld.areasettings[areanum].cluster;
+	if (clusternum > 0)
+	{
+		aasworld.clusterchangedareas[clusternum] += change;
+	} //end if
+	else if (clusternum < 0)
+	{
+		portal = &aasworld.portals[-clusternum];
+		aasworld.clusterchangedareas[portal->frontcluster] += change;
+		aasworld.clusterchangedareas[portal->backcluster] += change;
+	} //end else if
+} //end of the function AAS_ChangePrecomputedArea
+//===========================================================================
+// returns true if the cache can be used, a precomputed area cache only
+// while no area in its cluster changed and a precomputed portal cache,
+// which can route through any cluster, only while no area changed at all
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE qboolean AAS_RoutingCacheValid(aas_routingcache_t *cache)
+{
+	if (!cache->precomputed) return qtrue;
+	if (cache->type == CACHETYPE_PORTAL) return !aasworld.numchangedareas;
+	return !aasworld.clusterchangedareas[cache->cluster];
+} //end of the function AAS_RoutingCacheValid
+//===========================================================================
+// frees the routing caches in the list, the precomputed caches stay in the
+// list so they can be used again once the areas are back as they were
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_FreeRoutingCacheList(aas_routingcache_t **list)
+{
+	aas_routingcache_t *cache, *nextcache;
+
+	cache = *list;
+	*list = NULL;
+	for (; cache; cache = nextcache)
+	{
+		nextcache = cache->next;
+		if (cache->precomputed)
+		{
+			cache->prev = NULL;
+			cache->next = *list;
+			if (*list) (*list)->prev = cache;
+			*list = cache;
+		} //end if
+		else
+		{
+			AAS_FreeRoutingCache(cache);
+		} //end else
+	} //end for
+} //end of the function AAS_FreeRoutingCacheList
+//===========================================================================
 //
 // Parameter:			-
 // Returns:				-
@@ -255,21 +459,19 @@ void AAS_FreeRoutingCache(aas_routingcache_t *cache)
 void AAS_RemoveRoutingCacheInCluster( int clusternum )
 {
 	int i;
-	aas_routingcache_t *cache, *nextcache;
 	aas_cluster_t *cluster;
+	aas_routingshard_t *shard;
 
 	if (!aasworld.clusterareacache)
 		return;
+	shard = &aasworld.clustershards[clusternum];
+	AAS_LockShard(shard);
 	cluster = &aasworld.clusters[clusternum];
 	for (i = 0; i < cluster->numareas; i++)
 	{
-		for (cache = aasworld.clusterareacache[clusternum][i]; cache; cache = nextcache)
-		{
-			nextcache = cache->next;
-			AAS_FreeRoutingCache(cache);
-		} //end for
-		aasworld.clusterareacache[clusternum][i] = NULL;
+		AAS_FreeRoutingCacheList(&aasworld.clusterareacache[clusternum][i]);
 	} //end for
+	AAS_UnlockShard(shard);
 } //end of the function AAS_RemoveRoutingCacheInCluster
 //===========================================================================
 //
@@ -280,7 +482,7 @@ void AAS_RemoveRoutingCacheInCluster( int clusternum )
 void AAS_RemoveRoutingCacheUsingArea( int areanum )
 {
 	int i, clusternum;
-	aas_routingcache_t *cache, *nextcache;
+	aas_routingshard_t *shard;
 
 	clusternum = aasworld.areasettings[areanum].cluster;
 	if (clusternum > 0)
@@ -297,13 +499,11 @@ void AAS_RemoveRoutingCacheUsingArea( int areanum )
 	// remove all portal cache
 	for (i = 0; i < aasworld.numareas; i++)
 	{
+		shard = AAS_PortalCacheShard(i);
+		AAS_LockShard(shard);
 		//refresh portal cache
-		for (cache = aasworld.portalcache[i]; cache; cache = nextcache)
-		{
-			nextcache = cache->next;
-			AAS_FreeRoutingCache(cache);
-		} //end for
-		aasworld.portalcache[i] = NULL;
+		AAS_FreeRoutingCacheList(&aasworld.portalcache[i]);
+		AAS_UnlockShard(shard);
 	} //end for
 } //end of the function AAS_RemoveRoutingCacheUsingArea
 //===========================================================================
@@ -335,6 +535,8 @@ int AAS_EnableRoutingArea(int areanum, int enable)
 	// if the status of the area changed
 	if ( (flags & AREA_DISABLED) != (aasworld.areasettings[areanum].areaflags & AREA_DISABLED) )
 	{
+		//keep track of the precomputed caches that no longer match
+		AAS_ChangePrecomputedArea( areanum );
 		//remove all routing cache involving this area
 		AAS_RemoveRoutingCacheUsingArea( areanum );
 	} //end if
@@ -697,45 +899,107 @@ int AAS_FreeOldestCache(void)
 } //end of the function AAS_FreeOldestCache
 */
 //===========================================================================
+// unlinks the routing cache from its cluster area or portal cache list and
+// frees it, the shard of the cache must be locked
 //
 // Parameter:			-
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-int AAS_FreeOldestCache(void)
+static void AAS_RemoveRoutingCache(aas_routingcache_t *cache)
 {
 	int clusterareanum;
-	aas_routingcache_t *cache;
 
-	for (cache = aasworld.oldestcache; cache; cache = cache->time_next) {
-		// never free area cache leading towards a portal
-		if (cache->type == CACHETYPE_AREA && aasworld.areasettings[cache->areanum].cluster < 0) {
-			continue;
-		}
-		break;
+	if (cache->type == CACHETYPE_AREA) {
+		//number of the area in the cluster
+		clusterareanum = AAS_ClusterAreaNum(cache->cluster, cache->areanum);
+		// unlink from cluster area cache
+		if (cache->prev) cache->prev->next = cache->next;
+		else aasworld.clusterareacache[cache->cluster][clusterareanum] = cache->next;
+		if (cache->next) cache->next->prev = cache->prev;
 	}
-	if (cache) {
-		// unlink the cache
-		if (cache->type == CACHETYPE_AREA) {
-			//number of the area in the cluster
-			clusterareanum = AAS_ClusterAreaNum(cache->cluster, cache->areanum);
-			// unlink from cluster area cache
-			if (cache->prev) cache->prev->next = cache->next;
-			else aasworld.clusterareacache[cache->cluster][clusterareanum] = cache->next;
-			if (cache->next) cache->next->prev = cache->prev;
+	else {
+		// unlink from portal cache
+		if (cache->prev) cache->prev->next = cache->next;
+		else aasworld.portalcache[cache->areanum] = cache->next;
+		if (cache->next) cache->next->prev = cache->prev;
+	}
+	AAS_FreeRoutingCache(cache);
+} //end of the function AAS_RemoveRoutingCache
+//===========================================================================
+// frees the least recently used routing cache of the next shard that has
+// one to spare, must be called without holding a shard lock
+//
+// Parameter:			-
+// Returns:				qtrue if a routing cache was freed
+// Changes Globals:		-
+//===========================================================================
+int AAS_FreeOldestCache(void)
+{
+	int i, numshards;
+	aas_routingshard_t *shard;
+	aas_routingcache_t *cache;
+
+	numshards = aasworld.numclusters + NUM_PORTALCACHESHARDS;
+	for (i = 0; i < numshards; i++)
+	{
+		//the shards take turns, each one frees its least recently used cache
+		AAS_LockRoutingMemory();
+		shard = AAS_RoutingShard(aasworld.evictshard);
+		aasworld.evictshard = (aasworld.evictshard + 1) % numshards;
+		AAS_UnlockRoutingMemory();
+		//
+		AAS_LockShard(shard);
+		for (cache = shard->oldestcache; cache; cache = cache->time_next) {
+			// never free area cache leading towards a portal
+			if (cache->type == CACHETYPE_AREA && aasworld.areasettings[cache->areanum].cluster < 0) {
+				continue;
+			}
+			break;
 		}
-		else {
-			// unlink from portal cache
-			if (cache->prev) cache->prev->next = cache->next;
-			else aasworld.portalcache[cache->areanum] = cache->next;
-			if (cache->next) cache->next->prev = cache->prev;
+		if (cache) {
+			AAS_RemoveRoutingCache(cache);
+			shard->evictions++;
+			AAS_UnlockShard(shard);
+			return qtrue;
 		}
-		AAS_FreeRoutingCache(cache);
-		return qtrue;
+		AAS_UnlockShard(shard);
 	}
 	return qfalse;
 } //end of the function AAS_FreeOldestCache
 //===========================================================================
+// returns qtrue if the routing cache is over its budget or the zone is
+// running out of memory
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_RoutingCacheFull(void)
+{
+	int full;
+
+	AAS_LockRoutingMemory();
+	full = (max_routingcachesize > 0 && routingcachesize > max_routingcachesize)
+				|| AvailableMemory() < 1 * 1024 * 1024;
+	AAS_UnlockRoutingMemory();
+	return full;
+} //end of the function AAS_RoutingCacheFull
+//===========================================================================
+// frees routing caches until the routing cache fits its budget again,
+// must be called without holding a shard lock
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_LimitRoutingCache(void)
+{
+	while (AAS_RoutingCacheFull()) {
+		if (!AAS_FreeOldestCache()) break;
+	}
+} //end of the function AAS_LimitRoutingCache
+//===========================================================================
 //
 // Parameter:			-
 // Returns:				-
@@ -751,10 +1015,14 @@ aas_routingcache_t *AAS_AllocRoutingCache(int numtraveltimes)
 						+ numtraveltimes * sizeof(unsigned short int)
 						+ numtraveltimes * sizeof(unsigned char);
 	//
+	AAS_LockRoutingMemory();
 	routingcachesize += size;
-	//
+	aasworld.frameroutingupdates++;
 	cache = (aas_routingcache_t *) GetClearedMemory(size);
-	cache->reachabilities = (unsigned char *) cache + sizeof(aas_routingcache_t)
+	AAS_UnlockRoutingMemory();
+	//
+	cache->traveltimes = (unsigned short int *) ((unsigned char *) cache + sizeof(aas_routingcache_t));
+	cache->reachabilities = (unsigned char *) cache->traveltimes
 								+ numtraveltimes * sizeof(unsigned short int);
 	cache->size = size;
 	return cache;
@@ -882,12 +1150,75 @@ void AAS_InitRoutingUpdate(void)
 	//allocate memory for the routing update fields
 	aasworld.areaupdate = (aas_routingupdate_t *) GetClearedMemory(
 									maxreachabilityareas * sizeof(aas_routingupdate_t));
+} //end of the function AAS_InitRoutingUpdate
+//===========================================================================
+// the routing caches must have been freed already
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_FreeRoutingShards(void)
+{
+	int i;
+	aas_routingshard_t *shard;
+
+	if (!aasworld.clustershards) return;
+	//
+	for (i = 0; i < aasworld.numclusters + NUM_PORTALCACHESHARDS; i++)
+	{
+		shard = AAS_RoutingShard(i);
+		if (shard->lock) botimport.DestroyMutex(shard->lock);
+		if (shard->update) FreeMemory(shard->update);
+		Com_Memset(shard, 0, sizeof(aas_routingshard_t));
+	} //end for
+	FreeMemory(aasworld.clustershards);
+	aasworld.clustershards = NULL;
 	//
-	if (aasworld.portalupdate) FreeMemory(aasworld.portalupdate);
-	//allocate memory for the portal update fields
-	aasworld.portalupdate = (aas_routingupdate_t *) GetClearedMemory(
+	if (aasworld.routingmemorylock) botimport.DestroyMutex(aasworld.routingmemorylock);
+	aasworld.routingmemorylock = NULL;
+} //end of the function AAS_FreeRoutingShards
+//===========================================================================
+// creates the routing cache shards, each shard has its own routing update
+// fields so caches in different shards can be updated at the same time
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_InitRoutingShards(void)
+{
+	int i, threaded;
+	aas_routingshard_t *shard;
+
+	AAS_FreeRoutingShards();
+	//locks are only needed when routing queries can run on the job threads
+	threaded = botimport.NumJobThreads() > 0;
+	if (threaded) aasworld.routingmemorylock = botimport.CreateMutex();
+	aasworld.evictshard = 0;
+	//
+	aasworld.clustershards = (aas_routingshard_t *) GetClearedMemory(
+									aasworld.numclusters * sizeof(aas_routingshard_t));
+	for (i = 0; i < aasworld.numclusters + NUM_PORTALCACHESHARDS; i++)
+	{
+		shard = AAS_RoutingShard(i);
+		Com_Memset(shard, 0, sizeof(aas_routingshard_t));
+		if (threaded) shard->lock = botimport.CreateMutex();
+		//area caches index the update fields with the cluster area number
+		if (i < aasworld.numclusters)
+		{
+			if (!aasworld.clusters[i].numreachabilityareas) continue;
+			shard->update = (aas_routingupdate_t *) GetClearedMemory(
+									aasworld.clusters[i].numreachabilityareas * sizeof(aas_routingupdate_t));
+		} //end if
+		//portal caches index the update fields with the portal number
+		else
+		{
+			shard->update = (aas_routingupdate_t *) GetClearedMemory(
 									(aasworld.numportals+1) * sizeof(aas_routingupdate_t));
-} //end of the function AAS_InitRoutingUpdate
+		} //end else
+	} //end for
+} //end of the function AAS_InitRoutingShards
 //===========================================================================
 //
 // Parameter:			-
@@ -923,8 +1254,9 @@ void AAS_CreateAllRoutingCache(void)
 //===========================================================================
 
 //the route cache header
-//this header is followed by numportalcache + numareacache aas_routingcache_t
-//structures that store routing cache
+//this header is followed by numportalcache + numareacache routecacheindex_t
+//structures, the portal caches come first, the travel times and
+//reachabilities of the caches are stored after the index
 typedef struct routecacheheader_s
 {
 	int ident;
@@ -937,27 +1269,105 @@ typedef struct routecacheheader_s
 	int numareacache;
 } routecacheheader_t;
 
+//index of a routing cache in the route cache file, the cache has
+//numtraveltimes travel times at the given offset from the start of the
+//file followed by as many reachabilities
+typedef struct routecacheindex_s
+{
+	int cluster;
+	int areanum;
+	int travelflags;
+	int numtraveltimes;
+	int offset;
+} routecacheindex_t;
+
 #define RCID						(('C'<<24)+('R'<<16)+('E'<<8)+'M')
-#define RCVERSION					2
+#define RCVERSION					3
 
 //void AAS_DecompressVis(byte *in, int numareas, byte *decompressed);
 //int AAS_CompressVis(byte *vis, int numareas, byte *dest);
 
+//===========================================================================
+// returns the size of the travel times and reachabilities of a routing
+// cache in the route cache file, padded so the next cache is aligned
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_RouteCacheDataSize(int numtraveltimes)
+{
+	return (numtraveltimes * (sizeof(unsigned short int) + sizeof(unsigned char)) + 3) & ~3;
+} //end of the function AAS_RouteCacheDataSize
+//===========================================================================
+// returns the number of travel times the cache has
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_RoutingCacheNumTravelTimes(int type, int cluster)
+{
+	if (type == CACHETYPE_PORTAL) return aasworld.numportals;
+	return aasworld.clusters[cluster].numreachabilityareas;
+} //end of the function AAS_RoutingCacheNumTravelTimes
+//===========================================================================
+// adds the index of the cache to the route cache file index
+//
+// Parameter:			-
+// Returns:				offset of the next cache
+// Changes Globals:		-
+//===========================================================================
+static int AAS_IndexRouteCache(aas_routingcache_t *cache, routecacheindex_t *index, int offset)
+{
+	index->cluster = cache->cluster;
+	index->areanum = cache->areanum;
+	index->travelflags = cache->travelflags;
+	index->numtraveltimes = AAS_RoutingCacheNumTravelTimes(cache->type, cache->cluster);
+	index->offset = offset;
+	return offset + AAS_RouteCacheDataSize(index->numtraveltimes);
+} //end of the function AAS_IndexRouteCache
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_WriteRouteCacheData(aas_routingcache_t *cache, fileHandle_t fp)
+{
+	int numtraveltimes, pad;
+
+	numtraveltimes = AAS_RoutingCacheNumTravelTimes(cache->type, cache->cluster);
+	botimport.FS_Write(cache->traveltimes, numtraveltimes * sizeof(unsigned short int), fp);
+	botimport.FS_Write(cache->reachabilities, numtraveltimes * sizeof(unsigned char), fp);
+	pad = 0;
+	botimport.FS_Write(&pad, AAS_RouteCacheDataSize(numtraveltimes) -
+							numtraveltimes * (sizeof(unsigned short int) + sizeof(unsigned char)), fp);
+} //end of the function AAS_WriteRouteCacheData
+//===========================================================================
+// writes all routing caches to one file with an index in front, so the
+// file can be read with a single read and used without copying
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
 void AAS_WriteRouteCache(void)
 {
-	int i, j, numportalcache, numareacache, totalsize;
+	int i, j, numportalcache, numareacache, numindex, offset;
 	aas_routingcache_t *cache;
 	aas_cluster_t *cluster;
 	fileHandle_t fp;
 	char filename[MAX_QPATH];
 	routecacheheader_t routecacheheader;
+	routecacheindex_t *index;
 
 	numportalcache = 0;
 	for (i = 0; i < aasworld.numareas; i++)
 	{
 		for (cache = aasworld.portalcache[i]; cache; cache = cache->next)
 		{
-			numportalcache++;
+			if (AAS_RoutingCacheValid(cache)) numportalcache++;
 		} //end for
 	} //end for
 	numareacache = 0;
@@ -968,7 +1378,31 @@ void AAS_WriteRouteCache(void)
 		{
 			for (cache = aasworld.clusterareacache[i][j]; cache; cache = cache->next)
 			{
-				numareacache++;
+				if (AAS_RoutingCacheValid(cache)) numareacache++;
+			} //end for
+		} //end for
+	} //end for
+	//create the index, the cache data starts after it
+	index = (routecacheindex_t *) GetClearedMemory((numportalcache + numareacache + 1) * sizeof(routecacheindex_t));
+	offset = sizeof(routecacheheader_t) + (numportalcache + numareacache) * sizeof(routecacheindex_t);
+	numindex = 0;
+	for (i = 0; i < aasworld.numareas; i++)
+	{
+		for (cache = aasworld.portalcache[i]; cache; cache = cache->next)
+		{
+			if (!AAS_RoutingCacheValid(cache)) continue;
+			offset = AAS_IndexRouteCache(cache, &index[numindex++], offset);
+		} //end for
+	} //end for
+	for (i = 0; i < aasworld.numclusters; i++)
+	{
+		cluster = &aasworld.clusters[i];
+		for (j = 0; j < cluster->numareas; j++)
+		{
+			for (cache = aasworld.clusterareacache[i][j]; cache; cache = cache->next)
+			{
+				if (!AAS_RoutingCacheValid(cache)) continue;
+			offset = AAS_IndexRouteCache(cache, &index[numindex++], offset);
 			} //end for
 		} //end for
 	} //end for
@@ -977,6 +1411,7 @@ void AAS_WriteRouteCache(void)
 	botimport.FS_FOpenFile( filename, &fp, FS_WRITE );
 	if (!fp)
 	{
+		FreeMemory(index);
 		AAS_Error("Unable to open file: %s\n", filename);
 		return;
 	} //end if
@@ -989,17 +1424,17 @@ void AAS_WriteRouteCache(void)
 	routecacheheader.clustercrc = CRC_ProcessString( (unsigned char *)aasworld.clusters, sizeof(aas_cluster_t) * aasworld.numclusters );
 	routecacheheader.numportalcache = numportalcache;
 	routecacheheader.numareacache = numareacache;
-	//write the header
+	//write the header and the index
 	botimport.FS_Write(&routecacheheader, sizeof(routecacheheader_t), fp);
-	//
-	totalsize = 0;
-	//write all the cache
+	botimport.FS_Write(index, numindex * sizeof(routecacheindex_t), fp);
+	FreeMemory(index);
+	//write all the cache in the same order as the index
 	for (i = 0; i < aasworld.numareas; i++)
 	{
 		for (cache = aasworld.portalcache[i]; cache; cache = cache->next)
 		{
-			botimport.FS_Write(cache, cache->size, fp);
-			totalsize += cache->size;
+			if (!AAS_RoutingCacheValid(cache)) continue;
+			AAS_WriteRouteCacheData(cache, fp);
 		} //end for
 	} //end for
 	for (i = 0; i < aasworld.numclusters; i++)
@@ -1009,139 +1444,189 @@ void AAS_WriteRouteCache(void)
 		{
 			for (cache = aasworld.clusterareacache[i][j]; cache; cache = cache->next)
 			{
-				botimport.FS_Write(cache, cache->size, fp);
-				totalsize += cache->size;
+				if (!AAS_RoutingCacheValid(cache)) continue;
+				AAS_WriteRouteCacheData(cache, fp);
 			} //end for
 		} //end for
 	} //end for
-	// write the visareas
-	/*
-	for (i = 0; i < aasworld.numareas; i++)
-	{
-		if (!aasworld.areavisibility[i]) {
-			size = 0;
-			botimport.FS_Write(&size, sizeof(int), fp);
-			continue;
-		}
-		AAS_DecompressVis( aasworld.areavisibility[i], aasworld.numareas, aasworld.decompressedvis );
-		size = AAS_CompressVis( aasworld.decompressedvis, aasworld.numareas, aasworld.decompressedvis );
-		botimport.FS_Write(&size, sizeof(int), fp);
-		botimport.FS_Write(aasworld.decompressedvis, size, fp);
-	}
-	*/
 	//
 	botimport.FS_FCloseFile(fp);
 	botimport.Print(PRT_MESSAGE, "\nroute cache written to %s\n", filename);
-	botimport.Print(PRT_MESSAGE, "written %d bytes of routing cache\n", totalsize);
+	botimport.Print(PRT_MESSAGE, "written %d bytes of routing cache\n", offset);
 } //end of the function AAS_WriteRouteCache
 //===========================================================================
+// checks the route cache index entries before any cache is used
 //
 // Parameter:			-
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-aas_routingcache_t *AAS_ReadCache(fileHandle_t fp)
+static qboolean AAS_ValidRouteCacheIndex(routecacheindex_t *index, int type, int filesize)
 {
-	int size;
-	aas_routingcache_t *cache;
-
-	botimport.FS_Read(&size, sizeof(size), fp);
-	cache = (aas_routingcache_t *) GetMemory(size);
-	cache->size = size;
-	botimport.FS_Read((unsigned char *)cache + sizeof(size), size - sizeof(size), fp);
-	cache->reachabilities = (unsigned char *) cache + sizeof(aas_routingcache_t) - sizeof(unsigned short) +
-		(size - sizeof(aas_routingcache_t) + sizeof(unsigned short)) / 3 * 2;
-	return cache;
-} //end of the function AAS_ReadCache
+	if (index->areanum <= 0 || index->areanum >= aasworld.numareas) return qfalse;
+	if (index->cluster <= 0 || index->cluster >= aasworld.numclusters) return qfalse;
+	if (type == CACHETYPE_AREA && AAS_ClusterAreaNum(index->cluster, index->areanum) >= aasworld.clusters[index->cluster].numareas) return qfalse;
+	if (index->numtraveltimes != AAS_RoutingCacheNumTravelTimes(type, index->cluster)) return qfalse;
+	if (index->offset < 0 || (index->offset & 3)) return qfalse;
+	if (index->offset + AAS_RouteCacheDataSize(index->numtraveltimes) > filesize) return qfalse;
+	return qtrue;
+} //end of the function AAS_ValidRouteCacheIndex
 //===========================================================================
+// reads the route cache file header and checks it fits the loaded map
 //
 // Parameter:			-
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-int AAS_ReadRouteCache(void)
+static qboolean AAS_ReadRouteCacheHeader(char *filename, routecacheheader_t *routecacheheader, int *filesize)
 {
-	int i, clusterareanum;//, size;
 	fileHandle_t fp;
-	char filename[MAX_QPATH];
-	routecacheheader_t routecacheheader;
-	aas_routingcache_t *cache;
 
-	Com_sprintf(filename, MAX_QPATH, "maps/%s.rcd", aasworld.mapname);
-	botimport.FS_FOpenFile( filename, &fp, FS_READ );
+	*filesize = botimport.FS_FOpenFile( filename, &fp, FS_READ );
 	if (!fp)
 	{
 		return qfalse;
 	} //end if
-	botimport.FS_Read(&routecacheheader, sizeof(routecacheheader_t), fp );
-	if (routecacheheader.ident != RCID)
+	if (*filesize < (int) sizeof(routecacheheader_t))
 	{
+		botimport.FS_FCloseFile(fp);
 		AAS_Error("%s is not a route cache dump\n", filename);
 		return qfalse;
 	} //end if
-	if (routecacheheader.version != RCVERSION)
+	botimport.FS_Read(routecacheheader, sizeof(routecacheheader_t), fp);
+	botimport.FS_FCloseFile(fp);
+	if (routecacheheader->ident != RCID)
 	{
-		AAS_Error("route cache dump has wrong version %d, should be %d\n", routecacheheader.version, RCVERSION);
+		AAS_Error("%s is not a route cache dump\n", filename);
+		return qfalse;
+	} //end if
+	if (routecacheheader->version != RCVERSION)
+	{
+		AAS_Error("route cache dump has wrong version %d, should be %d\n", routecacheheader->version, RCVERSION);
 		return qfalse;
 	} //end if
-	if (routecacheheader.numareas != aasworld.numareas)
+	if (routecacheheader->numareas != aasworld.numareas)
 	{
 		//AAS_Error("route cache dump has wrong number of areas\n");
 		return qfalse;
 	} //end if
-	if (routecacheheader.numclusters != aasworld.numclusters)
+	if (routecacheheader->numclusters != aasworld.numclusters)
 	{
 		//AAS_Error("route cache dump has wrong number of clusters\n");
 		return qfalse;
 	} //end if
-	if (routecacheheader.areacrc !=
+	if (routecacheheader->areacrc !=
 		CRC_ProcessString( (unsigned char *)aasworld.areas, sizeof(aas_area_t) * aasworld.numareas ))
 	{
 		//AAS_Error("route cache dump area CRC incorrect\n");
 		return qfalse;
 	} //end if
-	if (routecacheheader.clustercrc !=
+	if (routecacheheader->clustercrc !=
 		CRC_ProcessString( (unsigned char *)aasworld.clusters, sizeof(aas_cluster_t) * aasworld.numclusters ))
 	{
 		//AAS_Error("route cache dump cluster CRC incorrect\n");
 		return qfalse;
 	} //end if
-	//read all the portal cache
-	for (i = 0; i < routecacheheader.numportalcache; i++)
+	if (routecacheheader->numportalcache < 0 || routecacheheader->numareacache < 0 ||
+		sizeof(routecacheheader_t) + (routecacheheader->numportalcache + routecacheheader->numareacache)
+			* sizeof(routecacheindex_t) > (unsigned) *filesize)
 	{
-		cache = AAS_ReadCache(fp);
-		cache->next = aasworld.portalcache[cache->areanum];
-		cache->prev = NULL;
-		if (aasworld.portalcache[cache->areanum])
-			aasworld.portalcache[cache->areanum]->prev = cache;
-		aasworld.portalcache[cache->areanum] = cache;
-	} //end for
-	//read all the cluster area cache
-	for (i = 0; i < routecacheheader.numareacache; i++)
+		AAS_Error("%s has a corrupt index\n", filename);
+		return qfalse;
+	} //end if
+	return qtrue;
+} //end of the function AAS_ReadRouteCacheHeader
+//===========================================================================
+// maps the route cache file after checking its header, the routing caches
+// use the travel times and reachabilities in the file directly and are
+// never freed
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+int AAS_ReadRouteCache(void)
+{
+	int i, filesize, numcaches, clusterareanum;
+	char filename[MAX_QPATH];
+	void *file;
+	unsigned char *buf;
+	routecacheheader_t header, *routecacheheader;
+	routecacheindex_t *index;
+	aas_routingcache_t *caches, *cache, **list;
+
+	aasworld.numprecomputedcaches = 0;
+	aasworld.precomputedcachesize = 0;
+	Com_sprintf(filename, MAX_QPATH, "maps/%s.rcd", aasworld.mapname);
+	//don't load the file if it's stale
+	if (!AAS_ReadRouteCacheHeader(filename, &header, &filesize))
 	{
-		cache = AAS_ReadCache(fp);
-		clusterareanum = AAS_ClusterAreaNum(cache->cluster, cache->areanum);
-		cache->next = aasworld.clusterareacache[cache->cluster][clusterareanum];
-		cache->prev = NULL;
-		if (aasworld.clusterareacache[cache->cluster][clusterareanum])
-			aasworld.clusterareacache[cache->cluster][clusterareanum]->prev = cache;
-		aasworld.clusterareacache[cache->cluster][clusterareanum] = cache;
-	} //end for
-	// read the visareas
-	/*
-	aasworld.areavisibility = (byte **) GetClearedMemory(aasworld.numareas * sizeof(byte *));
-	aasworld.decompressedvis = (byte *) GetClearedMemory(aasworld.numareas * sizeof(byte));
-	for (i = 0; i < aasworld.numareas; i++)
+		return qfalse;
+	} //end if
+	//the caches point into the file which stays mapped as long as the aas data
+	if (botimport.FS_MapFile(filename, &file) != filesize)
 	{
-		botimport.FS_Read(&size, sizeof(size), fp );
-		if (size) {
-			aasworld.areavisibility[i] = (byte *) GetMemory(size);
-			botimport.FS_Read(aasworld.areavisibility[i], size, fp );
-		}
-	}
-	*/
+		if (file) botimport.FS_UnmapFile(file);
+		AAS_Error("%s changed while it was read\n", filename);
+		return qfalse;
+	} //end if
+	buf = (unsigned char *) file;
+	routecacheheader = (routecacheheader_t *) buf;
+	if (memcmp(routecacheheader, &header, sizeof(routecacheheader_t)))
+	{
+		botimport.FS_UnmapFile(file);
+		AAS_Error("%s changed while it was read\n", filename);
+		return qfalse;
+	} //end if
+	numcaches = routecacheheader->numportalcache + routecacheheader->numareacache;
+	//check the whole index before any cache is used
+	index = (routecacheindex_t *) (buf + sizeof(routecacheheader_t));
+	for (i = 0; i < numcaches; i++)
+	{
+		if (!AAS_ValidRouteCacheIndex(&index[i], i < routecacheheader->numportalcache ?
+										CACHETYPE_PORTAL : CACHETYPE_AREA, filesize))
+		{
+			botimport.FS_UnmapFile(file);
+			AAS_Error("%s has a corrupt index\n", filename);
+			return qfalse;
+		} //end if
+	} //end for
 	//
-	botimport.FS_FCloseFile(fp);
+	caches = (aas_routingcache_t *) GetClearedHunkMemory(numcaches * sizeof(aas_routingcache_t));
+	for (i = 0; i < numcaches; i++)
+	{
+		cache = &caches[i];
+		cache->type = i < routecacheheader->numportalcache ? CACHETYPE_PORTAL : CACHETYPE_AREA;
+		cache->precomputed = qtrue;
+		cache->cluster = index[i].cluster;
+		cache->areanum = index[i].areanum;
+		VectorCopy(aasworld.areas[cache->areanum].center, cache->origin);
+		cache->starttraveltime = 1;
+		cache->travelflags = index[i].travelflags;
+		cache->traveltimes = (unsigned short int *) (buf + index[i].offset);
+		cache->reachabilities = buf + index[i].offset + index[i].numtraveltimes * sizeof(unsigned short int);
+		//add the cache to the portal or cluster area cache list
+		if (cache->type == CACHETYPE_PORTAL)
+		{
+			list = &aasworld.portalcache[cache->areanum];
+		} //end if
+		else
+		{
+			clusterareanum = AAS_ClusterAreaNum(cache->cluster, cache->areanum);
+			list = &aasworld.clusterareacache[cache->cluster][clusterareanum];
+		} //end else
+		cache->next = *list;
+		cache->prev = NULL;
+		if (*list) (*list)->prev = cache;
+		*list = cache;
+	} //end for
+	aasworld.numprecomputedcaches = numcaches;
+	aasworld.precomputedcachesize = filesize;
+	aasworld.precomputedcachefile = file;
+	//areas enabled or disabled from now on
+	aasworld.changedareas = (byte *) GetClearedMemory(aasworld.numareas * sizeof(byte));
+	aasworld.clusterchangedareas = (int *) GetClearedMemory(aasworld.numclusters * sizeof(int));
+	aasworld.numchangedareas = 0;
 	return qtrue;
 } //end of the function AAS_ReadRouteCache
 //===========================================================================
@@ -1237,6 +1722,8 @@ void AAS_InitRouting(void)
 	AAS_InitClusterAreaCache();
 	//initialize portal cache
 	AAS_InitPortalCache();
+	//initialize the routing cache shards
+	AAS_InitRoutingShards();
 	//initialize the area travel times
 	AAS_CalculateAreaTravelTimes();
 	//calculate the maximum travel times through portals
@@ -1244,11 +1731,6 @@ void AAS_InitRouting(void)
 	//get the areas reachabilities go through
 	AAS_InitReachabilityAreas();
 	//
-#ifdef ROUTING_DEBUG
-	numareacacheupdates = 0;
-	numportalcacheupdates = 0;
-#endif //ROUTING_DEBUG
-	//
 	routingcachesize = 0;
 	max_routingcachesize = 1024 * (int) LibVarValue("max_routingcache", "4096");
 	// read any routing cache if available
@@ -1278,8 +1760,17 @@ void AAS_FreeRoutingCaches(void)
 	// free routing algorithm memory
 	if (aasworld.areaupdate) FreeMemory(aasworld.areaupdate);
 	aasworld.areaupdate = NULL;
-	if (aasworld.portalupdate) FreeMemory(aasworld.portalupdate);
-	aasworld.portalupdate = NULL;
+	// free the routing cache shards
+	AAS_FreeRoutingShards();
+	// unmap the route cache file the precomputed caches are in
+	if (aasworld.precomputedcachefile) botimport.FS_UnmapFile(aasworld.precomputedcachefile);
+	aasworld.precomputedcachefile = NULL;
+	// free the areas changed since the route cache file was read
+	if (aasworld.changedareas) FreeMemory(aasworld.changedareas);
+	aasworld.changedareas = NULL;
+	if (aasworld.clusterchangedareas) FreeMemory(aasworld.clusterchangedareas);
+	aasworld.clusterchangedareas = NULL;
+	aasworld.numchangedareas = 0;
 	// free lists with areas the reachabilities go through
 	if (aasworld.reachabilityareas) FreeMemory(aasworld.reachabilityareas);
 	aasworld.reachabilityareas = NULL;
@@ -1291,7 +1782,8 @@ void AAS_FreeRoutingCaches(void)
 	aasworld.areacontentstravelflags = NULL;
 } //end of the function AAS_FreeRoutingCaches
 //===========================================================================
-// update the given routing cache
+// update the given routing cache, the shard of the cluster must be locked
+// because its routing update fields are used
 //
 // Parameter:			areacache		: routing cache to update
 // Returns:				-
@@ -1301,19 +1793,17 @@ void AAS_UpdateAreaRoutingCache(aas_routingcache_t *areacache)
 {
 	int i, nextareanum, cluster, badtravelflags, clusterareanum, linknum;
 	int numreachabilityareas;
-	unsigned short int t, startareatraveltimes[128]; //NOTE: not more than 128 reachabilities per area allowed
+	unsigned short int t;
 	aas_routingupdate_t *updateliststart, *updatelistend, *curupdate, *nextupdate;
 	aas_reachability_t *reach;
 	aas_reversedreachability_t *revreach;
 	aas_reversedlink_t *revlink;
+	aas_routingupdate_t *areaupdate;
 
-#ifdef ROUTING_DEBUG
-	numareacacheupdates++;
-#endif //ROUTING_DEBUG
 	//number of reachability areas within this cluster
 	numreachabilityareas = aasworld.clusters[areacache->cluster].numreachabilityareas;
-	//
-	aasworld.frameroutingupdates++;
+	//routing update fields of the cluster
+	areaupdate = aasworld.clustershards[areacache->cluster].update;
 	//clear the routing update fields
 //	Com_Memset(aasworld.areaupdate, 0, aasworld.numareas * sizeof(aas_routingupdate_t));
 	//
@@ -1322,12 +1812,11 @@ void AAS_UpdateAreaRoutingCache(aas_routingcache_t *areacache)
 	clusterareanum = AAS_ClusterAreaNum(areacache->cluster, areacache->areanum);
 	if (clusterareanum >= numreachabilityareas) return;
 	//
-	Com_Memset(startareatraveltimes, 0, sizeof(startareatraveltimes));
-	//
-	curupdate = &aasworld.areaupdate[clusterareanum];
+	curupdate = &areaupdate[clusterareanum];
 	curupdate->areanum = areacache->areanum;
 	//VectorCopy(areacache->origin, curupdate->start);
-	curupdate->areatraveltimes = startareatraveltimes;
+	//no travel time through the start area
+	curupdate->areatraveltimes = NULL;
 	curupdate->tmptraveltime = areacache->starttraveltime;
 	//
 	areacache->traveltimes[clusterareanum] = areacache->starttraveltime;
@@ -1372,7 +1861,7 @@ void AAS_UpdateAreaRoutingCache(aas_routingcache_t *areacache)
 			//the current area plus the travel time from the reachability
 			t = curupdate->tmptraveltime +
 						//AAS_AreaTravelTime(curupdate->areanum, curupdate->start, reach->end) +
-						curupdate->areatraveltimes[i] +
+						(curupdate->areatraveltimes ? curupdate->areatraveltimes[i] : 0) +
 							reach->traveltime;
 			//
 			if (!areacache->traveltimes[clusterareanum] ||
@@ -1380,7 +1869,7 @@ void AAS_UpdateAreaRoutingCache(aas_routingcache_t *areacache)
 			{
 				areacache->traveltimes[clusterareanum] = t;
 				areacache->reachabilities[clusterareanum] = linknum - aasworld.areasettings[nextareanum].firstreachablearea;
-				nextupdate = &aasworld.areaupdate[clusterareanum];
+				nextupdate = &areaupdate[clusterareanum];
 				nextupdate->areanum = nextareanum;
 				nextupdate->tmptraveltime = t;
 				//VectorCopy(reach->start, nextupdate->start);
@@ -1403,6 +1892,8 @@ void AAS_UpdateAreaRoutingCache(aas_routingcache_t *areacache)
 	} //end while
 } //end of the function AAS_UpdateAreaRoutingCache
 //===========================================================================
+// returns the area routing cache with the shard of the cluster locked,
+// release it with AAS_ReleaseRoutingCache
 //
 // Parameter:			-
 // Returns:				-
@@ -1412,7 +1903,10 @@ aas_routingcache_t *AAS_GetAreaRoutingCache(int clusternum, int areanum, int tra
 {
 	int clusterareanum;
 	aas_routingcache_t *cache, *clustercache;
+	aas_routingshard_t *shard;
 
+	shard = &aasworld.clustershards[clusternum];
+	AAS_LockShard(shard);
 	//number of the area in the cluster
 	clusterareanum = AAS_ClusterAreaNum(clusternum, areanum);
 	//pointer to the cache for the area in the cluster
@@ -1421,12 +1915,13 @@ aas_routingcache_t *AAS_GetAreaRoutingCache(int clusternum, int areanum, int tra
 	for (cache = clustercache; cache; cache = cache->next)
 	{
 		//if there aren't used any undesired travel types for the cache
-		if (cache->travelflags == travelflags) break;
+		if (cache->travelflags == travelflags && AAS_RoutingCacheValid(cache)) break;
 	} //end for
 	//if there was no cache
 	if (!cache)
 	{
 		cache = AAS_AllocRoutingCache(aasworld.clusters[clusternum].numreachabilityareas);
+		cache->type = CACHETYPE_AREA;
 		cache->cluster = clusternum;
 		cache->areanum = areanum;
 		VectorCopy(aasworld.areas[areanum].center, cache->origin);
@@ -1437,18 +1932,23 @@ aas_routingcache_t *AAS_GetAreaRoutingCache(int clusternum, int areanum, int tra
 		if (clustercache) clustercache->prev = cache;
 		aasworld.clusterareacache[clusternum][clusterareanum] = cache;
 		AAS_UpdateAreaRoutingCache(cache);
+		shard->misses++;
 	} //end if
 	else
 	{
-		AAS_UnlinkCache(cache);
+		shard->hits++;
+		//the precomputed caches are never freed so they aren't in the time sorted list
+		if (cache->precomputed) return cache;
+		AAS_UnlinkCache(shard, cache);
 	} //end else
 	//the cache has been accessed
 	cache->time = AAS_RoutingTime();
-	cache->type = CACHETYPE_AREA;
-	AAS_LinkCache(cache);
+	AAS_LinkCache(shard, cache);
 	return cache;
 } //end of the function AAS_GetAreaRoutingCache
 //===========================================================================
+// update the given portal routing cache, the portal cache shard must be
+// locked, area cache shards are locked after it
 //
 // Parameter:			-
 // Returns:				-
@@ -1462,14 +1962,14 @@ void AAS_UpdatePortalRoutingCache(aas_routingcache_t *portalcache)
 	aas_cluster_t *cluster;
 	aas_routingcache_t *cache;
 	aas_routingupdate_t *updateliststart, *updatelistend, *curupdate, *nextupdate;
+	aas_routingupdate_t *portalupdate;
 
-#ifdef ROUTING_DEBUG
-	numportalcacheupdates++;
-#endif //ROUTING_DEBUG
+	//routing update fields of the portal cache shard
+	portalupdate = AAS_PortalCacheShard(portalcache->areanum)->update;
 	//clear the routing update fields
-//	Com_Memset(aasworld.portalupdate, 0, (aasworld.numportals+1) * sizeof(aas_routingupdate_t));
+//	Com_Memset(portalupdate, 0, (aasworld.numportals+1) * sizeof(aas_routingupdate_t));
 	//
-	curupdate = &aasworld.portalupdate[aasworld.numportals];
+	curupdate = &portalupdate[aasworld.numportals];
 	curupdate->cluster = portalcache->cluster;
 	curupdate->areanum = portalcache->areanum;
 	curupdate->tmptraveltime = portalcache->starttraveltime;
@@ -1518,7 +2018,7 @@ void AAS_UpdatePortalRoutingCache(aas_routingcache_t *portalcache)
 					portalcache->traveltimes[portalnum] > t)
 			{
 				portalcache->traveltimes[portalnum] = t;
-				nextupdate = &aasworld.portalupdate[portalnum];
+				nextupdate = &portalupdate[portalnum];
 				if (portal->frontcluster == curupdate->cluster)
 				{
 					nextupdate->cluster = portal->backcluster;
@@ -1544,9 +2044,12 @@ void AAS_UpdatePortalRoutingCache(aas_routingcache_t *portalcache)
 				} //end if
 			} //end if
 		} //end for
+		AAS_ReleaseRoutingCache(cache);
 	} //end while
 } //end of the function AAS_UpdatePortalRoutingCache
 //===========================================================================
+// returns the portal routing cache with its shard locked, release it with
+// AAS_ReleaseRoutingCache
 //
 // Parameter:			-
 // Returns:				-
@@ -1555,16 +2058,20 @@ void AAS_UpdatePortalRoutingCache(aas_routingcache_t *portalcache)
 aas_routingcache_t *AAS_GetPortalRoutingCache(int clusternum, int areanum, int travelflags)
 {
 	aas_routingcache_t *cache;
+	aas_routingshard_t *shard;
 
+	shard = AAS_PortalCacheShard(areanum);
+	AAS_LockShard(shard);
 	//find the cached portal routing if existing
 	for (cache = aasworld.portalcache[areanum]; cache; cache = cache->next)
 	{
-		if (cache->travelflags == travelflags) break;
+		if (cache->travelflags == travelflags && AAS_RoutingCacheValid(cache)) break;
 	} //end for
 	//if the portal routing isn't cached
 	if (!cache)
 	{
 		cache = AAS_AllocRoutingCache(aasworld.numportals);
+		cache->type = CACHETYPE_PORTAL;
 		cache->cluster = clusternum;
 		cache->areanum = areanum;
 		VectorCopy(aasworld.areas[areanum].center, cache->origin);
@@ -1577,18 +2084,204 @@ aas_routingcache_t *AAS_GetPortalRoutingCache(int clusternum, int areanum, int t
 		aasworld.portalcache[areanum] = cache;
 		//update the cache
 		AAS_UpdatePortalRoutingCache(cache);
+		shard->misses++;
 	} //end if
 	else
 	{
-		AAS_UnlinkCache(cache);
+		shard->hits++;
+		//the precomputed caches are never freed so they aren't in the time sorted list
+		if (cache->precomputed) return cache;
+		AAS_UnlinkCache(shard, cache);
 	} //end else
 	//the cache has been accessed
 	cache->time = AAS_RoutingTime();
-	cache->type = CACHETYPE_PORTAL;
-	AAS_LinkCache(cache);
+	AAS_LinkCache(shard, cache);
 	return cache;
 } //end of the function AAS_GetPortalRoutingCache
 //===========================================================================
+// allocates a routing cache for AAS_RoutingBenchmark, the cache isn't
+// linked into any list
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static aas_routingcache_t *AAS_AllocBenchmarkCache(int type, int clusternum, int areanum, int numtraveltimes)
+{
+	aas_routingcache_t *cache;
+
+	cache = AAS_AllocRoutingCache(numtraveltimes);
+	cache->type = type;
+	cache->cluster = clusternum;
+	cache->areanum = areanum;
+	VectorCopy(aasworld.areas[areanum].center, cache->origin);
+	cache->starttraveltime = 1;
+	cache->travelflags = TFL_DEFAULT;
+	return cache;
+} //end of the function AAS_AllocBenchmarkCache
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_FreeBenchmarkCache(aas_routingcache_t *cache)
+{
+	AAS_LockRoutingMemory();
+	routingcachesize -= cache->size;
+	FreeMemory(cache);
+	AAS_UnlockRoutingMemory();
+} //end of the function AAS_FreeBenchmarkCache
+//===========================================================================
+// builds the area and portal routing caches towards every area and prints
+// how long that took
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void AAS_RoutingBenchmark(void)
+{
+	int i, type, clusternum, numtraveltimes, numgoals;
+	int64_t starttime, usec[2];
+	aas_routingcache_t *cache;
+	aas_routingshard_t *shard;
+
+	if (!aasworld.initialized) return;
+	//
+	usec[CACHETYPE_AREA] = usec[CACHETYPE_PORTAL] = 0;
+	numgoals = 0;
+	for (i = 1; i < aasworld.numareas; i++)
+	{
+		if (!AAS_AreaReachability(i)) continue;
+		clusternum = aasworld.areasettings[i].cluster;
+		if (clusternum < 0) clusternum = aasworld.portals[-clusternum].frontcluster;
+		numgoals++;
+		// make sure the routing cache doesn't grow to large
+		AAS_LimitRoutingCache();
+		//the area routing cache towards the area
+		type = CACHETYPE_AREA;
+		numtraveltimes = aasworld.clusters[clusternum].numreachabilityareas;
+		shard = &aasworld.clustershards[clusternum];
+		AAS_LockShard(shard);
+		cache = AAS_AllocBenchmarkCache(type, clusternum, i, numtraveltimes);
+		starttime = Sys_Microseconds();
+		AAS_UpdateAreaRoutingCache(cache);
+		usec[type] += Sys_Microseconds() - starttime;
+		AAS_UnlockShard(shard);
+		AAS_FreeBenchmarkCache(cache);
+		//the portal routing cache towards the area, the area routing
+		//caches it needs are created by the first update so only the
+		//second one is timed
+		type = CACHETYPE_PORTAL;
+		numtraveltimes = aasworld.numportals;
+		shard = AAS_PortalCacheShard(i);
+		AAS_LockShard(shard);
+		cache = AAS_AllocBenchmarkCache(type, clusternum, i, numtraveltimes);
+		AAS_UpdatePortalRoutingCache(cache);
+		Com_Memset(cache->traveltimes, 0, numtraveltimes * sizeof(unsigned short int));
+		starttime = Sys_Microseconds();
+		AAS_UpdatePortalRoutingCache(cache);
+		usec[type] += Sys_Microseconds() - starttime;
+		AAS_UnlockShard(shard);
+		AAS_FreeBenchmarkCache(cache);
+	} //end for
+	//
+	botimport.Print(PRT_MESSAGE, "routing caches towards %d areas\n", numgoals);
+	botimport.Print(PRT_MESSAGE, "area cache: %d msec\n", (int) (usec[CACHETYPE_AREA] / 1000));
+	botimport.Print(PRT_MESSAGE, "portal cache: %d msec\n", (int) (usec[CACHETYPE_PORTAL] / 1000));
+} //end of the function AAS_RoutingBenchmark
+//===========================================================================
+// creates the portal and area routing caches towards the areas of a
+// precomputation job, runs on a job thread, only the default travel flags
+// are precomputed because bots combine the other ones in too many ways
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_PrecomputeRouteCacheJob(void *data)
+{
+	int i, clusternum;
+	aas_precomputejob_t *job;
+	aas_portal_t *portal;
+
+	job = (aas_precomputejob_t *) data;
+	for (i = job->firstarea; i < aasworld.numareas; i += job->areastep)
+	{
+		if (!AAS_AreaReachability(i)) continue;
+		clusternum = aasworld.areasettings[i].cluster;
+		//a portal has an area cache in both clusters it separates
+		if (clusternum < 0)
+		{
+			portal = &aasworld.portals[-clusternum];
+			AAS_ReleaseRoutingCache(AAS_GetAreaRoutingCache(portal->frontcluster, i, TFL_DEFAULT));
+			AAS_ReleaseRoutingCache(AAS_GetAreaRoutingCache(portal->backcluster, i, TFL_DEFAULT));
+			clusternum = portal->frontcluster;
+		} //end if
+		else
+		{
+			AAS_ReleaseRoutingCache(AAS_GetAreaRoutingCache(clusternum, i, TFL_DEFAULT));
+		} //end else
+		AAS_ReleaseRoutingCache(AAS_GetPortalRoutingCache(clusternum, i, TFL_DEFAULT));
+	} //end for
+} //end of the function AAS_PrecomputeRouteCacheJob
+//===========================================================================
+// creates the area and portal routing caches towards every area on the
+// job threads and writes them to the route cache file
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void AAS_PrecomputeRouteCache(void)
+{
+	int i, numjobs, counter, starttime, size, clusternum;
+	aas_precomputejob_t jobs[MAX_ROUTINGJOBS];
+
+	if (!aasworld.initialized) return;
+	//the routing caches are kept until they are written
+	size = 0;
+	for (i = 1; i < aasworld.numareas; i++)
+	{
+		if (!AAS_AreaReachability(i)) continue;
+		clusternum = aasworld.areasettings[i].cluster;
+		if (clusternum < 0)
+		{
+			size += sizeof(aas_routingcache_t) + 3 * aasworld.clusters[aasworld.portals[-clusternum].frontcluster].numreachabilityareas;
+			size += sizeof(aas_routingcache_t) + 3 * aasworld.clusters[aasworld.portals[-clusternum].backcluster].numreachabilityareas;
+		} //end if
+		else
+		{
+			size += sizeof(aas_routingcache_t) + 3 * aasworld.clusters[clusternum].numreachabilityareas;
+		} //end else
+		size += sizeof(aas_routingcache_t) + 3 * aasworld.numportals;
+	} //end for
+	if (size > AvailableMemory() - 1024 * 1024)
+	{
+		botimport.Print(PRT_ERROR, "route cache precomputation needs %d KB, only %d KB available\n",
+							size >> 10, AvailableMemory() >> 10);
+		return;
+	} //end if
+	//one job for every job thread plus one for the calling thread
+	numjobs = botimport.NumJobThreads() + 1;
+	if (numjobs > MAX_ROUTINGJOBS) numjobs = MAX_ROUTINGJOBS;
+	starttime = Sys_MilliSeconds();
+	counter = 0;
+	for (i = 0; i < numjobs; i++)
+	{
+		jobs[i].firstarea = i + 1;
+		jobs[i].areastep = numjobs;
+		if (i) botimport.AddJob(AAS_PrecomputeRouteCacheJob, &jobs[i], &counter);
+	} //end for
+	AAS_PrecomputeRouteCacheJob(&jobs[0]);
+	botimport.WaitJobs(&counter);
+	botimport.Print(PRT_MESSAGE, "route cache precomputed in %d msec with %d jobs\n",
+						Sys_MilliSeconds() - starttime, numjobs);
+	//
+	AAS_WriteRouteCache();
+} //end of the function AAS_PrecomputeRouteCache
+//===========================================================================
 //
 // Parameter:			-
 // Returns:				-
@@ -1629,9 +2322,7 @@ int AAS_AreaRouteToGoalArea(int areanum, vec3_t origin, int goalareanum, int tra
 		return qfalse;
 	} //end if
 	// make sure the routing cache doesn't grow to large
-	while(AvailableMemory() < 1 * 1024 * 1024) {
-		if (!AAS_FreeOldestCache()) break;
-	}
+	AAS_LimitRoutingCache();
 	//
 	if (AAS_AreaDoNotEnter(areanum) || AAS_AreaDoNotEnter(goalareanum))
 	{
@@ -1681,22 +2372,27 @@ int AAS_AreaRouteToGoalArea(int areanum, vec3_t origin, int goalareanum, int tra
 		//the cluster the area is in
 		cluster = &aasworld.clusters[clusternum];
 		//if the area is NOT a reachability area
-		if (clusterareanum >= cluster->numreachabilityareas) return 0;
+		if (clusterareanum >= cluster->numreachabilityareas)
+		{
+			AAS_ReleaseRoutingCache(areacache);
+			return 0;
+		} //end if
 		//if it is possible to travel to the goal area through this cluster
 		if (areacache->traveltimes[clusterareanum] != 0)
 		{
 			*reachnum = aasworld.areasettings[areanum].firstreachablearea +
 							areacache->reachabilities[clusterareanum];
+			*traveltime = areacache->traveltimes[clusterareanum];
+			AAS_ReleaseRoutingCache(areacache);
 			if (!origin) {
-				*traveltime = areacache->traveltimes[clusterareanum];
 				return qtrue;
 			}
 			reach = &aasworld.reachability[*reachnum];
-			*traveltime = areacache->traveltimes[clusterareanum] +
-							AAS_AreaTravelTime(areanum, origin, reach->start);
+			*traveltime += AAS_AreaTravelTime(areanum, origin, reach->start);
 			//
 			return qtrue;
 		} //end if
+		AAS_ReleaseRoutingCache(areacache);
 	} //end if
 	//
 	clusternum = aasworld.areasettings[areanum].cluster;
@@ -1716,6 +2412,7 @@ int AAS_AreaRouteToGoalArea(int areanum, vec3_t origin, int goalareanum, int tra
 		*traveltime = portalcache->traveltimes[-clusternum];
 		*reachnum = aasworld.areasettings[areanum].firstreachablearea +
 						portalcache->reachabilities[-clusternum];
+		AAS_ReleaseRoutingCache(portalcache);
 		return qtrue;
 	} //end if
 	//
@@ -1736,9 +2433,13 @@ int AAS_AreaRouteToGoalArea(int areanum, vec3_t origin, int goalareanum, int tra
 		//current area inside the current cluster
 		clusterareanum = AAS_ClusterAreaNum(clusternum, areanum);
 		//if the area is NOT a reachability area
-		if (clusterareanum >= cluster->numreachabilityareas) continue;
-		//if the portal is NOT reachable from this area
-		if (!areacache->traveltimes[clusterareanum]) continue;
+		//or the portal is NOT reachable from this area
+		if (clusterareanum >= cluster->numreachabilityareas ||
+				!areacache->traveltimes[clusterareanum])
+		{
+			AAS_ReleaseRoutingCache(areacache);
+			continue;
+		} //end if
 		//total travel time is the travel time the portal area is from
 		//the goal area plus the travel time towards the portal area
 		t = portalcache->traveltimes[portalnum] + areacache->traveltimes[clusterareanum];
@@ -1756,6 +2457,7 @@ int AAS_AreaRouteToGoalArea(int areanum, vec3_t origin, int goalareanum, int tra
 			reach = aasworld.reachability + *reachnum;
 			t += AAS_AreaTravelTime(areanum, origin, reach->start);
 		} //end if
+		AAS_ReleaseRoutingCache(areacache);
 		//if the time is better than the one already found
 		if (!besttime || t < besttime)
 		{
@@ -1763,6 +2465,7 @@ int AAS_AreaRouteToGoalArea(int areanum, vec3_t origin, int goalareanum, int tra
 			besttime = t;
 		} //end if
 	} //end for
+	AAS_ReleaseRoutingCache(portalcache);
 	if (bestreachnum < 0) {
 		return qfalse;
 	}
@@ -1913,6 +2616,73 @@ int AAS_PredictRoute(struct aas_predictroute_s *route, int areanum, vec3_t origi
 	return qtrue;
 } //end of the function AAS_PredictRoute
 //===========================================================================
+// looks up the routes of a routing job, runs on a job thread
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_RoutingJob(void *data)
+{
+	aas_routingjob_t *job;
+	aas_routequery_t *query;
+	int i, traveltime, reachnum;
+
+	job = (aas_routingjob_t *) data;
+	for (i = 0; i < job->numqueries; i++)
+	{
+		query = &job->queries[i];
+		AAS_AreaRouteToGoalArea(query->areanum, NULL, query->goalareanum,
+									query->travelflags, &traveltime, &reachnum);
+	} //end for
+} //end of the function AAS_RoutingJob
+//===========================================================================
+// looks up the given routes on the job threads so the area and portal
+// routing caches they need exist before the bots ask for them
+//
+// Parameter:			queries			: routes likely to be queried
+//						numqueries		: number of routes
+// Returns:				number of routes looked up
+// Changes Globals:		-
+//===========================================================================
+int AAS_PrepareRoutes(aas_routequery_t *queries, int numqueries)
+{
+	int i, numvalid, numjobs, counter;
+	aas_routingjob_t jobs[MAX_ROUTINGJOBS];
+	aas_routequery_t *query;
+
+	if (!aasworld.initialized) return 0;
+	//move the valid queries to the front
+	numvalid = 0;
+	for (i = 0; i < numqueries; i++)
+	{
+		query = &queries[i];
+		if (query->areanum <= 0 || query->areanum >= aasworld.numareas) continue;
+		if (query->goalareanum <= 0 || query->goalareanum >= aasworld.numareas) continue;
+		if (query->areanum == query->goalareanum) continue;
+		queries[numvalid++] = *query;
+	} //end for
+	if (!numvalid) return 0;
+	//one routing job for every job thread plus one for the calling thread
+	numjobs = botimport.NumJobThreads() + 1;
+	if (numjobs > MAX_ROUTINGJOBS) numjobs = MAX_ROUTINGJOBS;
+	if (numjobs > numvalid) numjobs = numvalid;
+	for (i = 0; i < numjobs; i++)
+	{
+		jobs[i].queries = queries + i * numvalid / numjobs;
+		jobs[i].numqueries = (i + 1) * numvalid / numjobs - i * numvalid / numjobs;
+	} //end for
+	//the calling thread runs the first part and waits for the rest
+	counter = 0;
+	for (i = 1; i < numjobs; i++)
+	{
+		botimport.AddJob(AAS_RoutingJob, &jobs[i], &counter);
+	} //end for
+	AAS_RoutingJob(&jobs[0]);
+	botimport.WaitJobs(&counter);
+	return numvalid;
+} //end of the function AAS_PrepareRoutes
+//===========================================================================
 //
 // Parameter:			-
 // Returns:				-
@@ -46,7 +46,11 @@ void AAS_FreeRoutingCaches(void);
 unsigned short int AAS_AreaTravelTime(int areanum, vec3_t start, vec3_t end);
 //
 void AAS_CreateAllRoutingCache(void);
+//builds all routing caches and prints how long that took
+void AAS_RoutingBenchmark(void);
 void AAS_WriteRouteCache(void);
+//creates all routing caches on the job threads and writes them to file
+void AAS_PrecomputeRouteCache(void);
 //
 void AAS_RoutingInfo(void);
 #endif //AASINTERN
@@ -71,5 +75,7 @@ int AAS_AreaTravelTimeToGoalArea(int areanum, vec3_t origin, int goalareanum, in
 int AAS_PredictRoute(struct aas_predictroute_s *route, int areanum, vec3_t origin,
 							int goalareanum, int travelflags, int maxareas, int maxtime,
 							int stopevent, int stopcontents, int stoptfl, int stopareanum);
+//creates the missing routing caches for the given routes, using the job threads
+int AAS_PrepareRoutes(struct aas_routequery_s *queries, int numqueries);
 
 
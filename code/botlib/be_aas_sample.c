@@ -60,6 +60,12 @@ Suite 120, Rockville, Maryland 20850 USA.
 #define ON_EPSILON					0 //0.0005
 
 #define TRACEPLANE_EPSILON			0.125
+//smallest size of an area grid cell
+#define AREAGRID_MINCELLSIZE		64
+//maximum number of area grid cells
+#define MAX_AREAGRIDCELLS			65536
+//distance the area grid cells must stay away from node planes
+#define AREAGRID_EPSILON			0.1f
 
 typedef struct aas_tracestack_s
 {
@@ -211,6 +217,149 @@ void AAS_FreeAASLinkedEntities(void)
 	aasworld.arealinkedentities = NULL;
 } //end of the function AAS_InitAASLinkedEntities
 //===========================================================================
+// returns the deepest node the whole box is inside, zero if the box is
+// in solid or the negative area number if the box is inside one area
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_BoxStartNode(vec3_t mins, vec3_t maxs)
+{
+	int nodenum;
+	vec_t dist, radius;
+	vec3_t center, extents;
+	aas_node_t *node;
+	aas_plane_t *plane;
+
+	VectorAdd(mins, maxs, center);
+	VectorScale(center, 0.5, center);
+	VectorSubtract(maxs, center, extents);
+	//start with node 1 because node zero is a dummy used for solid leafs
+	nodenum = 1;
+	while (nodenum > 0)
+	{
+		node = &aasworld.nodes[nodenum];
+		plane = &aasworld.planes[node->planenum];
+		dist = DotProduct(center, plane->normal) - plane->dist;
+		radius = fabs(plane->normal[0]) * extents[0] +
+					fabs(plane->normal[1]) * extents[1] +
+					fabs(plane->normal[2]) * extents[2];
+		//stay away from the plane so point and line queries agree
+		if (dist - radius > AREAGRID_EPSILON) nodenum = node->children[0];
+		else if (dist + radius < -AREAGRID_EPSILON) nodenum = node->children[1];
+		else break;
+	} //end while
+	return nodenum;
+} //end of the function AAS_BoxStartNode
+//===========================================================================
+// creates a uniform grid over the areas, every cell stores the node point
+// and line queries inside the cell can start from instead of the root
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_InitAreaGrid(void)
+{
+	int i, x, y, z, numcells;
+	vec3_t mins, maxs;
+
+	AAS_FreeAreaGrid();
+	if (!aasworld.loaded || aasworld.numareas <= 1) return;
+	//bounds of all the areas
+	VectorCopy(aasworld.areas[1].mins, mins);
+	VectorCopy(aasworld.areas[1].maxs, maxs);
+	for (i = 2; i < aasworld.numareas; i++)
+	{
+		AddPointToBounds(aasworld.areas[i].mins, mins, maxs);
+		AddPointToBounds(aasworld.areas[i].maxs, mins, maxs);
+	} //end for
+	//use larger cells until the grid isn't too large
+	aasworld.areagridcellsize = AREAGRID_MINCELLSIZE;
+	while (1)
+	{
+		numcells = 1;
+		for (i = 0; i < 3; i++)
+		{
+			aasworld.areagridsize[i] = (int) ((maxs[i] - mins[i]) / aasworld.areagridcellsize) + 1;
+			numcells *= aasworld.areagridsize[i];
+		} //end for
+		if (numcells <= MAX_AREAGRIDCELLS) break;
+		aasworld.areagridcellsize *= 2;
+	} //end while
+	VectorCopy(mins, aasworld.areagridmins);
+	aasworld.areagrid = (int *) GetClearedHunkMemory(numcells * sizeof(int));
+	//
+	i = 0;
+	for (z = 0; z < aasworld.areagridsize[2]; z++)
+	{
+		for (y = 0; y < aasworld.areagridsize[1]; y++)
+		{
+			for (x = 0; x < aasworld.areagridsize[0]; x++)
+			{
+				mins[0] = aasworld.areagridmins[0] + x * aasworld.areagridcellsize;
+				mins[1] = aasworld.areagridmins[1] + y * aasworld.areagridcellsize;
+				mins[2] = aasworld.areagridmins[2] + z * aasworld.areagridcellsize;
+				maxs[0] = mins[0] + aasworld.areagridcellsize;
+				maxs[1] = mins[1] + aasworld.areagridcellsize;
+				maxs[2] = mins[2] + aasworld.areagridcellsize;
+				aasworld.areagrid[i++] = AAS_BoxStartNode(mins, maxs);
+			} //end for
+		} //end for
+	} //end for
+} //end of the function AAS_InitAreaGrid
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void AAS_FreeAreaGrid(void)
+{
+	if (aasworld.areagrid) FreeMemory(aasworld.areagrid);
+	aasworld.areagrid = NULL;
+} //end of the function AAS_FreeAreaGrid
+//===========================================================================
+// returns the area grid cell the point is in, -1 if outside the grid
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE int AAS_AreaGridCell(vec3_t point)
+{
+	int i, cell[3];
+
+	for (i = 0; i < 3; i++)
+	{
+		if (point[i] < aasworld.areagridmins[i]) return -1;
+		cell[i] = (int) ((point[i] - aasworld.areagridmins[i]) / aasworld.areagridcellsize);
+		if (cell[i] >= aasworld.areagridsize[i]) return -1;
+	} //end for
+	return (cell[2] * aasworld.areagridsize[1] + cell[1]) * aasworld.areagridsize[0] + cell[0];
+} //end of the function AAS_AreaGridCell
+//===========================================================================
+// returns the node a query for the line from start to end can start from,
+// the node of the grid cell when both points are in the same cell and
+// otherwise the root of the tree
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE int AAS_LineStartNode(vec3_t start, vec3_t end)
+{
+	int cell;
+
+	//start with node 1 because node zero is a dummy used for solid leafs
+	if (!aasworld.areagrid) return 1;
+	cell = AAS_AreaGridCell(start);
+	if (cell < 0) return 1;
+	if (AAS_AreaGridCell(end) != cell) return 1;
+	return aasworld.areagrid[cell];
+} //end of the function AAS_LineStartNode
+//===========================================================================
 // returns the AAS area the point is in
 //
 // Parameter:				-
@@ -230,8 +379,8 @@ int AAS_PointAreaNum(vec3_t point)
 		return 0;
 	} //end if
 
-	//start with node 1 because node zero is a dummy used for solid leafs
-	nodenum = 1;
+	//start with the node of the grid cell the point is in
+	nodenum = AAS_LineStartNode(point, point);
 	while (nodenum > 0)
 	{
 //		botimport.Print(PRT_MESSAGE, "[%d]", nodenum);
@@ -475,8 +624,8 @@ aas_trace_t AAS_TraceClientBBox(vec3_t start, vec3_t end, int presencetype,
 	VectorCopy(start, tstack_p->start);
 	VectorCopy(end, tstack_p->end);
 	tstack_p->planenum = 0;
-	//start with node 1 because node zero is a dummy for a solid leaf
-	tstack_p->nodenum = 1;		//starting at the root of the tree
+	//start with the node of the grid cell when the line is inside one cell
+	tstack_p->nodenum = AAS_LineStartNode(start, end);
 	tstack_p++;
 	
 	while (1)
@@ -750,8 +899,8 @@ int AAS_TraceAreas(vec3_t start, vec3_t end, int *areas, vec3_t *points, int max
 	VectorCopy(start, tstack_p->start);
 	VectorCopy(end, tstack_p->end);
 	tstack_p->planenum = 0;
-	//start with node 1 because node zero is a dummy for a solid leaf
-	tstack_p->nodenum = 1;		//starting at the root of the tree
+	//start with the node of the grid cell when the line is inside one cell
+	tstack_p->nodenum = AAS_LineStartNode(start, end);
 	tstack_p++;
 
 	while (1)
@@ -1245,9 +1394,8 @@ aas_link_t *AAS_AASLinkEntity(vec3_t absmins, vec3_t absmaxs, int entnum)
 	areas = NULL;
 	//
 	lstack_p = linkstack;
-	//we start with the whole line on the stack
-	//start with node 1 because node zero is a dummy used for solid leafs
-	lstack_p->nodenum = 1;		//starting at the root of the tree
+	//start with the node of the grid cell when the box is inside one cell
+	lstack_p->nodenum = AAS_LineStartNode(absmins, absmaxs);
 	lstack_p++;
 	
 	while (1)
@@ -1339,6 +1487,69 @@ aas_link_t *AAS_LinkEntityClientBBox(vec3_t absmins, vec3_t absmaxs, int entnum,
 	return AAS_AASLinkEntity(newabsmins, newabsmaxs, entnum);
 } //end of the function AAS_LinkEntityClientBBox
 //===========================================================================
+// stores the numbers of the areas the box is in, in the order
+// AAS_AASLinkEntity visits them, without linking anything into the areas
+//
+// Parameter:				-
+// Returns:					number of areas, maxareas if there are too many
+// Changes Globals:		-
+//===========================================================================
+int AAS_BoxAreaNums(vec3_t absmins, vec3_t absmaxs, int *areas, int maxareas)
+{
+	int i, side, nodenum, numareas;
+	aas_linkstack_t linkstack[128];
+	aas_linkstack_t *lstack_p;
+	aas_node_t *aasnode;
+
+	numareas = 0;
+	if (!aasworld.loaded) return numareas;
+	//
+	lstack_p = linkstack;
+	//start with the node of the grid cell when the box is inside one cell
+	lstack_p->nodenum = AAS_LineStartNode(absmins, absmaxs);
+	lstack_p++;
+	//
+	while (lstack_p > linkstack)
+	{
+		//pop up the stack
+		lstack_p--;
+		nodenum = lstack_p->nodenum;
+		//if it is an area
+		if (nodenum < 0)
+		{
+			//several node children can point to the same area
+			for (i = 0; i < numareas; i++)
+			{
+				if (areas[i] == -nodenum) break;
+			} //end for
+			if (i < numareas) continue;
+			if (numareas >= maxareas) return maxareas;
+			areas[numareas++] = -nodenum;
+			continue;
+		} //end if
+		//if solid leaf
+		if (!nodenum) continue;
+		//
+		aasnode = &aasworld.nodes[nodenum];
+		side = AAS_BoxOnPlaneSide2(absmins, absmaxs, &aasworld.planes[aasnode->planenum]);
+		//if on the front side of the node
+		if (side & 1)
+		{
+			lstack_p->nodenum = aasnode->children[0];
+			lstack_p++;
+		} //end if
+		if (lstack_p >= &linkstack[127]) break;
+		//if on the back side of the node
+		if (side & 2)
+		{
+			lstack_p->nodenum = aasnode->children[1];
+			lstack_p++;
+		} //end if
+		if (lstack_p >= &linkstack[127]) break;
+	} //end while
+	return numareas;
+} //end of the function AAS_BoxAreaNums
+//===========================================================================
 //
 // Parameter:				-
 // Returns:					-
@@ -142,6 +142,7 @@ typedef struct bot_synonym_s
 {
 	char *string;
 	float weight;
+	int node;									//node of the string in the synonym trie
 	struct bot_synonym_s *next;
 } bot_synonym_t;
 //list with synonyms
@@ -157,6 +158,7 @@ typedef struct bot_synonymlist_s
 typedef struct bot_matchstring_s
 {
 	char *string;
+	int node;									//node of the string in the match trie
 	struct bot_matchstring_s *next;
 } bot_matchstring_t;
 
@@ -183,6 +185,7 @@ typedef struct bot_replychatkey_s
 {
 	int flags;
 	char *string;
+	int node;									//node of the string in the match trie
 	bot_matchpiece_t *match;
 	struct bot_replychatkey_s *next;
 } bot_replychatkey_t;
@@ -196,6 +199,27 @@ typedef struct bot_replychat_s
 	struct bot_replychat_s *next;
 } bot_replychat_t;
 
+//node of a chat string trie
+typedef struct bot_chattrienode_s
+{
+	int c;										//upper case character of the edge to the node
+	int firstchild;								//first child node
+	int sibling;								//next child node of the parent
+	int fail;									//node of the longest proper suffix
+	int output;									//first node a string ends at on the fail chain
+	int isstring;								//a string ends at this node
+	int scan;									//last scan that found the string of the node
+} bot_chattrienode_t;
+//trie with chat strings, node zero is the root and strings that aren't
+//in the trie have node zero
+typedef struct bot_chattrie_s
+{
+	int numnodes;
+	int maxnodes;
+	int scan;									//number of the current scan
+	bot_chattrienode_t *nodes;
+} bot_chattrie_t;
+
 //string list
 typedef struct bot_stringlist_s
 {
@@ -240,6 +264,10 @@ bot_synonymlist_t *synonyms = NULL;
 bot_randomlist_t *randomstrings = NULL;
 //reply chats
 bot_replychat_t *replychats = NULL;
+//trie with all synonyms
+bot_chattrie_t synonymtrie;
+//trie with the strings of the match templates and reply chat keys
+bot_chattrie_t matchtrie;
 
 //========================================================================
 //
@@ -578,10 +606,12 @@ char *StringContainsWord(char *str1, char *str2, int casesensitive)
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-void StringReplaceWords(char *string, char *synonym, char *replacement)
+int StringReplaceWords(char *string, char *synonym, char *replacement)
 {
+	int numreplaced;
 	char *str, *str2;
 
+	numreplaced = 0;
 	//find the synonym in the string
 	str = StringContainsWord(string, synonym, qfalse);
 	//if the synonym occured in the string
@@ -600,10 +630,12 @@ void StringReplaceWords(char *string, char *synonym, char *replacement)
 			memmove(str + strlen(replacement), str+strlen(synonym), strlen(str+strlen(synonym))+1);
 			//append the synonum replacement
 			Com_Memcpy(str, replacement, strlen(replacement));
+			numreplaced++;
 		} //end if
 		//find the next synonym in the string
 		str = StringContainsWord(str+strlen(replacement), synonym, qfalse);
 	} //end if
+	return numreplaced;
 } //end of the function StringReplaceWords
 //===========================================================================
 //
@@ -611,6 +643,214 @@ void StringReplaceWords(char *string, char *synonym, char *replacement)
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
+static ID_INLINE int IsWordSeparator(char c)
+{
+	return (!c || c == ' ' || c == '.' || c == ',' || c == '!');
+} //end of the function IsWordSeparator
+//===========================================================================
+// allocates a trie with room for strings with the given number of characters
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotInitChatTrie(bot_chattrie_t *trie, int numchars)
+{
+	trie->maxnodes = numchars + 1;
+	trie->nodes = (bot_chattrienode_t *) GetClearedMemory(trie->maxnodes * sizeof(bot_chattrienode_t));
+	trie->numnodes = 1;
+	trie->scan = 0;
+} //end of the function BotInitChatTrie
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotFreeChatTrie(bot_chattrie_t *trie)
+{
+	if (trie->nodes) FreeMemory(trie->nodes);
+	Com_Memset(trie, 0, sizeof(bot_chattrie_t));
+} //end of the function BotFreeChatTrie
+//===========================================================================
+// returns the child of the node with the given upper case character
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE int BotChatTrieChild(bot_chattrie_t *trie, int node, int c)
+{
+	int child;
+
+	for (child = trie->nodes[node].firstchild; child; child = trie->nodes[child].sibling)
+	{
+		if (trie->nodes[child].c == c) return child;
+	} //end for
+	return 0;
+} //end of the function BotChatTrieChild
+//===========================================================================
+// adds the string to the trie, case insensitive
+//
+// Parameter:				-
+// Returns:					the node the string ends at, zero if not added
+// Changes Globals:		-
+//===========================================================================
+int BotAddChatTrieString(bot_chattrie_t *trie, char *string)
+{
+	int node, child, c;
+
+	if (!trie->nodes) return 0;
+	node = 0;
+	for (; *string; string++)
+	{
+		c = toupper((unsigned char) *string);
+		child = BotChatTrieChild(trie, node, c);
+		if (!child)
+		{
+			if (trie->numnodes >= trie->maxnodes) return 0;
+			child = trie->numnodes++;
+			trie->nodes[child].c = c;
+			trie->nodes[child].sibling = trie->nodes[node].firstchild;
+			trie->nodes[node].firstchild = child;
+		} //end if
+		node = child;
+	} //end for
+	trie->nodes[node].isstring = qtrue;
+	return node;
+} //end of the function BotAddChatTrieString
+//===========================================================================
+// sets the Aho-Corasick fail and output links after all strings are added
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotLinkChatTrie(bot_chattrie_t *trie)
+{
+	int *queue, head, tail, node, child, fail;
+	bot_chattrienode_t *nodes;
+
+	if (!trie->nodes) return;
+	nodes = trie->nodes;
+	queue = (int *) GetMemory(trie->numnodes * sizeof(int));
+	head = tail = 0;
+	//the nodes below the root fail to the root
+	for (child = nodes[0].firstchild; child; child = nodes[child].sibling)
+	{
+		nodes[child].fail = 0;
+		nodes[child].output = nodes[child].isstring ? child : 0;
+		queue[tail++] = child;
+	} //end for
+	//breadth first so the fail nodes are always done first
+	while (head < tail)
+	{
+		node = queue[head++];
+		for (child = nodes[node].firstchild; child; child = nodes[child].sibling)
+		{
+			fail = nodes[node].fail;
+			while (fail && !BotChatTrieChild(trie, fail, nodes[child].c))
+			{
+				fail = nodes[fail].fail;
+			} //end while
+			nodes[child].fail = BotChatTrieChild(trie, fail, nodes[child].c);
+			nodes[child].output = nodes[child].isstring ? child : nodes[nodes[child].fail].output;
+			queue[tail++] = child;
+		} //end for
+	} //end while
+	FreeMemory(queue);
+} //end of the function BotLinkChatTrie
+//===========================================================================
+// finds all the trie strings that are somewhere in the string in one pass
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotScanChatTrie(bot_chattrie_t *trie, char *string)
+{
+	int node, child, output, c;
+	bot_chattrienode_t *nodes;
+
+	if (!trie->nodes) return;
+	nodes = trie->nodes;
+	trie->scan++;
+	node = 0;
+	for (; *string; string++)
+	{
+		c = toupper((unsigned char) *string);
+		//follow the fail links until the character can be matched
+		while (1)
+		{
+			child = BotChatTrieChild(trie, node, c);
+			if (child || !node) break;
+			node = nodes[node].fail;
+		} //end while
+		node = child;
+		//mark all the strings that end here, if a string is already marked
+		//then so are the strings on its fail chain
+		for (output = nodes[node].output; output && nodes[output].scan != trie->scan;
+					output = nodes[nodes[output].fail].output)
+		{
+			nodes[output].scan = trie->scan;
+		} //end for
+	} //end for
+} //end of the function BotScanChatTrie
+//===========================================================================
+// finds all the trie strings that are words of the string, the same words
+// StringContainsWord finds
+//
+// Parameter:				firstword	: only check the first word
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotScanChatTrieWords(bot_chattrie_t *trie, char *string, int firstword)
+{
+	int node, j;
+	char *str;
+
+	if (!trie->nodes) return;
+	trie->scan++;
+	str = string;
+	while (1)
+	{
+		//walk down the trie from the start of the word
+		for (node = 0, j = 0; ; j++)
+		{
+			if (trie->nodes[node].isstring && IsWordSeparator(str[j]))
+			{
+				trie->nodes[node].scan = trie->scan;
+			} //end if
+			if (!str[j]) break;
+			node = BotChatTrieChild(trie, node, toupper((unsigned char) str[j]));
+			if (!node) break;
+		} //end for
+		if (firstword || !*str) break;
+		//skip to the start of the next word
+		str++;
+		while(*str && *str != ' ' && *str != '.' && *str != ',' && *str != '!') str++;
+		if (!*str) break;
+		str++;
+	} //end while
+} //end of the function BotScanChatTrieWords
+//===========================================================================
+// returns true if the last scan found the string of the node, strings
+// that aren't in the trie are always found
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static ID_INLINE int BotChatTrieFound(bot_chattrie_t *trie, int node)
+{
+	return !node || trie->nodes[node].scan == trie->scan;
+} //end of the function BotChatTrieFound
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
 void BotDumpSynonymList(bot_synonymlist_t *synlist)
 {
 	FILE *fp;
@@ -822,12 +1062,19 @@ void BotReplaceSynonyms(char *string, unsigned long int context)
 	bot_synonymlist_t *syn;
 	bot_synonym_t *synonym;
 
+	//find the synonyms that are words of the string
+	BotScanChatTrieWords(&synonymtrie, string, qfalse);
 	for (syn = synonyms; syn; syn = syn->next)
 	{
 		if (!(syn->context & context)) continue;
 		for (synonym = syn->firstsynonym->next; synonym; synonym = synonym->next)
 		{
-			StringReplaceWords(string, synonym->string, syn->firstsynonym->string);
+			if (!BotChatTrieFound(&synonymtrie, synonym->node)) continue;
+			//if the string changed find the synonyms again
+			if (StringReplaceWords(string, synonym->string, syn->firstsynonym->string))
+			{
+				BotScanChatTrieWords(&synonymtrie, string, qfalse);
+			} //end if
 		} //end for
 	} //end for
 #endif // !IOS
@@ -845,6 +1092,8 @@ void BotReplaceWeightedSynonyms(char *string, unsigned long int context)
 	bot_synonym_t *synonym, *replacement;
 	float weight, curweight;
 
+	//find the synonyms that are words of the string
+	BotScanChatTrieWords(&synonymtrie, string, qfalse);
 	for (syn = synonyms; syn; syn = syn->next)
 	{
 		if (!(syn->context & context)) continue;
@@ -862,7 +1111,12 @@ void BotReplaceWeightedSynonyms(char *string, unsigned long int context)
 		for (synonym = syn->firstsynonym; synonym; synonym = synonym->next)
 		{
 			if (synonym == replacement) continue;
-			StringReplaceWords(string, synonym->string, replacement->string);
+			if (!BotChatTrieFound(&synonymtrie, synonym->node)) continue;
+			//if the string changed find the synonyms again
+			if (StringReplaceWords(string, synonym->string, replacement->string))
+			{
+				BotScanChatTrieWords(&synonymtrie, string, qfalse);
+			} //end if
 		} //end for
 	} //end for
 #endif // !IOS
@@ -885,12 +1139,14 @@ void BotReplaceReplySynonyms(char *string, unsigned long int context)
 		//go to the start of the next word
 		while(*str1 && *str1 <= ' ') str1++;
 		if (!*str1) break;
-		//
+		//find the synonyms at the front of the string
+		BotScanChatTrieWords(&synonymtrie, str1, qtrue);
 		for (syn = synonyms; syn; syn = syn->next)
 		{
 			if (!(syn->context & context)) continue;
 			for (synonym = syn->firstsynonym->next; synonym; synonym = synonym->next)
 			{
+				if (!BotChatTrieFound(&synonymtrie, synonym->node)) continue;
 				//if the synonym is not at the front of the string continue
 				str2 = StringContainsWord(str1, synonym->string, qfalse);
 				if (!str2 || str2 != str1) continue;
@@ -1417,6 +1673,126 @@ bot_matchtemplate_t *BotLoadMatchTemplates(char *matchfile)
 	return matches;
 } //end of the function BotLoadMatchTemplates
 //===========================================================================
+// returns false if the last match trie scan shows the match pieces can't
+// match because a string piece has none of its strings in the message
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+int BotMatchPiecesFound(bot_matchpiece_t *pieces)
+{
+	bot_matchpiece_t *mp;
+	bot_matchstring_t *ms;
+
+	for (mp = pieces; mp; mp = mp->next)
+	{
+		if (mp->type != MT_STRING) continue;
+		for (ms = mp->firststring; ms; ms = ms->next)
+		{
+			if (BotChatTrieFound(&matchtrie, ms->node)) break;
+		} //end for
+		if (!ms) return qfalse;
+	} //end for
+	return qtrue;
+} //end of the function BotMatchPiecesFound
+//===========================================================================
+// adds the strings of the match pieces to the match trie, returns the
+// number of characters when counting
+//
+// Parameter:				count		: only count the characters
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+int BotAddMatchPiecesToTrie(bot_matchpiece_t *pieces, int count)
+{
+	int numchars;
+	bot_matchpiece_t *mp;
+	bot_matchstring_t *ms;
+
+	numchars = 0;
+	for (mp = pieces; mp; mp = mp->next)
+	{
+		if (mp->type != MT_STRING) continue;
+		for (ms = mp->firststring; ms; ms = ms->next)
+		{
+			if (count) numchars += strlen(ms->string);
+			else ms->node = BotAddChatTrieString(&matchtrie, ms->string);
+		} //end for
+	} //end for
+	return numchars;
+} //end of the function BotAddMatchPiecesToTrie
+//===========================================================================
+// builds the match trie with the strings of the match templates and the
+// reply chat keys, the first pass counts the characters
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotBuildMatchTrie(void)
+{
+	int pass, numchars;
+	bot_matchtemplate_t *mt;
+	bot_replychat_t *rchat;
+	bot_replychatkey_t *key;
+
+	BotFreeChatTrie(&matchtrie);
+	numchars = 0;
+	for (pass = 0; pass < 2; pass++)
+	{
+		if (pass) BotInitChatTrie(&matchtrie, numchars);
+		for (mt = matchtemplates; mt; mt = mt->next)
+		{
+			numchars += BotAddMatchPiecesToTrie(mt->first, !pass);
+		} //end for
+		for (rchat = replychats; rchat; rchat = rchat->next)
+		{
+			for (key = rchat->keys; key; key = key->next)
+			{
+				if (key->flags & RCKFL_VARIABLES)
+				{
+					numchars += BotAddMatchPiecesToTrie(key->match, !pass);
+				} //end if
+				else if ((key->flags & RCKFL_STRING) && !(key->flags & (RCKFL_NAME|RCKFL_BOTNAMES)))
+				{
+					if (!pass) numchars += strlen(key->string);
+					else key->node = BotAddChatTrieString(&matchtrie, key->string);
+				} //end else if
+			} //end for
+		} //end for
+	} //end for
+	BotLinkChatTrie(&matchtrie);
+} //end of the function BotBuildMatchTrie
+//===========================================================================
+// builds the synonym trie, the first pass counts the characters
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotBuildSynonymTrie(void)
+{
+	int pass, numchars;
+	bot_synonymlist_t *syn;
+	bot_synonym_t *synonym;
+
+	BotFreeChatTrie(&synonymtrie);
+	numchars = 0;
+	for (pass = 0; pass < 2; pass++)
+	{
+		if (pass) BotInitChatTrie(&synonymtrie, numchars);
+		for (syn = synonyms; syn; syn = syn->next)
+		{
+			for (synonym = syn->firstsynonym; synonym; synonym = synonym->next)
+			{
+				if (!pass) numchars += strlen(synonym->string);
+				else synonym->node = BotAddChatTrieString(&synonymtrie, synonym->string);
+			} //end for
+		} //end for
+	} //end for
+} //end of the function BotBuildSynonymTrie
+//===========================================================================
 //
 // Parameter:				-
 // Returns:					-
@@ -1511,10 +1887,13 @@ int BotFindMatch(char *str, bot_match_t *match, unsigned long int context)
 	{
 		match->string[strlen(match->string)-1] = '\0';
 	} //end while
+	//find the match strings that are in the string
+	BotScanChatTrie(&matchtrie, match->string);
 	//compare the string with all the match strings
 	for (ms = matchtemplates; ms; ms = ms->next)
 	{
 		if (!(ms->context & context)) continue;
+		if (!BotMatchPiecesFound(ms->first)) continue;
 		//reset the match variable offsets
 		for (i = 0; i < MAX_MATCHVARIABLES; i++) match->variables[i].offset = -1;
 		//
@@ -2693,6 +3072,8 @@ int BotReplyChat(int chatstate, char *message, int mcontext, int vcontext, char
 	if (!cs) return qfalse;
 	Com_Memset(&match, 0, sizeof(bot_match_t));
 	strcpy(match.string, message);
+	//find the match strings and keys that are in the message
+	BotScanChatTrie(&matchtrie, message);
 	bestpriority = -1;
 	bestchatmessage = NULL;
 	bestrchat = NULL;
@@ -2709,8 +3090,9 @@ int BotReplyChat(int chatstate, char *message, int mcontext, int vcontext, char
 			else if (key->flags & RCKFL_GENDERFEMALE) res = (cs->gender == CHAT_GENDERFEMALE);
 			else if (key->flags & RCKFL_GENDERMALE) res = (cs->gender == CHAT_GENDERMALE);
 			else if (key->flags & RCKFL_GENDERLESS) res = (cs->gender == CHAT_GENDERLESS);
-			else if (key->flags & RCKFL_VARIABLES) res = StringsMatch(key->match, &match);
-			else if (key->flags & RCKFL_STRING) res = (StringContainsWord(message, key->string, qfalse) != NULL);
+			else if (key->flags & RCKFL_VARIABLES) res = BotMatchPiecesFound(key->match) && StringsMatch(key->match, &match);
+			else if (key->flags & RCKFL_STRING) res = BotChatTrieFound(&matchtrie, key->node) &&
+														(StringContainsWord(message, key->string, qfalse) != NULL);
 			//if the key must be present
 			if (key->flags & RCKFL_AND)
 			{
@@ -3034,6 +3416,9 @@ int BotSetupChatAI(void)
 		file = LibVarString("rchatfile", "rchat.c");
 		replychats = BotLoadReplyChat(file);
 	} //end if
+	//compile the synonyms and match strings for fast console message matching
+	BotBuildSynonymTrie();
+	BotBuildMatchTrie();
 
 	InitConsoleMessageHeap();
 
@@ -3080,4 +3465,6 @@ void BotShutdownChatAI(void)
 	synonyms = NULL;
 	if (replychats) BotFreeReplyChat(replychats);
 	replychats = NULL;
+	BotFreeChatTrie(&synonymtrie);
+	BotFreeChatTrie(&matchtrie);
 } //end of the function BotShutdownChatAI
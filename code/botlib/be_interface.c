@@ -296,6 +296,18 @@ int Export_BotLibUpdateEntity(int ent, bot_entitystate_t *state)
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
+int Export_BotLibUpdateEntities(int *entnums, bot_entitystate_t *states, int numentities)
+{
+	if (!BotLibSetup("BotUpdateEntities")) return BLERR_LIBRARYNOTSETUP;
+
+	return AAS_UpdateEntities(entnums, states, numentities);
+} //end of the function Export_BotLibUpdateEntities
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
 void Export_AAS_TraceClientBBox(struct aas_trace_s *trace, vec3_t start, vec3_t end, int presencetype, int passent)
 {
 	aas_trace_t tr;
@@ -725,6 +737,7 @@ static void Init_AAS_Export( aas_export_t *aas ) {
 	aas->AAS_AreaTravelTime = AAS_AreaTravelTime;
 	aas->AAS_AreaTravelTimeToGoalArea = AAS_AreaTravelTimeToGoalArea;
 	aas->AAS_PredictRoute = AAS_PredictRoute;
+	aas->AAS_PrepareRoutes = AAS_PrepareRoutes;
 	//--------------------------------------------
 	// be_aas_altroute.c
 	//--------------------------------------------
@@ -824,6 +837,7 @@ botlib_export_t *GetBotLibAPI(int apiVersion, botlib_import_t *import) {
 	be_botlib_export.BotLibStartFrame = Export_BotLibStartFrame;
 	be_botlib_export.BotLibLoadMap = Export_BotLibLoadMap;
 	be_botlib_export.BotLibUpdateEntity = Export_BotLibUpdateEntity;
+	be_botlib_export.BotLibUpdateEntities = Export_BotLibUpdateEntities;
 	be_botlib_export.Test = BotExportTest;
 
 	return &be_botlib_export;
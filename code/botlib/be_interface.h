@@ -62,4 +62,5 @@ extern int botDeveloper;					//true if developer is on
 
 //
 int Sys_MilliSeconds(void);
+int64_t Sys_Microseconds(void);
 
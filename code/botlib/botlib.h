@@ -37,12 +37,13 @@ Suite 120, Rockville, Maryland 20850 USA.
  *
  *****************************************************************************/
 
-#define	BOTLIB_API_VERSION		3
+#define	BOTLIB_API_VERSION		6
 
 struct aas_clientmove_s;
 struct aas_areainfo_s;
 struct aas_trace_s;
 struct aas_altroutegoal_s;
+struct aas_routequery_s;
 struct aas_reachability_s;
 struct aas_predictroute_s;
 struct bot_consolemessage_s;
@@ -155,12 +156,22 @@ typedef struct botlib_import_s
 	void		(*FreeMemory)(void *ptr);		// free memory from Zone
 	int			(*AvailableMemory)(void);		// available Zone memory
 	void		*(*HunkAlloc)(int size);		// allocate from hunk
+	//worker threads
+	int			(*NumJobThreads)(void);
+	void		(*AddJob)(void (*function)(void *data), void *data, int *counter);
+	void		(*WaitJobs)(int *counter);	// wait for the jobs added with counter
+	void		*(*CreateMutex)(void);
+	void		(*DestroyMutex)(void *mutex);
+	void		(*LockMutex)(void *mutex);
+	void		(*UnlockMutex)(void *mutex);
 	//file system access
 	int			(*FS_FOpenFile)( const char *qpath, fileHandle_t *file, fsMode_t mode );
 	int			(*FS_Read)( void *buffer, int len, fileHandle_t f );
 	int			(*FS_Write)( const void *buffer, int len, fileHandle_t f );
 	void		(*FS_FCloseFile)( fileHandle_t f );
 	int			(*FS_Seek)( fileHandle_t f, long offset, int origin );
+	long		(*FS_MapFile)( const char *qpath, void **buffer );
+	void		(*FS_UnmapFile)( void *buffer );
 	//debug visualisation stuff
 	int			(*DebugLineCreate)(void);
 	void		(*DebugLineDelete)(int line);
@@ -228,6 +239,7 @@ typedef struct aas_export_s
 	int			(*AAS_PredictRoute)(struct aas_predictroute_s *route, int areanum, vec3_t origin,
 							int goalareanum, int travelflags, int maxareas, int maxtime,
 							int stopevent, int stopcontents, int stoptfl, int stopareanum);
+	int			(*AAS_PrepareRoutes)(struct aas_routequery_s *queries, int numqueries);
 	//--------------------------------------------
 	// be_aas_altroute.c
 	//--------------------------------------------
@@ -324,6 +336,8 @@ typedef struct botlib_export_s
 	int (*BotLibLoadMap)(const char *mapname);
 	//entity updates
 	int (*BotLibUpdateEntity)(int ent, bot_entitystate_t *state);
+	//updates the listed entities in ascending order and unlinks all others
+	int (*BotLibUpdateEntities)(int *entnums, bot_entitystate_t *states, int numentities);
 	//just for testing
 	int (*Test)(int parm0, char *parm1, vec3_t parm2, vec3_t parm3);
 } botlib_export_t;
@@ -68,6 +68,7 @@ typedef enum {qfalse, qtrue}	qboolean;
 #include "l_script.h"
 #include "l_precomp.h"
 #include "l_log.h"
+#include "l_libvar.h"
 #endif //BOTLIB
 
 #ifdef MEQCC
@@ -127,6 +128,58 @@ token_t *freetokens;					//free tokens from the heap
 //list with global defines added to every source loaded
 define_t *globaldefines;
 
+#ifdef BOTLIB
+//maximum number of scripts, the source and its includes, of a precompiled source
+#define MAX_SOURCECACHESCRIPTS	8
+//initial hash value
+#define SOURCECACHE_HASHINIT	2166136261u
+
+//script a precompiled source was read from
+typedef struct sourcecachescript_s
+{
+	char filename[MAX_PATH];				//file name of the script
+	int length;								//length of the script in bytes
+	unsigned int hash;						//hash of the script contents
+} sourcecachescript_t;
+
+//token of a precompiled source, followed by the token string
+typedef struct sourcecachetoken_s
+{
+	int type;								//token type
+	int subtype;							//token sub type
+#ifdef NUMBERVALUE
+	unsigned long int intvalue;				//integer value
+	float floatvalue;						//floating point value
+#endif //NUMBERVALUE
+	int line;								//line the token was on
+	int scriptline;							//line in the script after reading the token
+	int script;								//script the token was read from
+	int length;								//length of the token string
+} sourcecachetoken_t;
+
+//tokenized and macro expanded source
+typedef struct sourcecache_s
+{
+	unsigned int definehash;				//hash of the global defines
+	int numscripts;							//number of scripts read
+	sourcecachescript_t scripts[MAX_SOURCECACHESCRIPTS];	//the source and included scripts
+	int size;								//size of the token buffer in bytes
+	int maxsize;							//allocated size of the token buffer
+	char *buffer;							//precompiled tokens
+	int endline;							//last line in the source
+	int refs;								//number of sources reading the tokens
+	int lastused;							//last time the tokens were used
+	struct sourcecache_s *next;				//next precompiled source
+} sourcecache_t;
+
+//precompiled sources, these are kept when the bot library is shut down
+sourcecache_t *sourcecache;
+//size of all precompiled tokens
+int sourcecachesize;
+//counter used to find the least recently used precompiled source
+int sourcecachetime;
+#endif //BOTLIB
+
 //============================================================================
 //
 // Parameter:				-
@@ -138,6 +191,9 @@ void QDECL SourceError(source_t *source, char *str, ...)
 	char text[1024];
 	va_list ap;
 
+	source->numerrors++;
+	if (source->quiet) return;
+
 	va_start(ap, str);
 	Q_vsnprintf(text, sizeof(text), str, ap);
 	va_end(ap);
@@ -162,6 +218,9 @@ void QDECL SourceWarning(source_t *source, char *str, ...)
 	char text[1024];
 	va_list ap;
 
+	source->numerrors++;
+	if (source->quiet) return;
+
 	va_start(ap, str);
 	Q_vsnprintf(text, sizeof(text), str, ap);
 	va_end(ap);
@@ -219,6 +278,51 @@ void PC_PopIndent(source_t *source, int *type, int *skip)
 	FreeMemory(indent);
 } //end of the function PC_PopIndent
 //============================================================================
+// FNV-1a hash used to identify precompiled sources
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+#ifdef BOTLIB
+unsigned int PC_HashBuffer(unsigned int hash, const void *data, int length)
+{
+	const unsigned char *ptr;
+	int i;
+
+	ptr = (const unsigned char *) data;
+	for (i = 0; i < length; i++)
+	{
+		hash ^= ptr[i];
+		hash *= 16777619u;
+	} //end for
+	return hash;
+} //end of the function PC_HashBuffer
+//============================================================================
+// adds the script to the scripts the precompiled source is read from
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+void PC_AddSourceCacheScript(source_t *source, script_t *script)
+{
+	sourcecache_t *cache;
+	sourcecachescript_t *cs;
+
+	cache = source->record;
+	if (cache->numscripts >= MAX_SOURCECACHESCRIPTS || strlen(script->filename) >= MAX_PATH)
+	{
+		source->nocache = qtrue;
+		return;
+	} //end if
+	cs = &cache->scripts[cache->numscripts++];
+	strcpy(cs->filename, script->filename);
+	cs->length = script->length;
+	cs->hash = PC_HashBuffer(SOURCECACHE_HASHINIT, script->buffer, script->length);
+} //end of the function PC_AddSourceCacheScript
+#endif //BOTLIB
+//============================================================================
 //
 // Parameter:				-
 // Returns:					-
@@ -236,6 +340,11 @@ void PC_PushScript(source_t *source, script_t *script)
 			return;
 		} //end if
 	} //end for
+#ifdef BOTLIB
+	//the errors are printed when the source is read without precompiling
+	if (source->quiet) script->flags |= SCFL_NOERRORS | SCFL_NOWARNINGS;
+	if (source->record) PC_AddSourceCacheScript(source, script);
+#endif //BOTLIB
 	//push the script on the script stack
 	script->next = source->scriptstack;
 	source->scriptstack = script;
@@ -336,6 +445,7 @@ int PC_ReadSourceToken(source_t *source, token_t *token)
 		//remove the script and return to the last one
 		script = source->scriptstack;
 		source->scriptstack = source->scriptstack->next;
+		source->numerrors += script->numerrors;
 		FreeScript(script);
 	} //end while
 	//copy the already available token
@@ -362,6 +472,64 @@ int PC_UnreadSourceToken(source_t *source, token_t *token)
 	return qtrue;
 } //end of the function PC_UnreadSourceToken
 //============================================================================
+// reads the next token of a precompiled source
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+#ifdef BOTLIB
+int PC_ReadCachedToken(source_t *source, token_t *token)
+{
+	sourcecache_t *cache;
+	sourcecachetoken_t ct;
+	token_t *t;
+	char *ptr;
+
+	//if there's a token already available
+	if (source->tokens)
+	{
+		Com_Memcpy(token, source->tokens, sizeof(token_t));
+		t = source->tokens;
+		source->tokens = source->tokens->next;
+		PC_FreeToken(t);
+	} //end if
+	else
+	{
+		cache = source->cache;
+		if (source->cacheoffset >= cache->size)
+		{
+			source->scriptstack->line = cache->endline;
+			return qfalse;
+		} //end if
+		ptr = cache->buffer + source->cacheoffset;
+		Com_Memcpy(&ct, ptr, sizeof(sourcecachetoken_t));
+		Com_Memcpy(token->string, ptr + sizeof(sourcecachetoken_t), ct.length + 1);
+		source->cacheoffset += sizeof(sourcecachetoken_t) + ct.length + 1;
+		token->type = ct.type;
+		token->subtype = ct.subtype;
+#ifdef NUMBERVALUE
+		token->intvalue = ct.intvalue;
+		token->floatvalue = ct.floatvalue;
+#endif //NUMBERVALUE
+		token->whitespace_p = NULL;
+		token->endwhitespace_p = NULL;
+		token->line = ct.line;
+		token->linescrossed = 0;
+		token->next = NULL;
+		//keep the script file and line up to date for error messages
+		if (strcmp(source->scriptstack->filename, cache->scripts[ct.script].filename))
+		{
+			strcpy(source->scriptstack->filename, cache->scripts[ct.script].filename);
+		} //end if
+		source->scriptstack->line = ct.scriptline;
+	} //end else
+	//copy token for unreading
+	Com_Memcpy(&source->token, token, sizeof(token_t));
+	return qtrue;
+} //end of the function PC_ReadCachedToken
+#endif //BOTLIB
+//============================================================================
 //
 // Parameter:				-
 // Returns:					-
@@ -744,6 +912,7 @@ int PC_ExpandBuiltinDefine(source_t *source, token_t *deftoken, define_t *define
 		} //end case
 		case BUILTIN_DATE:
 		{
+			source->nocache = qtrue;
 			t = time(NULL);
 			curtime = ctime(&t);
 			strcpy(token->string, "\"");
@@ -759,6 +928,7 @@ int PC_ExpandBuiltinDefine(source_t *source, token_t *deftoken, define_t *define
 		} //end case
 		case BUILTIN_TIME:
 		{
+			source->nocache = qtrue;
 			t = time(NULL);
 			curtime = ctime(&t);
 			strcpy(token->string, "\"");
@@ -2712,6 +2882,10 @@ int PC_ReadToken(source_t *source, token_t *token)
 {
 	define_t *define;
 
+#ifdef BOTLIB
+	//if the source was precompiled before
+	if (source->cache) return PC_ReadCachedToken(source, token);
+#endif //BOTLIB
 	while(1)
 	{
 		if (!PC_ReadSourceToken(source, token)) return qfalse;
@@ -2981,27 +3155,22 @@ void PC_SetPunctuations(source_t *source, punctuation_t *p)
 	source->punctuations = p;
 } //end of the function PC_SetPunctuations
 //============================================================================
+// creates a source reading the given script
 //
-// Parameter:			-
-// Returns:				-
+// Parameter:				-
+// Returns:					-
 // Changes Globals:		-
 //============================================================================
-source_t *LoadSourceFile(const char *filename)
+source_t *PC_SourceFromScript(script_t *script, const char *name)
 {
 	source_t *source;
-	script_t *script;
-
-	PC_InitTokenHeap();
-
-	script = LoadScriptFile(filename);
-	if (!script) return NULL;
 
 	script->next = NULL;
 
 	source = (source_t *) GetMemory(sizeof(source_t));
 	Com_Memset(source, 0, sizeof(source_t));
 
-	strncpy(source->filename, filename, MAX_PATH);
+	strncpy(source->filename, name, MAX_PATH);
 	source->scriptstack = script;
 	source->tokens = NULL;
 	source->defines = NULL;
@@ -3013,39 +3182,277 @@ source_t *LoadSourceFile(const char *filename)
 #endif //DEFINEHASHING
 	PC_AddGlobalDefinesToSource(source);
 	return source;
-} //end of the function LoadSourceFile
+} //end of the function PC_SourceFromScript
+#ifdef BOTLIB
 //============================================================================
+// returns a hash of the global defines, these change the precompiled tokens
 //
 // Parameter:				-
 // Returns:					-
 // Changes Globals:		-
 //============================================================================
-source_t *LoadSourceMemory(char *ptr, int length, char *name)
+unsigned int PC_GlobalDefinesHash(void)
+{
+	unsigned int hash;
+	define_t *define;
+	token_t *token;
+
+	hash = SOURCECACHE_HASHINIT;
+	for (define = globaldefines; define; define = define->next)
+	{
+		hash = PC_HashBuffer(hash, define->name, strlen(define->name) + 1);
+		hash = PC_HashBuffer(hash, &define->numparms, sizeof(int));
+		for (token = define->parms; token; token = token->next)
+		{
+			hash = PC_HashBuffer(hash, token->string, strlen(token->string) + 1);
+		} //end for
+		for (token = define->tokens; token; token = token->next)
+		{
+			hash = PC_HashBuffer(hash, token->string, strlen(token->string) + 1);
+		} //end for
+	} //end for
+	return hash;
+} //end of the function PC_GlobalDefinesHash
+//============================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+void PC_FreeSourceCache(sourcecache_t *cache)
+{
+	if (cache->buffer) FreeMemory(cache->buffer);
+	FreeMemory(cache);
+} //end of the function PC_FreeSourceCache
+//============================================================================
+// appends the token to the precompiled tokens
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+void PC_AddSourceCacheToken(source_t *source, sourcecache_t *cache, token_t *token)
+{
+	sourcecachetoken_t ct;
+	char *buffer;
+	int size, i;
+
+	Com_Memset(&ct, 0, sizeof(sourcecachetoken_t));
+	ct.type = token->type;
+	ct.subtype = token->subtype;
+#ifdef NUMBERVALUE
+	ct.intvalue = token->intvalue;
+	ct.floatvalue = token->floatvalue;
+#endif //NUMBERVALUE
+	ct.line = token->line;
+	ct.scriptline = source->scriptstack->line;
+	ct.length = strlen(token->string);
+	//find the script the token was read from
+	for (i = 0; i < cache->numscripts; i++)
+	{
+		if (!strcmp(cache->scripts[i].filename, source->scriptstack->filename)) break;
+	} //end for
+	if (i >= cache->numscripts) i = 0;
+	ct.script = i;
+	//grow the token buffer
+	size = sizeof(sourcecachetoken_t) + ct.length + 1;
+	if (cache->size + size > cache->maxsize)
+	{
+		cache->maxsize = (cache->maxsize + size) * 2;
+		buffer = (char *) GetMemory(cache->maxsize);
+		if (cache->buffer)
+		{
+			Com_Memcpy(buffer, cache->buffer, cache->size);
+			FreeMemory(cache->buffer);
+		} //end if
+		cache->buffer = buffer;
+	} //end if
+	Com_Memcpy(cache->buffer + cache->size, &ct, sizeof(sourcecachetoken_t));
+	Com_Memcpy(cache->buffer + cache->size + sizeof(sourcecachetoken_t), token->string, ct.length + 1);
+	cache->size += size;
+} //end of the function PC_AddSourceCacheToken
+//============================================================================
+// reads the whole script with macro expansion and stores the tokens,
+// returns NULL if there were errors or warnings
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+sourcecache_t *PC_PrecompileSource(script_t *script, unsigned int hash, unsigned int definehash)
+{
+	source_t *source;
+	script_t *copy, *s;
+	sourcecache_t *cache;
+	token_t token;
+	int numerrors;
+
+	cache = (sourcecache_t *) GetClearedMemory(sizeof(sourcecache_t));
+	cache->definehash = definehash;
+	strcpy(cache->scripts[0].filename, script->filename);
+	cache->scripts[0].length = script->length;
+	cache->scripts[0].hash = hash;
+	cache->numscripts = 1;
+	//read a copy of the script without printing errors
+	copy = LoadScriptMemory(script->buffer, script->length, script->filename);
+	copy->flags |= SCFL_NOERRORS | SCFL_NOWARNINGS;
+	source = PC_SourceFromScript(copy, script->filename);
+	source->quiet = qtrue;
+	source->record = cache;
+	while(PC_ReadToken(source, &token))
+	{
+		PC_AddSourceCacheToken(source, cache, &token);
+	} //end while
+	cache->endline = source->scriptstack->line;
+	numerrors = source->numerrors;
+	for (s = source->scriptstack; s; s = s->next) numerrors += s->numerrors;
+	if (numerrors || source->nocache)
+	{
+		PC_FreeSourceCache(cache);
+		cache = NULL;
+	} //end if
+	FreeSource(source);
+	return cache;
+} //end of the function PC_PrecompileSource
+//============================================================================
+// finds a precompiled source with the same script contents, included
+// script contents and global defines
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+sourcecache_t *PC_FindSourceCache(script_t *script, unsigned int hash, unsigned int definehash)
+{
+	sourcecache_t *cache;
+	script_t *include;
+	int i, valid;
+
+	for (cache = sourcecache; cache; cache = cache->next)
+	{
+		if (cache->definehash != definehash) continue;
+		if (cache->scripts[0].hash != hash) continue;
+		if (cache->scripts[0].length != script->length) continue;
+		if (strcmp(cache->scripts[0].filename, script->filename)) continue;
+		//the included scripts must not have changed either
+		valid = qtrue;
+		for (i = 1; i < cache->numscripts && valid; i++)
+		{
+			include = LoadScriptFile(cache->scripts[i].filename);
+			valid = (include && include->length == cache->scripts[i].length &&
+						PC_HashBuffer(SOURCECACHE_HASHINIT, include->buffer, include->length) == cache->scripts[i].hash);
+			if (include) FreeScript(include);
+		} //end for
+		if (valid) return cache;
+	} //end for
+	return NULL;
+} //end of the function PC_FindSourceCache
+//============================================================================
+// frees the least recently used precompiled sources until the cache fits
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+void PC_TrimSourceCache(int maxsize)
+{
+	sourcecache_t *cache, **prev, **oldest;
+
+	while(sourcecachesize > maxsize)
+	{
+		oldest = NULL;
+		for (prev = &sourcecache; *prev; prev = &(*prev)->next)
+		{
+			if ((*prev)->refs) continue;
+			if (!oldest || (*prev)->lastused < (*oldest)->lastused) oldest = prev;
+		} //end for
+		if (!oldest) break;
+		cache = *oldest;
+		*oldest = cache->next;
+		sourcecachesize -= cache->maxsize;
+		PC_FreeSourceCache(cache);
+	} //end while
+} //end of the function PC_TrimSourceCache
+//============================================================================
+// makes the source read precompiled tokens, the source is precompiled if
+// it wasn't before
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+void PC_SetSourceCache(source_t *source)
+{
+	sourcecache_t *cache;
+	script_t *script;
+	unsigned int hash, definehash;
+	int maxsize;
+
+	maxsize = LibVarValue("sourcecachesize", "1024") * 1024;
+	if (maxsize <= 0) return;
+	script = source->scriptstack;
+	hash = PC_HashBuffer(SOURCECACHE_HASHINIT, script->buffer, script->length);
+	definehash = PC_GlobalDefinesHash();
+	cache = PC_FindSourceCache(script, hash, definehash);
+	if (!cache)
+	{
+		cache = PC_PrecompileSource(script, hash, definehash);
+		if (!cache) return;
+		if (cache->maxsize > maxsize)
+		{
+			PC_FreeSourceCache(cache);
+			return;
+		} //end if
+		cache->next = sourcecache;
+		sourcecache = cache;
+		sourcecachesize += cache->maxsize;
+	} //end if
+	cache->refs++;
+	cache->lastused = ++sourcecachetime;
+	source->cache = cache;
+	source->cacheoffset = 0;
+	PC_TrimSourceCache(maxsize);
+} //end of the function PC_SetSourceCache
+#endif //BOTLIB
+//============================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//============================================================================
+source_t *LoadSourceFile(const char *filename)
 {
 	source_t *source;
 	script_t *script;
 
 	PC_InitTokenHeap();
 
-	script = LoadScriptMemory(ptr, length, name);
+	script = LoadScriptFile(filename);
 	if (!script) return NULL;
-	script->next = NULL;
 
-	source = (source_t *) GetMemory(sizeof(source_t));
-	Com_Memset(source, 0, sizeof(source_t));
+	source = PC_SourceFromScript(script, filename);
+#ifdef BOTLIB
+	//read the tokens precompiled before if the file didn't change
+	PC_SetSourceCache(source);
+#endif //BOTLIB
+	return source;
+} //end of the function LoadSourceFile
+//============================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+source_t *LoadSourceMemory(char *ptr, int length, char *name)
+{
+	script_t *script;
 
-	strncpy(source->filename, name, MAX_PATH);
-	source->scriptstack = script;
-	source->tokens = NULL;
-	source->defines = NULL;
-	source->indentstack = NULL;
-	source->skip = 0;
+	PC_InitTokenHeap();
 
-#if DEFINEHASHING
-	source->definehash = GetClearedMemory(DEFINEHASHSIZE * sizeof(define_t *));
-#endif //DEFINEHASHING
-	PC_AddGlobalDefinesToSource(source);
-	return source;
+	script = LoadScriptMemory(ptr, length, name);
+	if (!script) return NULL;
+
+	return PC_SourceFromScript(script, name);
 } //end of the function LoadSourceMemory
 //============================================================================
 //
@@ -3062,6 +3469,9 @@ void FreeSource(source_t *source)
 	int i;
 
 	//PC_PrintDefineHashTable(source->definehash);
+#ifdef BOTLIB
+	if (source->cache) source->cache->refs--;
+#endif //BOTLIB
 	//free all the scripts
 	while(source->scriptstack)
 	{
@@ -112,6 +112,12 @@ typedef struct source_s
 	indent_t *indentstack;					//stack with indents
 	int skip;								// > 0 if skipping conditional code
 	token_t token;							//last read token
+	int numerrors;							//number of errors and warnings
+	int quiet;								//don't print errors and warnings
+	int nocache;							//true if the tokens can't be cached
+	struct sourcecache_s *cache;			//precompiled tokens to read
+	int cacheoffset;						//offset of the next precompiled token
+	struct sourcecache_s *record;			//precompiled source to add included scripts to
 } source_t;
 
 
@@ -242,6 +242,7 @@ void QDECL ScriptError(script_t *script, char *str, ...)
 	char text[1024];
 	va_list ap;
 
+	script->numerrors++;
 	if (script->flags & SCFL_NOERRORS) return;
 
 	va_start(ap, str);
@@ -268,6 +269,7 @@ void QDECL ScriptWarning(script_t *script, char *str, ...)
 	char text[1024];
 	va_list ap;
 
+	script->numerrors++;
 	if (script->flags & SCFL_NOWARNINGS) return;
 
 	va_start(ap, str);
@@ -193,6 +193,7 @@ typedef struct script_s
 	int lastline;					//line before reading token
 	int tokenavailable;				//set by UnreadLastToken
 	int flags;						//several script flags
+	int numerrors;					//number of errors and warnings
 	punctuation_t *punctuations;	//the punctuations used in the script
 	punctuation_t **punctuationtable;
 	token_t token;					//available token
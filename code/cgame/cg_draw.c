@@ -2181,7 +2181,6 @@ static void CG_DrawCrosshair3D(void)
 	trace_t trace;
 	vec3_t endpos;
 	float stereoSep, zProj, maxdist, xmax;
-	char rendererinfos[128];
 	refEntity_t ent;
 
 	if ( !cg_drawCrosshair.integer ) {
@@ -2218,10 +2217,8 @@ static void CG_DrawCrosshair3D(void)
 	// We are going to trace to the next shootable object and place the crosshair in front of it.
 
 	// first get all the important renderer information
-	trap_Cvar_VariableStringBuffer("r_zProj", rendererinfos, sizeof(rendererinfos));
-	zProj = atof(rendererinfos);
-	trap_Cvar_VariableStringBuffer("r_stereoSeparation", rendererinfos, sizeof(rendererinfos));
-	stereoSep = zProj / atof(rendererinfos);
+	zProj = cg_zProj.value;
+	stereoSep = zProj / cg_stereoSeparation.value;
 	
 	xmax = zProj * tan(cg.refdef.fov_x * M_PI / 360.0f);
 	
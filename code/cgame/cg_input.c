@@ -616,30 +616,30 @@ CG_UpdateInputCvars
 void CG_UpdateInputCvars( void ) {
 	int i;
 
-	trap_Cvar_Update( &cg_freelook );
+	CG_UpdateChangedCvar( &cg_freelook );
 
-	trap_Cvar_Update( &m_pitch );
-	trap_Cvar_Update( &m_yaw );
-	trap_Cvar_Update( &m_forward );
-	trap_Cvar_Update( &m_side );
+	CG_UpdateChangedCvar( &m_pitch );
+	CG_UpdateChangedCvar( &m_yaw );
+	CG_UpdateChangedCvar( &m_forward );
+	CG_UpdateChangedCvar( &m_side );
 
 	for (i = 0; i < CG_MaxSplitView(); i++) {
-		trap_Cvar_Update( &cg_yawspeed[i] );
-		trap_Cvar_Update( &cg_pitchspeed[i] );
-		trap_Cvar_Update( &cg_anglespeedkey[i] );
-		trap_Cvar_Update( &cg_run[i] );
-
-		trap_Cvar_Update( &j_pitch[i] );
-		trap_Cvar_Update( &j_yaw[i] );
-		trap_Cvar_Update( &j_forward[i] );
-		trap_Cvar_Update( &j_side[i] );
-		trap_Cvar_Update( &j_up[i] );
-
-		trap_Cvar_Update( &j_pitch_axis[i] );
-		trap_Cvar_Update( &j_yaw_axis[i] );
-		trap_Cvar_Update( &j_forward_axis[i] );
-		trap_Cvar_Update( &j_side_axis[i] );
-		trap_Cvar_Update( &j_up_axis[i] );
+		CG_UpdateChangedCvar( &cg_yawspeed[i] );
+		CG_UpdateChangedCvar( &cg_pitchspeed[i] );
+		CG_UpdateChangedCvar( &cg_anglespeedkey[i] );
+		CG_UpdateChangedCvar( &cg_run[i] );
+
+		CG_UpdateChangedCvar( &j_pitch[i] );
+		CG_UpdateChangedCvar( &j_yaw[i] );
+		CG_UpdateChangedCvar( &j_forward[i] );
+		CG_UpdateChangedCvar( &j_side[i] );
+		CG_UpdateChangedCvar( &j_up[i] );
+
+		CG_UpdateChangedCvar( &j_pitch_axis[i] );
+		CG_UpdateChangedCvar( &j_yaw_axis[i] );
+		CG_UpdateChangedCvar( &j_forward_axis[i] );
+		CG_UpdateChangedCvar( &j_side_axis[i] );
+		CG_UpdateChangedCvar( &j_up_axis[i] );
 	}
 }
 
@@ -1237,6 +1237,8 @@ extern	vmCvar_t		con_conspeed;
 extern	vmCvar_t		con_autochat;
 extern	vmCvar_t		con_autoclear;
 extern	vmCvar_t		cg_dedicated;
+extern	vmCvar_t		cg_zProj;
+extern	vmCvar_t		cg_stereoSeparation;
 
 extern	vmCvar_t		cg_centertime;
 extern	vmCvar_t		cg_runpitch;
@@ -1387,6 +1389,7 @@ void CG_LocalClientRemoved(int localClientNum);
 void CG_StartMusic( void );
 
 void CG_UpdateCvars( void );
+void CG_UpdateChangedCvar( vmCvar_t *vmCvar );
 
 int CG_CrosshairPlayer( int localClientNum );
 int CG_LastAttacker( int localClientNum );
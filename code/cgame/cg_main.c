@@ -141,6 +141,8 @@ vmCvar_t	con_conspeed;
 vmCvar_t	con_autochat;
 vmCvar_t	con_autoclear;
 vmCvar_t	cg_dedicated;
+vmCvar_t	cg_zProj;
+vmCvar_t	cg_stereoSeparation;
 
 vmCvar_t	cg_railTrailTime;
 vmCvar_t	cg_centertime;
@@ -303,6 +305,8 @@ static cvarTable_t cgameCvarTable[] = {
 	{ &con_autochat, "con_autochat", "0", CVAR_ARCHIVE, RANGE_ALL },
 	{ &con_autoclear, "con_autoclear", "0", CVAR_ARCHIVE, RANGE_ALL },
 	{ &cg_dedicated, "dedicated", "0", 0, RANGE_ALL },
+	{ &cg_zProj, "r_zProj", "64", 0, RANGE_ALL },
+	{ &cg_stereoSeparation, "r_stereoSeparation", "64", 0, RANGE_ALL },
 
 	{ &cg_ignore, "cg_ignore", "0", 0, RANGE_ALL },	// used for debugging
 	{ &cg_zoomFov, "cg_zoomfov", "22.5", CVAR_ARCHIVE, RANGE_FLOAT(1, 160) },
@@ -578,6 +582,23 @@ static void CG_ForceModelChange( void ) {
 	}
 }
 
+// handles of the cvars that changed before this frame, -1 for all of them
+static int	cvarSyncHandles[MAX_CVAR_SYNC_HANDLES];
+static int	numCvarSyncHandles;
+
+/*
+=================
+CG_UpdateChangedCvar
+
+Only calls trap_Cvar_Update if the last sync reported the cvar changed
+=================
+*/
+void CG_UpdateChangedCvar( vmCvar_t *vmCvar ) {
+	if ( BG_CvarChanged( vmCvar, cvarSyncHandles, numCvarSyncHandles ) ) {
+		trap_Cvar_Update( vmCvar );
+	}
+}
+
 /*
 =================
 CG_UpdateCgameCvars
@@ -592,7 +613,7 @@ void CG_UpdateCgameCvars( void ) {
 			continue;
 		}
 
-		trap_Cvar_Update( cv->vmCvar );
+		CG_UpdateChangedCvar( cv->vmCvar );
 	}
 }
 
@@ -611,7 +632,7 @@ void CG_UpdateUserCvars( void ) {
 		}
 
 		for ( j = 0; j < CG_MaxSplitView(); j++ ) {
-			trap_Cvar_Update( &uservar->vmCvars[j] );
+			CG_UpdateChangedCvar( &uservar->vmCvars[j] );
 		}
 	}
 }
@@ -622,9 +643,14 @@ CG_UpdateCvars
 =================
 */
 void CG_UpdateCvars( void ) {
-	CG_UpdateCgameCvars();
-	CG_UpdateUserCvars();
-	CG_UpdateInputCvars();
+	numCvarSyncHandles = trap_Cvar_Sync( cvarSyncHandles, MAX_CVAR_SYNC_HANDLES );
+
+	if ( numCvarSyncHandles ) {
+		CG_UpdateCgameCvars();
+		CG_UpdateUserCvars();
+		CG_UpdateInputCvars();
+		UI_UpdateCvars();
+	}
 
 	if ( !cg.connected ) {
 		return;
@@ -36,7 +36,7 @@ Suite 120, Rockville, Maryland 20850 USA.
 // major 0 means each minor is an API break.
 // major > 0 means each major is an API break and each minor extends API.
 #define CG_API_MAJOR_VERSION	0
-#define CG_API_MINOR_VERSION	2
+#define CG_API_MINOR_VERSION	4
 
 
 #define	CMD_BACKUP			64	
@@ -195,6 +195,10 @@ typedef enum {
 
 	CG_ALLOC,
 
+	CG_CVAR_SYNC,
+
+	CG_MICROSECONDS,
+
 	//=========== client game specific functionality =============
 
 	CG_GETCLIPBOARDDATA = 100,
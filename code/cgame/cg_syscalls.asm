@@ -65,6 +65,10 @@ equ trap_PC_SourceFileAndLine			-59
 
 equ trap_Alloc							-60
 
+equ trap_Cvar_Sync						-61
+
+equ trap_Microseconds					-62
+
 
 equ	trap_GetClipboardData				-101
 equ	trap_GetGlconfig					-102
@@ -715,6 +715,14 @@ void *trap_Alloc( int size, const char *tag ) {
 	return (void *)syscall( CG_ALLOC, size, tag );
 }
 
+int trap_Cvar_Sync( int *handles, int maxHandles ) {
+	return syscall( CG_CVAR_SYNC, handles, maxHandles );
+}
+
+int trap_Microseconds( void ) {
+	return syscall( CG_MICROSECONDS );
+}
+
 int trap_RealTime(qtime_t *qtime) {
 	return syscall( CG_REAL_TIME, qtime );
 }
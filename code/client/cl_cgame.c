@@ -1209,7 +1209,7 @@ intptr_t CL_CgameSystemCalls( intptr_t *args ) {
 	case CG_MILLISECONDS:
 		return Sys_Milliseconds();
 	case CG_CVAR_REGISTER:
-		Cvar_Register( VMA(1), VMA(2), VMA(3), args[4] ); 
+		Cvar_Register( VMA(1), VMA(2), VMA(3), args[4], CVAR_SYNC_CGAME ); 
 		return 0;
 	case CG_CVAR_UPDATE:
 		Cvar_Update( VMA(1) );
@@ -1239,6 +1239,10 @@ intptr_t CL_CgameSystemCalls( intptr_t *args ) {
 	case CG_CVAR_CHECK_RANGE:
 		Cvar_CheckRangeSafe( VMA(1), VMF(2), VMF(3), args[4] );
 		return 0;
+	case CG_CVAR_SYNC:
+		return Cvar_Sync( CVAR_SYNC_CGAME, VMA(1), args[2] );
+	case CG_MICROSECONDS:
+		return (int)Sys_Microseconds();
 	case CG_ARGC:
 		return Cmd_Argc();
 	case CG_ARGV:
@@ -1754,6 +1758,9 @@ void CL_InitCGame( void ) {
 
 	inGameLoad = ( clc.state > CA_CONNECTED && clc.state != CA_CINEMATIC );
 
+	// the cgame registers its cvars again in CG_INIT
+	Cvar_ResetSync( CVAR_SYNC_CGAME );
+
 	// init for this gamestate
 	VM_Call( cgvm, CG_INIT, inGameLoad, CL_MAX_SPLITVIEW, com_playVideo );
 
@@ -1832,6 +1839,9 @@ void CL_InitCGame( void ) {
 	// on the card even if the driver does deferred loading
 	re.EndRegistration();
 
+	// free prefetched files that cgame didn't load
+	FS_FlushAsyncReads( qtrue );
+
 	// make sure everything is paged in
 	if (!Sys_LowPhysicalMemory()) {
 		Com_TouchMemory();
@@ -2286,6 +2286,45 @@ void CL_NextDownload(void)
 	CL_DownloadsComplete();
 }
 
+/*
+=================
+CL_PrefetchConfigstrings
+
+Reads the map, models and sounds named in configstrings on job threads,
+so they are ready when cgame registers them
+=================
+*/
+static void CL_PrefetchConfigstrings( void ) {
+	static const char *extensions[] = { "bsp", "md3", "mdr", "iqm", "skin", "wav", "ogg", "opus" };
+	const char	*s, *ext;
+	int			i, j;
+
+	// without job threads prefetching would only stall here
+	if ( !Job_NumThreads() ) {
+		return;
+	}
+
+	for ( i = 0; i < MAX_CONFIGSTRINGS; i++ ) {
+		if ( !cl.gameState.stringOffsets[i] ) {
+			continue;
+		}
+
+		s = cl.gameState.stringData + cl.gameState.stringOffsets[i];
+
+		if ( !strchr( s, '/' ) || strchr( s, '\\' ) || strlen( s ) >= MAX_QPATH ) {
+			continue;
+		}
+
+		ext = COM_GetExtension( s );
+		for ( j = 0; j < ARRAY_LEN( extensions ); j++ ) {
+			if ( !Q_stricmp( ext, extensions[j] ) ) {
+				FS_PrefetchFile( s );
+				break;
+			}
+		}
+	}
+}
+
 /*
 =================
 CL_InitDownloads
@@ -2326,7 +2365,10 @@ void CL_InitDownloads(void) {
 		}
 
 	}
-		
+
+	// start loading the models and sounds cgame is going to register
+	CL_PrefetchConfigstrings();
+
 	CL_DownloadsComplete();
 }
 
@@ -1195,6 +1195,61 @@ int BotGetSecondGoal(int goalstate, bot_goal_t *goal)
 	return qtrue;
 } //end of the function BotGetSecondGoal
 //===========================================================================
+// adds the routes the bot is likely to query when choosing and
+// following goals, see trap_AAS_PrepareRoutes
+//
+// Parameter:				-
+// Returns:					new number of route queries
+// Changes Globals:		-
+//===========================================================================
+int BotGoalRouteQueries(int goalstate, int areanum, int travelflags,
+						aas_routequery_t *queries, int numqueries, int maxqueries)
+{
+	int i;
+	levelitem_t *li;
+	bot_goalstate_t *gs;
+
+	gs = BotGoalStateFromHandle(goalstate);
+	if (!gs) return numqueries;
+	if (!areanum) return numqueries;
+	//the goals on the goal stack
+	for (i = gs->goalstacktop; i > 0 && numqueries < maxqueries; i--)
+	{
+		if (!gs->goalstack[i].areanum) continue;
+		queries[numqueries].areanum = areanum;
+		queries[numqueries].goalareanum = gs->goalstack[i].areanum;
+		queries[numqueries].travelflags = travelflags;
+		numqueries++;
+	} //end for
+	//the items BotChooseLTGItem and BotChooseNBGItem look at
+	for (li = levelitems; li && numqueries < maxqueries; li = li->next)
+	{
+		if (g_gametype.integer == GT_SINGLE_PLAYER) {
+			if (li->flags & IFL_NOTSINGLE)
+				continue;
+		}
+		if (g_gametype.integer >= GT_TEAM) {
+			if (li->flags & IFL_NOTTEAM)
+				continue;
+		}
+		else {
+			if (li->flags & IFL_NOTFREE)
+				continue;
+		}
+		if (li->flags & IFL_NOTBOT)
+			continue;
+		if (!li->goalareanum)
+			continue;
+		if (!li->entitynum && !(li->flags & IFL_ROAM))
+			continue;
+		queries[numqueries].areanum = areanum;
+		queries[numqueries].goalareanum = li->goalareanum;
+		queries[numqueries].travelflags = travelflags;
+		numqueries++;
+	} //end for
+	return numqueries;
+} //end of the function BotGoalRouteQueries
+//===========================================================================
 // pops a new long term goal on the goal stack in the goalstate
 //
 // Parameter:				-
@@ -95,6 +95,9 @@ void BotGoalName(int number, char *name, int size);
 int BotGetTopGoal(int goalstate, bot_goal_t *goal);
 //get the second goal on the stack
 int BotGetSecondGoal(int goalstate, bot_goal_t *goal);
+//add the routes from the area to the goals on the stack and the level items
+int BotGoalRouteQueries(int goalstate, int areanum, int travelflags,
+						struct aas_routequery_s *queries, int numqueries, int maxqueries);
 //choose the best long term goal item for the bot
 int BotChooseLTGItem(int goalstate, vec3_t origin, int *inventory, int travelflags);
 //choose the best nearby goal item for the bot
@@ -84,7 +84,10 @@ int bot_interbreedmatchcount;
 //
 vmCvar_t bot_thinktime;
 vmCvar_t bot_memorydump;
+vmCvar_t bot_routinginfo;
+vmCvar_t bot_routingbenchmark;
 vmCvar_t bot_saveroutingcache;
+vmCvar_t bot_precomputeroutes;
 vmCvar_t bot_pause;
 vmCvar_t bot_report;
 vmCvar_t bot_testsolid;
@@ -96,6 +99,11 @@ vmCvar_t bot_interbreedchar;
 vmCvar_t bot_interbreedbots;
 vmCvar_t bot_interbreedcycle;
 vmCvar_t bot_interbreedwrite;
+vmCvar_t bot_prepareroutes;
+vmCvar_t bot_thinkbudget;
+
+//first client to think in the next bot AI frame
+int botthinkfirst;
 
 
 void ExitLevel( void );
@@ -1410,20 +1418,115 @@ int BotAILoadMap( int restart ) {
 void ProximityMine_Trigger( gentity_t *trigger, gentity_t *other, trace_t *trace );
 #endif
 
+#define MAX_ROUTEQUERIES	2048
+
+static aas_routequery_t routequeries[MAX_ROUTEQUERIES];
+
+/*
+==================
+BotPrepareRoutes
+
+Collects the routes of the bots that think this frame, so the botlib can
+create the missing routing caches on its job threads instead of one at a
+time while each bot thinks.
+==================
+*/
+static void BotPrepareRoutes(int elapsed_time, int thinktime) {
+	int i, areanum, numqueries;
+	bot_state_t *bs;
+
+	numqueries = 0;
+	for( i = 0; i < MAX_CLIENTS; i++ ) {
+		bs = botstates[i];
+		if( !bs || !bs->inuse ) {
+			continue;
+		}
+		if( bs->botthink_residual + elapsed_time < thinktime ) {
+			continue;
+		}
+		if( g_entities[i].client->pers.connected != CON_CONNECTED ) {
+			continue;
+		}
+		areanum = BotPointAreaNum(g_entities[i].client->ps.origin);
+		numqueries = BotGoalRouteQueries(bs->gs, areanum, bs->tfl, routequeries, numqueries, MAX_ROUTEQUERIES);
+	}
+
+	if (numqueries) {
+		trap_AAS_PrepareRoutes(routequeries, numqueries);
+	}
+}
+
+/*
+==================
+BotAIThink
+
+Runs the bots due to think. Once the bot_thinkbudget of the frame is
+used up the remaining thinks wait for a later frame, the time keeps
+adding up in botthink_residual and the bot thinks for all of it then.
+==================
+*/
+static void BotAIThink(int starttime, int thinktime) {
+	bot_state_t *bs;
+	int i, j, numthinks, thinkstart, thinkframe, cost, deferred;
+
+	numthinks = 0;
+	deferred = -1;
+	for (j = 0; j < MAX_CLIENTS; j++) {
+		//start with the first bot that had to wait last frame
+		i = (botthinkfirst + j) % MAX_CLIENTS;
+		bs = botstates[i];
+		if (!bs || !bs->inuse || bs->botthink_residual < thinktime) {
+			continue;
+		}
+		if (g_entities[i].client->pers.connected != CON_CONNECTED) {
+			bs->botthink_residual -= thinktime;
+			continue;
+		}
+		//the first bot always gets the whole budget so every bot gets a turn
+		if (bot_thinkbudget.integer > 0 && numthinks > 0 &&
+				trap_Microseconds() - starttime + bs->thinkcost > bot_thinkbudget.integer) {
+			if (deferred < 0) {
+				deferred = i;
+			}
+			continue;
+		}
+		//think for all the think time that passed
+		thinkframe = bs->botthink_residual;
+		if (thinktime > 0) {
+			thinkframe -= thinkframe % thinktime;
+		}
+		bs->botthink_residual -= thinkframe;
+		//
+		thinkstart = trap_Microseconds();
+		BotAI(i, (float) thinkframe / 1000);
+		cost = trap_Microseconds() - thinkstart;
+		//running average of the think time
+		bs->thinkcost += (cost - bs->thinkcost) / 8;
+		numthinks++;
+	}
+	if (deferred >= 0) {
+		botthinkfirst = deferred;
+	}
+}
+
 /*
 ==================
 BotAIStartFrame
 ==================
 */
 int BotAIStartFrame(int time) {
-	int i;
+	int i, numentities, starttime;
 	gentity_t	*ent;
-	bot_entitystate_t state;
+	bot_entitystate_t *state;
+	static int entitynums[MAX_GENTITIES];
+	static bot_entitystate_t entitystates[MAX_GENTITIES];
 	int elapsed_time, thinktime;
 	static int local_time;
 	static int botlib_residual;
 	static int lastbotthink_time;
 
+	starttime = trap_Microseconds();
+
 	G_CheckBotSpawn();
 
 	trap_Cvar_Update(&bot_rocketjump);
@@ -1433,13 +1536,18 @@ int BotAIStartFrame(int time) {
 	trap_Cvar_Update(&bot_testrchat);
 	trap_Cvar_Update(&bot_thinktime);
 	trap_Cvar_Update(&bot_memorydump);
+	trap_Cvar_Update(&bot_routinginfo);
+	trap_Cvar_Update(&bot_routingbenchmark);
 	trap_Cvar_Update(&bot_saveroutingcache);
+	trap_Cvar_Update(&bot_precomputeroutes);
 	trap_Cvar_Update(&bot_pause);
 	trap_Cvar_Update(&bot_report);
 	trap_Cvar_Update(&bot_droppedweight);
 	trap_Cvar_Update(&bot_offhandgrapple);
 	trap_Cvar_Update(&bot_shownodechanges);
 	trap_Cvar_Update(&bot_showteamgoals);
+	trap_Cvar_Update(&bot_prepareroutes);
+	trap_Cvar_Update(&bot_thinkbudget);
 
 	BotUpdateInfoConfigStrings();
 
@@ -1466,10 +1574,22 @@ int BotAIStartFrame(int time) {
 		trap_BotLibVarSet("memorydump", "1");
 		trap_Cvar_SetValue("bot_memorydump", 0);
 	}
+	if (bot_routinginfo.integer) {
+		trap_BotLibVarSet("showcacheupdates", "1");
+		trap_Cvar_SetValue("bot_routinginfo", 0);
+	}
+	if (bot_routingbenchmark.integer) {
+		trap_BotLibVarSet("routingbenchmark", "1");
+		trap_Cvar_SetValue("bot_routingbenchmark", 0);
+	}
 	if (bot_saveroutingcache.integer) {
 		trap_BotLibVarSet("saveroutingcache", "1");
 		trap_Cvar_SetValue("bot_saveroutingcache", 0);
 	}
+	if (bot_precomputeroutes.integer) {
+		trap_BotLibVarSet("precomputeroutecache", "1");
+		trap_Cvar_SetValue("bot_precomputeroutes", 0);
+	}
 	//check if bot interbreeding is activated
 	BotInterbreeding();
 	//cap the bot think time
@@ -1498,37 +1618,33 @@ int BotAIStartFrame(int time) {
 
 		if (!trap_AAS_Initialized()) return qfalse;
 
-		//update entities in the botlib
+		//update entities in the botlib, the entities that aren't in the
+		//list are unlinked
+		numentities = 0;
 		for (i = 0; i < MAX_GENTITIES; i++) {
 			ent = &g_entities[i];
 			ent->botvalid = qfalse;
 			if (!ent->inuse) {
-				trap_BotLibUpdateEntity(i, NULL);
 				continue;
 			}
 			if (!ent->r.linked) {
-				trap_BotLibUpdateEntity(i, NULL);
 				continue;
 			}
 			if (ent->r.svFlags & SVF_NOCLIENT) {
-				trap_BotLibUpdateEntity(i, NULL);
 				continue;
 			}
 			// do not update missiles
 			if (ent->s.eType == ET_MISSILE && ent->s.weapon != WP_GRAPPLING_HOOK) {
-				trap_BotLibUpdateEntity(i, NULL);
 				continue;
 			}
 			// do not update event only entities
 			if (ent->s.eType > ET_EVENTS) {
-				trap_BotLibUpdateEntity(i, NULL);
 				continue;
 			}
 #ifdef MISSIONPACK
 			// never link prox mine triggers
 			if (ent->s.contents == CONTENTS_TRIGGER) {
 				if (ent->touch == ProximityMine_Trigger) {
-					trap_BotLibUpdateEntity(i, NULL);
 					continue;
 				}
 			}
@@ -1538,36 +1654,38 @@ int BotAIStartFrame(int time) {
 			ent->update_time = trap_AAS_Time() - ent->ltime;
 			ent->ltime = trap_AAS_Time();
 			//
-			memset(&state, 0, sizeof(bot_entitystate_t));
+			state = &entitystates[numentities];
+			entitynums[numentities++] = i;
+			memset(state, 0, sizeof(bot_entitystate_t));
 			//
-			VectorCopy(ent->r.currentOrigin, state.origin);
+			VectorCopy(ent->r.currentOrigin, state->origin);
 			if (i < MAX_CLIENTS) {
-				VectorCopy(ent->s.apos.trBase, state.angles);
+				VectorCopy(ent->s.apos.trBase, state->angles);
 			} else {
-				VectorCopy(ent->r.currentAngles, state.angles);
+				VectorCopy(ent->r.currentAngles, state->angles);
 			}
-			VectorCopy( ent->r.absmin, state.absmins );
-			VectorCopy( ent->r.absmax, state.absmaxs );
-			state.type = ent->s.eType;
-			state.flags = ent->s.eFlags;
+			VectorCopy( ent->r.absmin, state->absmins );
+			VectorCopy( ent->r.absmax, state->absmaxs );
+			state->type = ent->s.eType;
+			state->flags = ent->s.eFlags;
 			//
 			if (ent->s.bmodel) {
-				state.solid = SOLID_BSP;
+				state->solid = SOLID_BSP;
 				//if the angles of the model changed
-				if ( !VectorCompare( state.angles, ent->lastAngles ) ) {
-					VectorCopy(state.angles, ent->lastAngles);
-					state.relink = qtrue;
+				if ( !VectorCompare( state->angles, ent->lastAngles ) ) {
+					VectorCopy(state->angles, ent->lastAngles);
+					state->relink = qtrue;
 				}
 			} else {
-				state.solid = SOLID_BBOX;
-				VectorCopy(state.angles, ent->lastAngles);
+				state->solid = SOLID_BBOX;
+				VectorCopy(state->angles, ent->lastAngles);
 			}
 			//previous frame visorigin
 			VectorCopy( ent->visorigin, ent->lastvisorigin );
 			//if the origin changed
-			if ( !VectorCompare( state.origin, ent->visorigin ) ) {
-				VectorCopy( state.origin, ent->visorigin );
-				state.relink = qtrue;
+			if ( !VectorCompare( state->origin, ent->visorigin ) ) {
+				VectorCopy( state->origin, ent->visorigin );
+				state->relink = qtrue;
 			}
 			//if the bounding box size changed
 			if (!VectorCompare(ent->s.mins, ent->lastMins) ||
@@ -1575,17 +1693,20 @@ int BotAIStartFrame(int time) {
 			{
 				VectorCopy( ent->s.mins, ent->lastMins );
 				VectorCopy( ent->s.maxs, ent->lastMaxs );
-				state.relink = qtrue;
+				state->relink = qtrue;
 			}
-			//
-			trap_BotLibUpdateEntity(i, &state);
 		}
+		trap_BotLibUpdateEntities(entitynums, entitystates, numentities);
 
 		BotAIRegularUpdate();
 	}
 
 	floattime = trap_AAS_Time();
 
+	if (bot_prepareroutes.integer) {
+		BotPrepareRoutes(elapsed_time, thinktime);
+	}
+
 	// execute scheduled bot AI
 	for( i = 0; i < MAX_CLIENTS; i++ ) {
 		if( !botstates[i] || !botstates[i]->inuse ) {
@@ -1595,15 +1716,10 @@ int BotAIStartFrame(int time) {
 		botstates[i]->botthink_residual += elapsed_time;
 		//
 		if ( botstates[i]->botthink_residual >= thinktime ) {
-			botstates[i]->botthink_residual -= thinktime;
-
 			if (!trap_AAS_Initialized()) return qfalse;
-
-			if (g_entities[i].client->pers.connected == CON_CONNECTED) {
-				BotAI(i, (float) thinktime / 1000);
-			}
 		}
 	}
+	BotAIThink(starttime, thinktime);
 
 
 	// execute bot user commands every frame
@@ -1642,6 +1758,18 @@ int BotInitLibrary(void) {
 	//maximum number of aas links
 	trap_Cvar_VariableStringBuffer("max_aaslinks", buf, sizeof(buf));
 	if (strlen(buf)) trap_BotLibVarSet("max_aaslinks", buf);
+	//routing cache budget in KB
+	trap_Cvar_VariableStringBuffer("bot_maxroutingcache", buf, sizeof(buf));
+	if (strlen(buf)) trap_BotLibVarSet("max_routingcache", buf);
+	//number of jobs calculating the area reachabilities
+	trap_Cvar_VariableStringBuffer("bot_reachabilityThreads", buf, sizeof(buf));
+	if (strlen(buf)) trap_BotLibVarSet("reachabilitythreads", buf);
+	//compare the threaded reachabilities with the serial ones
+	trap_Cvar_VariableStringBuffer("bot_reachabilityCheck", buf, sizeof(buf));
+	if (strlen(buf)) trap_BotLibVarSet("reachabilitycheck", buf);
+	//precompiled bot file budget in KB
+	trap_Cvar_VariableStringBuffer("bot_sourceCacheSize", buf, sizeof(buf));
+	if (strlen(buf)) trap_BotLibVarSet("sourcecachesize", buf);
 	//bot developer mode and log file
 	trap_BotLibVarSet("bot_developer", bot_developer.string);
 	trap_Cvar_VariableStringBuffer("logfile", buf, sizeof(buf));
@@ -1689,7 +1817,10 @@ int BotAISetup( int restart ) {
 
 	trap_Cvar_Register(&bot_thinktime, "bot_thinktime", "100", CVAR_CHEAT);
 	trap_Cvar_Register(&bot_memorydump, "bot_memorydump", "0", CVAR_CHEAT);
+	trap_Cvar_Register(&bot_routinginfo, "bot_routinginfo", "0", 0);
+	trap_Cvar_Register(&bot_routingbenchmark, "bot_routingbenchmark", "0", CVAR_CHEAT);
 	trap_Cvar_Register(&bot_saveroutingcache, "bot_saveroutingcache", "0", CVAR_CHEAT);
+	trap_Cvar_Register(&bot_precomputeroutes, "bot_precomputeroutes", "0", CVAR_CHEAT);
 	trap_Cvar_Register(&bot_pause, "bot_pause", "0", CVAR_CHEAT);
 	trap_Cvar_Register(&bot_report, "bot_report", "0", CVAR_CHEAT);
 	trap_Cvar_Register(&bot_testsolid, "bot_testsolid", "0", CVAR_CHEAT);
@@ -1701,6 +1832,8 @@ int BotAISetup( int restart ) {
 	trap_Cvar_Register(&bot_interbreedbots, "bot_interbreedbots", "10", 0);
 	trap_Cvar_Register(&bot_interbreedcycle, "bot_interbreedcycle", "20", 0);
 	trap_Cvar_Register(&bot_interbreedwrite, "bot_interbreedwrite", "", 0);
+	trap_Cvar_Register(&bot_prepareroutes, "bot_prepareroutes", "1", 0);
+	trap_Cvar_Register(&bot_thinkbudget, "bot_thinkbudget", "0", 0);
 
 	level.botReportModificationCount = bot_report.modificationCount;
 
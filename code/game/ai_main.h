@@ -130,6 +130,7 @@ typedef struct bot_state_s
 {
 	int inuse;										//true if this state is used by a bot client
 	int botthink_residual;							//residual for the bot thinks
+	int thinkcost;									//average think time in microseconds
 	int client;										//client number of the bot
 	int entitynum;									//entity number of the bot
 	playerState_t cur_ps;							//current player state
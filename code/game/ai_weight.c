@@ -65,6 +65,7 @@ Suite 120, Rockville, Maryland 20850 USA.
 
 
 #define MAX_INVENTORYVALUE			999999
+#define EVALUATEFLATTENED
 #define EVALUATERECURSIVELY
 
 #define MAX_WEIGHT_FILES			128
@@ -321,6 +322,93 @@ fuzzyseperator_t *ReadFuzzySeperators_r(int source)
 	return firstfs;
 } //end of the function ReadFuzzySeperators_r
 //===========================================================================
+// counts the switches and cases of the fuzzy seperators
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void CountFuzzySeperators_r(fuzzyseperator_t *fs, int *numswitches, int *numcases)
+{
+	(*numswitches)++;
+	for (; fs; fs = fs->next)
+	{
+		(*numcases)++;
+		if (fs->child) CountFuzzySeperators_r(fs->child, numswitches, numcases);
+	} //end for
+} //end of the function CountFuzzySeperators_r
+//===========================================================================
+// stores the fuzzy seperators as a switch with consecutive cases
+//
+// Parameter:				-
+// Returns:					the switch number
+// Changes Globals:		-
+//===========================================================================
+int FlattenFuzzySeperators_r(weightconfig_t *config, fuzzyseperator_t *fs)
+{
+	int switchnum, casenum;
+	fuzzyswitch_t *sw;
+	fuzzyseperator_t *s;
+
+	switchnum = config->numswitches++;
+	sw = &config->switches[switchnum];
+	sw->index = fs->index;
+	sw->firstcase = config->numcases;
+	sw->numcases = 0;
+	for (s = fs; s; s = s->next) sw->numcases++;
+	//the cases of the switch are consecutive, the child switches follow
+	config->numcases += sw->numcases;
+	for (casenum = sw->firstcase; fs; fs = fs->next, casenum++)
+	{
+		config->casevalues[casenum] = fs->value;
+		config->cases[casenum].weight = fs->weight;
+		config->cases[casenum].minweight = fs->minweight;
+		config->cases[casenum].maxweight = fs->maxweight;
+		if (fs->child) config->cases[casenum].child = FlattenFuzzySeperators_r(config, fs->child);
+		else config->cases[casenum].child = -1;
+	} //end for
+	return switchnum;
+} //end of the function FlattenFuzzySeperators_r
+//===========================================================================
+// flattens the fuzzy seperators of all weights into the switch and case
+// arrays, the arrays are reused when the weights are changed
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void FlattenWeightConfig(weightconfig_t *config)
+{
+	int i, numswitches, numcases;
+
+	if (!config->switches)
+	{
+		numswitches = 0;
+		numcases = 0;
+		for (i = 0; i < config->numweights; i++)
+		{
+			if (!config->weights[i].firstseperator) continue;
+			CountFuzzySeperators_r(config->weights[i].firstseperator, &numswitches, &numcases);
+		} //end for
+		config->switches = (fuzzyswitch_t *) trap_Alloc((numswitches + 1) * sizeof(fuzzyswitch_t), NULL);
+		config->casevalues = (int *) trap_Alloc((numcases + 1) * sizeof(int), NULL);
+		config->cases = (fuzzycase_t *) trap_Alloc((numcases + 1) * sizeof(fuzzycase_t), NULL);
+	} //end if
+	config->numswitches = 0;
+	config->numcases = 0;
+	for (i = 0; i < config->numweights; i++)
+	{
+		if (config->weights[i].firstseperator)
+		{
+			config->weights[i].switchnum = FlattenFuzzySeperators_r(config, config->weights[i].firstseperator);
+		} //end if
+		else
+		{
+			config->weights[i].switchnum = -1;
+		} //end else
+	} //end for
+} //end of the function FlattenWeightConfig
+//===========================================================================
 //
 // Parameter:				-
 // Returns:					-
@@ -383,6 +471,7 @@ weightconfig_t *ReadWeightConfig(char *filename)
 	//
 	config->valid = qfalse;
 	config->numweights = 0;
+	config->switches = NULL;
 	Q_strncpyz( config->filename, filename, sizeof(config->filename) );
 	//parse the item config file
 	while(trap_PC_ReadToken(source, &token))
@@ -476,6 +565,8 @@ weightconfig_t *ReadWeightConfig(char *filename)
 	} //end while
 	//free the source at the end of a pass
 	trap_PC_FreeSource(source);
+	//flatten the weights for fast evaluation
+	FlattenWeightConfig(config);
 	//if the file was located in a pak file
 	BotAI_Print(PRT_DEVELOPER, "loaded %s\n", filename);
 	BotAI_Print(PRT_DEVELOPER, "weights loaded in %d msec\n", trap_Milliseconds() - starttime);
@@ -691,6 +782,82 @@ float FuzzyWeightUndecided_r(int *inventory, fuzzyseperator_t *fs)
 	return fs->weight;
 } //end of the function FuzzyWeightUndecided_r
 //===========================================================================
+// evaluates a flattened switch the same way as FuzzyWeight_r
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+float FuzzySwitchWeight_r(int *inventory, weightconfig_t *wc, int switchnum)
+{
+	fuzzyswitch_t *sw;
+	fuzzycase_t *cases;
+	int *values, value, i;
+	float scale, w1, w2;
+
+	sw = &wc->switches[switchnum];
+	values = wc->casevalues + sw->firstcase;
+	cases = wc->cases + sw->firstcase;
+	value = inventory[sw->index];
+	//find the first case with a larger value
+	for (i = 0; i < sw->numcases && value >= values[i]; i++) ;
+	if (i >= sw->numcases) return cases[sw->numcases-1].weight;
+	if (i == 0)
+	{
+		if (cases[0].child >= 0) return FuzzySwitchWeight_r(inventory, wc, cases[0].child);
+		else return cases[0].weight;
+	} //end if
+	//first weight
+	if (cases[i-1].child >= 0) w1 = FuzzySwitchWeight_r(inventory, wc, cases[i-1].child);
+	else w1 = cases[i-1].weight;
+	//second weight
+	if (cases[i].child >= 0) w2 = FuzzySwitchWeight_r(inventory, wc, cases[i].child);
+	else w2 = cases[i].weight;
+	//can't interpolate with the default case
+	if (values[i] == MAX_INVENTORYVALUE) return w2;
+	//scale between the two weights
+	scale = (float) (value - values[i-1]) / (values[i] - values[i-1]);
+	return (1 - scale) * w1 + scale * w2;
+} //end of the function FuzzySwitchWeight_r
+//===========================================================================
+// evaluates a flattened switch the same way as FuzzyWeightUndecided_r
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+float FuzzySwitchWeightUndecided_r(int *inventory, weightconfig_t *wc, int switchnum)
+{
+	fuzzyswitch_t *sw;
+	fuzzycase_t *cases;
+	int *values, value, i;
+	float scale, w1, w2;
+
+	sw = &wc->switches[switchnum];
+	values = wc->casevalues + sw->firstcase;
+	cases = wc->cases + sw->firstcase;
+	value = inventory[sw->index];
+	//find the first case with a larger value
+	for (i = 0; i < sw->numcases && value >= values[i]; i++) ;
+	if (i >= sw->numcases) return cases[sw->numcases-1].weight;
+	if (i == 0)
+	{
+		if (cases[0].child >= 0) return FuzzySwitchWeightUndecided_r(inventory, wc, cases[0].child);
+		else return cases[0].minweight + random() * (cases[0].maxweight - cases[0].minweight);
+	} //end if
+	//first weight
+	if (cases[i-1].child >= 0) w1 = FuzzySwitchWeightUndecided_r(inventory, wc, cases[i-1].child);
+	else w1 = cases[i-1].minweight + random() * (cases[i-1].maxweight - cases[i-1].minweight);
+	//second weight
+	if (cases[i].child >= 0) w2 = FuzzySwitchWeight_r(inventory, wc, cases[i].child);
+	else w2 = cases[i].minweight + random() * (cases[i].maxweight - cases[i].minweight);
+	//can't interpolate with the default case
+	if (values[i] == MAX_INVENTORYVALUE) return w2;
+	//scale between the two weights
+	scale = (float) (value - values[i-1]) / (values[i] - values[i-1]);
+	return (1 - scale) * w1 + scale * w2;
+} //end of the function FuzzySwitchWeightUndecided_r
+//===========================================================================
 //
 // Parameter:				-
 // Returns:					-
@@ -698,7 +865,10 @@ float FuzzyWeightUndecided_r(int *inventory, fuzzyseperator_t *fs)
 //===========================================================================
 float FuzzyWeight(int *inventory, weightconfig_t *wc, int weightnum)
 {
-#ifdef EVALUATERECURSIVELY
+#if defined(EVALUATEFLATTENED)
+	if (wc->weights[weightnum].switchnum < 0) return 0;
+	return FuzzySwitchWeight_r(inventory, wc, wc->weights[weightnum].switchnum);
+#elif defined(EVALUATERECURSIVELY)
 	return FuzzyWeight_r(inventory, wc->weights[weightnum].firstseperator);
 #else
 	fuzzyseperator_t *s;
@@ -729,7 +899,10 @@ float FuzzyWeight(int *inventory, weightconfig_t *wc, int weightnum)
 //===========================================================================
 float FuzzyWeightUndecided(int *inventory, weightconfig_t *wc, int weightnum)
 {
-#ifdef EVALUATERECURSIVELY
+#if defined(EVALUATEFLATTENED)
+	if (wc->weights[weightnum].switchnum < 0) return 0;
+	return FuzzySwitchWeightUndecided_r(inventory, wc, wc->weights[weightnum].switchnum);
+#elif defined(EVALUATERECURSIVELY)
 	return FuzzyWeightUndecided_r(inventory, wc->weights[weightnum].firstseperator);
 #else
 	fuzzyseperator_t *s;
@@ -789,6 +962,7 @@ void EvolveWeightConfig(weightconfig_t *config)
 	{
 		EvolveFuzzySeperator_r(config->weights[i].firstseperator);
 	} //end for
+	FlattenWeightConfig(config);
 } //end of the function EvolveWeightConfig
 //===========================================================================
 //
@@ -832,6 +1006,7 @@ void ScaleWeight(weightconfig_t *config, char *name, float scale)
 			break;
 		} //end if
 	} //end for
+	FlattenWeightConfig(config);
 } //end of the function ScaleWeight
 //===========================================================================
 //
@@ -874,6 +1049,7 @@ void ScaleFuzzyBalanceRange(weightconfig_t *config, float scale)
 	{
 		ScaleFuzzySeperatorBalanceRange_r(config->weights[i].firstseperator, scale);
 	} //end for
+	FlattenWeightConfig(config);
 } //end of the function ScaleFuzzyBalanceRange
 //===========================================================================
 //
@@ -945,6 +1121,7 @@ void InterbreedWeightConfigs(weightconfig_t *config1, weightconfig_t *config2,
 									config2->weights[i].firstseperator,
 									configout->weights[i].firstseperator);
 	} //end for
+	FlattenWeightConfig(configout);
 } //end of the function InterbreedWeightConfigs
 //===========================================================================
 //
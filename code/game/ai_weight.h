@@ -53,11 +53,29 @@ typedef struct fuzzyseperator_s
 	struct fuzzyseperator_s *next;
 } fuzzyseperator_t;
 
+//case of a flattened fuzzy switch, the case values are stored separately
+typedef struct fuzzycase_s
+{
+	int child;						//child switch or -1
+	float weight;
+	float minweight;
+	float maxweight;
+} fuzzycase_t;
+
+//flattened fuzzy switch with the cases of one inventory index
+typedef struct fuzzyswitch_s
+{
+	int index;						//inventory index
+	int firstcase;					//first case in the case arrays
+	int numcases;					//number of cases
+} fuzzyswitch_t;
+
 //fuzzy weight
 typedef struct weight_s
 {
 	char name[128];
 	struct fuzzyseperator_s *firstseperator;
+	int switchnum;					//first switch of the flattened weight or -1
 } weight_t;
 
 //weight configuration
@@ -67,6 +85,12 @@ typedef struct weightconfig_s
 	int numweights;
 	weight_t weights[MAX_WEIGHTS];
 	char		filename[MAX_QPATH];
+	//the fuzzy seperators flattened into arrays
+	int numswitches;
+	fuzzyswitch_t *switches;
+	int numcases;
+	int *casevalues;
+	fuzzycase_t *cases;
 } weightconfig_t;
 
 //reads a weight configuration
@@ -1936,6 +1936,30 @@ void BG_DecomposeUserCmdValue( int value, int *weapon ) {
 	BG_DecomposeBits( value, &bitsUsed, weapon, WEAPONNUM_BITS );
 }
 
+/*
+========================
+BG_CvarChanged
+
+Checks if vmCvar is in the handles returned by trap_Cvar_Sync
+========================
+*/
+qboolean BG_CvarChanged( const vmCvar_t *vmCvar, const int *handles, int numHandles ) {
+	int		i;
+
+	// sync overflowed, update everything
+	if ( numHandles < 0 ) {
+		return qtrue;
+	}
+
+	for ( i = 0; i < numHandles; i++ ) {
+		if ( handles[i] == vmCvar->handle ) {
+			return qtrue;
+		}
+	}
+
+	return qfalse;
+}
+
 int cmdcmp( const void *a, const void *b ) {
   return Q_stricmp( (const char *)a, ((dummyCmd_t *)b)->name );
 }
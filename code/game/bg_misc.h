@@ -1080,6 +1080,8 @@ qboolean	BG_PlayerTouchesItem( playerState_t *ps, entityState_t *item, int atTim
 int		BG_ComposeUserCmdValue( int weapon );
 void	BG_DecomposeUserCmdValue( int value, int *weapon );
 
+qboolean	BG_CvarChanged( const vmCvar_t *vmCvar, const int *handles, int numHandles );
+
 #define ARENAS_PER_TIER		4
 #define MAX_ARENAS			1024
 #define	MAX_ARENAS_TEXT		8192
@@ -1282,3 +1284,10 @@ void	trap_PC_UnreadToken( int handle );
 int		trap_PC_SourceFileAndLine( int handle, char *filename, int *line );
 
 void	*trap_Alloc( int size, const char *tag );
+
+// returns the handles of registered cvars changed since the last sync,
+// or -1 if there were more than maxHandles and everything should be updated
+int		trap_Cvar_Sync( int *handles, int maxHandles );
+
+// current time in microseconds for profiling, wraps around
+int		trap_Microseconds( void );
@@ -439,9 +439,21 @@ void G_UpdateCvars( void ) {
 	int			i;
 	cvarTable_t	*cv;
 	qboolean remapped = qfalse;
+	int			changed[MAX_CVAR_SYNC_HANDLES];
+	int			numChanged;
+
+	// only look at the cvars that changed since last frame
+	numChanged = trap_Cvar_Sync( changed, MAX_CVAR_SYNC_HANDLES );
+	if ( !numChanged ) {
+		return;
+	}
 
 	for ( i = 0, cv = gameCvarTable ; i < gameCvarTableSize ; i++, cv++ ) {
 		if ( cv->vmCvar ) {
+			if ( !BG_CvarChanged( cv->vmCvar, changed, numChanged ) ) {
+				continue;
+			}
+
 			trap_Cvar_Update( cv->vmCvar );
 
 			if ( cv->modificationCount != cv->vmCvar->modificationCount ) {
@@ -36,7 +36,7 @@ Suite 120, Rockville, Maryland 20850 USA.
 // major 0 means each minor is an API break.
 // major > 0 means each major is an API break and each minor extends API.
 #define	GAME_API_MAJOR_VERSION	0
-#define	GAME_API_MINOR_VERSION	0
+#define	GAME_API_MINOR_VERSION	4
 
 
 // entity->svFlags
@@ -177,6 +177,13 @@ typedef enum {
 
 	G_ALLOC,			// ( int size, const char *tag );
 
+	G_CVAR_SYNC,		// ( int *handles, int maxHandles );
+	// handles of registered cvars changed since the last sync, -1 if more than maxHandles
+
+	G_MICROSECONDS,	// ( void );
+	// get current time in microseconds for profiling, wraps around
+	// like G_MILLISECONDS this should NOT be used for game related tasks
+
 	//=========== server specific functionality =============
 
 	G_LOCATE_GAME_DATA = 100,		// ( gentity_t *gEnts, int numGEntities, int sizeofGEntity_t,
@@ -282,6 +289,7 @@ typedef enum {
 	BOTLIB_GET_SNAPSHOT_ENTITY,		// ( int client, int ent );
 	BOTLIB_GET_CONSOLE_MESSAGE,		// ( int client, char *message, int size );
 	BOTLIB_USER_COMMAND,			// ( int client, usercmd_t *ucmd );
+	BOTLIB_UPDATE_ENTITIES,			// ( int *entnums, bot_entitystate_t *states, int numentities );
 
 	BOTLIB_AAS_BBOX_AREAS = 301,
 	BOTLIB_AAS_AREA_INFO,
@@ -336,6 +344,7 @@ typedef enum {
 	BOTLIB_AAS_AREA_TRAVEL_TIME,
 	BOTLIB_AAS_AREA_TRAVEL_TIME_TO_GOAL_AREA,
 	BOTLIB_AAS_PREDICT_ROUTE,
+	BOTLIB_AAS_PREPARE_ROUTES,
 
 	// aas_altroute
 	BOTLIB_AAS_ALTERNATIVE_ROUTE_GOAL = 420,
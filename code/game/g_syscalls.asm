@@ -65,6 +65,10 @@ equ trap_PC_SourceFileAndLine			-59
 
 equ trap_Alloc							-60
 
+equ trap_Cvar_Sync						-61
+
+equ trap_Microseconds					-62
+
 
 equ	trap_LocateGameData					-101
 equ	trap_DropClient						-102
@@ -113,6 +117,7 @@ equ trap_BotLibTest						-208
 equ trap_BotGetSnapshotEntity			-209
 equ trap_BotGetServerCommand			-210
 equ trap_BotUserCommand					-211
+equ trap_BotLibUpdateEntities			-212
 
 
 ; there is no 301.
@@ -168,6 +173,7 @@ equ trap_AAS_EnableRoutingArea			-406
 equ trap_AAS_AreaTravelTime				-407
 equ trap_AAS_AreaTravelTimeToGoalArea	-408
 equ trap_AAS_PredictRoute				-409
+equ trap_AAS_PrepareRoutes				-410
 
 equ trap_AAS_AlternativeRouteGoals		-421
 
@@ -343,6 +343,10 @@ int trap_BotLibUpdateEntity(int ent, void /* struct bot_updateentity_s */ *bue)
 	return syscall( BOTLIB_UPDATENTITY, ent, bue );
 }
 
+int trap_BotLibUpdateEntities(int *entnums, void /* struct bot_entitystate_s */ *states, int numentities) {
+	return syscall( BOTLIB_UPDATE_ENTITIES, entnums, states, numentities );
+}
+
 int trap_BotLibTest(int parm0, char *parm1, vec3_t parm2, vec3_t parm3) {
 	return syscall( BOTLIB_TEST, parm0, parm1, parm2, parm3 );
 }
@@ -522,6 +526,10 @@ int trap_AAS_PredictRoute(void /*struct aas_predictroute_s*/ *route, int areanum
 	return syscall( BOTLIB_AAS_PREDICT_ROUTE, route, areanum, origin, goalareanum, travelflags, maxareas, maxtime, stopevent, stopcontents, stoptfl, stopareanum );
 }
 
+int trap_AAS_PrepareRoutes(void /*struct aas_routequery_s*/ *queries, int numqueries) {
+	return syscall( BOTLIB_AAS_PREPARE_ROUTES, queries, numqueries );
+}
+
 int trap_AAS_AlternativeRouteGoals(vec3_t start, int startareanum, vec3_t goal, int goalareanum, int travelflags,
 										void /*struct aas_altroutegoal_s*/ *altroutegoals, int maxaltroutegoals,
 										int type) {
@@ -705,3 +713,11 @@ int trap_PC_SourceFileAndLine( int handle, char *filename, int *line ) {
 void *trap_Alloc( int size, const char *tag ) {
 	return (void *)syscall( G_ALLOC, size, tag );
 }
+
+int trap_Cvar_Sync( int *handles, int maxHandles ) {
+	return syscall( G_CVAR_SYNC, handles, maxHandles );
+}
+
+int trap_Microseconds( void ) {
+	return syscall( G_MICROSECONDS );
+}
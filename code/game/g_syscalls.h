@@ -82,6 +82,7 @@ int		trap_BotLibVarGet(const char *var_name, char *value, int size);
 int		trap_BotLibStartFrame(float time);
 int		trap_BotLibLoadMap(const char *mapname);
 int		trap_BotLibUpdateEntity(int ent, void /* struct bot_updateentity_s */ *bue);
+int		trap_BotLibUpdateEntities(int *entnums, void /* struct bot_entitystate_s */ *states, int numentities);
 int		trap_BotLibTest(int parm0, char *parm1, vec3_t parm2, vec3_t parm3);
 
 int		trap_BotGetSnapshotEntity( int clientNum, int sequence );
@@ -134,6 +135,7 @@ int		trap_AAS_AreaTravelTimeToGoalArea(int areanum, vec3_t origin, int goalarean
 int		trap_AAS_PredictRoute(void /*struct aas_predictroute_s*/ *route, int areanum, vec3_t origin,
 							int goalareanum, int travelflags, int maxareas, int maxtime,
 							int stopevent, int stopcontents, int stoptfl, int stopareanum);
+int		trap_AAS_PrepareRoutes(void /*struct aas_routequery_s*/ *queries, int numqueries);
 
 int		trap_AAS_AlternativeRouteGoals(vec3_t start, int startareanum, vec3_t goal, int goalareanum, int travelflags,
 										void /*struct aas_altroutegoal_s*/ *altroutegoals, int maxaltroutegoals,
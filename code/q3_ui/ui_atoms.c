@@ -1094,8 +1094,6 @@ void UI_Refresh( int realtime )
 		return;
 	}
 
-	UI_UpdateCvars();
-
 	if ( uis.activemenu )
 	{
 		if (uis.activemenu->fullscreen)
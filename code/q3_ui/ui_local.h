@@ -326,7 +326,6 @@ extern sfxHandle_t	MenuField_Key( menufield_s* m, int* key );
 extern void MainMenu_Cache( void );
 extern void UI_MainMenu(void);
 extern void UI_RegisterCvars( void );
-extern void UI_UpdateCvars( void );
 
 //
 // ui_credits.c
@@ -913,7 +913,7 @@ void CM_LoadMap( const char *name, qboolean clientload, int *checksum ) {
 	// load the file
 	//
 #ifndef BSPC
-	length = FS_ReadFile( name, &buf.v );
+	length = FS_MapFile( name, &buf.v );
 #else
 	length = LoadQuakeFile((quakefile_t *) name, &buf.v);
 #endif
@@ -954,7 +954,11 @@ void CM_LoadMap( const char *name, qboolean clientload, int *checksum ) {
 	CMod_CreateBrushSideWindings( &header.lumps[LUMP_SURFACES], &header.lumps[LUMP_DRAWVERTS], &header.lumps[LUMP_DRAWINDEXES] );
 
 	// we are NOT freeing the file, because it is cached for the ref
+#ifndef BSPC
+	FS_UnmapFile (buf.v);
+#else
 	FS_FreeFile (buf.v);
+#endif
 
 	CM_InitBoxHull ();
 
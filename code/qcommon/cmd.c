@@ -323,6 +323,124 @@ void Cmd_Exec_f( void ) {
 }
 
 
+/*
+===============
+Cmd_ExecBenchText
+
+Runs text through a command buffer of its own and returns the time taken
+===============
+*/
+#define	EXECBENCH_PASSES	8
+#define	EXECBENCH_CVARS		512
+
+static int64_t Cmd_ExecBenchText( const char *text ) {
+	int64_t	start;
+
+	start = Sys_Microseconds();
+
+	Cbuf_InsertText( text );
+
+	while ( cmd_text.cursize ) {
+		cmd_wait = 0;
+		Cbuf_Execute();
+	}
+
+	return Sys_Microseconds() - start;
+}
+
+/*
+===============
+Cmd_ExecBench_f
+
+Times executing config files. Without arguments a large autoexec style
+config is generated, setting cvars with set and by name, toggling them
+and running vstrs.
+===============
+*/
+void Cmd_ExecBench_f( void ) {
+	char		*saved, *text;
+	int			savedSize, savedWait;
+	int			textSize, length;
+	int			i, pass, lines;
+	int64_t		usec;
+	char		filename[MAX_QPATH];
+	union {
+		char	*c;
+		void	*v;
+	} f;
+
+	// keep the commands after this one out of the measurement
+	savedSize = cmd_text.cursize;
+	savedWait = cmd_wait;
+	saved = Z_Malloc( savedSize + 1 );
+	Com_Memcpy( saved, cmd_text.data, savedSize );
+	cmd_text.cursize = 0;
+
+	if ( Cmd_Argc() < 2 ) {
+		textSize = MAX_CMD_BUFFER / 2;
+		text = Z_Malloc( textSize );
+		length = 0;
+		lines = 0;
+
+		for ( i = 0; i < EXECBENCH_CVARS; i++ ) {
+			length += Com_sprintf( text + length, textSize - length,
+				"set bench_var%d %d\nbench_var%d %d\ntoggle bench_var%d\n", i, i, i, i + 1, i );
+			lines += 3;
+
+			if ( !( i & 7 ) ) {
+				length += Com_sprintf( text + length, textSize - length,
+					"set bench_vstr%d \"set bench_var%d 0; bench_var%d 1\"\nvstr bench_vstr%d\n", i, i, i, i );
+				lines += 4;
+			}
+		}
+
+		usec = 0;
+		for ( pass = 0; pass < EXECBENCH_PASSES; pass++ ) {
+			usec += Cmd_ExecBenchText( text );
+		}
+
+		Com_Printf( "generated config: %d lines, %.3f msec per pass, %.3f usec per line\n",
+			lines, usec / 1000.0 / EXECBENCH_PASSES, (double)usec / EXECBENCH_PASSES / lines );
+
+		// remove the cvars again
+		length = 0;
+		for ( i = 0; i < EXECBENCH_CVARS; i++ ) {
+			length += Com_sprintf( text + length, textSize - length, "unset bench_var%d\n", i );
+
+			if ( !( i & 7 ) ) {
+				length += Com_sprintf( text + length, textSize - length, "unset bench_vstr%d\n", i );
+			}
+		}
+		Cmd_ExecBenchText( text );
+
+		Z_Free( text );
+	}
+
+	for ( i = 1; i < Cmd_Argc(); i++ ) {
+		Q_strncpyz( filename, Cmd_Argv( i ), sizeof( filename ) );
+		COM_DefaultExtension( filename, sizeof( filename ), ".cfg" );
+
+		if ( FS_ReadFile( filename, &f.v ) < 0 ) {
+			Com_Printf( "couldn't exec %s\n", filename );
+			continue;
+		}
+
+		usec = 0;
+		for ( pass = 0; pass < EXECBENCH_PASSES; pass++ ) {
+			usec += Cmd_ExecBenchText( f.c );
+		}
+
+		Com_Printf( "%s: %.3f msec per pass\n", filename, usec / 1000.0 / EXECBENCH_PASSES );
+
+		FS_FreeFile( f.v );
+	}
+
+	Com_Memcpy( cmd_text.data, saved, savedSize );
+	cmd_text.cursize = savedSize;
+	cmd_wait = savedWait;
+	Z_Free( saved );
+}
+
 /*
 ===============
 Cmd_Vstr_f
@@ -370,6 +488,7 @@ typedef struct cmd_function_s
 	char					*name;
 	xcommand_t				function;
 	completionFunc_t	complete;
+	unsigned int			hashValue;
 } cmd_function_t;
 
 
@@ -385,6 +504,11 @@ static cmdContext_t		cmd;
 static cmdContext_t		savedCmd;
 static	cmd_function_t	*cmd_functions;		// possible commands to execute
 
+// open addressing with linear probing, grown to stay at most half full
+static	cmd_function_t	**cmd_hashTable;
+static	int				cmd_hashSize;
+static	int				cmd_numFunctions;
+
 /*
 ============
 Cmd_SaveCmdContext
@@ -679,6 +803,120 @@ void Cmd_TokenizeStringIgnoreQuotes( const char *text_in ) {
 	Cmd_TokenizeString2( text_in, qtrue );
 }
 
+/*
+============
+Cmd_HashSlot
+
+Returns the slot holding the named command, or the empty slot it would go in
+============
+*/
+static int Cmd_HashSlot( const char *cmd_name, unsigned int hash )
+{
+	cmd_function_t	*cmd;
+	int				i, mask;
+
+	mask = cmd_hashSize - 1;
+
+	for( i = hash & mask; ( cmd = cmd_hashTable[i] ) != NULL; i = ( i + 1 ) & mask )
+	{
+		if( cmd->hashValue == hash && !Q_stricmp( cmd_name, cmd->name ) )
+			break;
+	}
+
+	return i;
+}
+
+/*
+============
+Cmd_HashResize
+============
+*/
+static void Cmd_HashResize( int size )
+{
+	cmd_function_t	**oldTable;
+	int				oldSize;
+	int				i, j;
+
+	oldTable = cmd_hashTable;
+	oldSize = cmd_hashSize;
+
+	// use a small malloc, commands are added before the main zone exists
+	cmd_hashTable = S_Malloc( size * sizeof( *cmd_hashTable ) );
+	Com_Memset( cmd_hashTable, 0, size * sizeof( *cmd_hashTable ) );
+	cmd_hashSize = size;
+
+	for( i = 0; i < oldSize; i++ )
+	{
+		if( !oldTable[i] )
+			continue;
+
+		for( j = oldTable[i]->hashValue & ( size - 1 ); cmd_hashTable[j]; j = ( j + 1 ) & ( size - 1 ) )
+			;
+		cmd_hashTable[j] = oldTable[i];
+	}
+
+	if( oldTable )
+		Z_Free( oldTable );
+}
+
+/*
+============
+Cmd_HashRemove
+
+Moves following commands back into the hole so lookups don't need tombstones
+============
+*/
+static void Cmd_HashRemove( cmd_function_t *cmd )
+{
+	int		i, j, home, mask;
+
+	mask = cmd_hashSize - 1;
+
+	for( i = cmd->hashValue & mask; cmd_hashTable[i] != cmd; i = ( i + 1 ) & mask )
+	{
+		if( !cmd_hashTable[i] )
+			return;
+	}
+
+	j = i;
+	while( 1 )
+	{
+		cmd_hashTable[i] = NULL;
+
+		do
+		{
+			j = ( j + 1 ) & mask;
+			if( !cmd_hashTable[j] )
+				return;
+			home = cmd_hashTable[j]->hashValue & mask;
+		} while( i <= j ? ( i < home && home <= j ) : ( i < home || home <= j ) );
+
+		cmd_hashTable[i] = cmd_hashTable[j];
+		i = j;
+	}
+}
+
+/*
+============
+Cmd_FreeCommand
+
+Unlinks the command back points to and frees it
+============
+*/
+static void Cmd_FreeCommand( cmd_function_t **back )
+{
+	cmd_function_t *cmd = *back;
+
+	*back = cmd->next;
+	Cmd_HashRemove( cmd );
+	cmd_numFunctions--;
+
+	if (cmd->name) {
+		Z_Free(cmd->name);
+	}
+	Z_Free (cmd);
+}
+
 /*
 ============
 Cmd_FindCommand
@@ -686,11 +924,10 @@ Cmd_FindCommand
 */
 cmd_function_t *Cmd_FindCommand( const char *cmd_name )
 {
-	cmd_function_t *cmd;
-	for( cmd = cmd_functions; cmd; cmd = cmd->next )
-		if( !Q_stricmp( cmd_name, cmd->name ) )
-			return cmd;
-	return NULL;
+	if( !cmd_hashSize )
+		return NULL;
+
+	return cmd_hashTable[Cmd_HashSlot( cmd_name, Com_HashStringNoCase( cmd_name ) )];
 }
 
 /*
@@ -700,9 +937,17 @@ Cmd_AddCommand
 */
 void	Cmd_AddCommand( const char *cmd_name, xcommand_t function ) {
 	cmd_function_t	*cmd;
+	unsigned int	hash;
+	int				slot;
+
+	if( ( cmd_numFunctions + 1 ) * 2 > cmd_hashSize )
+		Cmd_HashResize( cmd_hashSize ? cmd_hashSize * 2 : 256 );
+
+	hash = Com_HashStringNoCase( cmd_name );
+	slot = Cmd_HashSlot( cmd_name, hash );
 	
 	// fail if the command already exists
-	if( Cmd_FindCommand( cmd_name ) )
+	if( cmd_hashTable[slot] )
 	{
 		Com_Printf( "Cmd_AddCommand: %s already defined\n", cmd_name );
 		return;
@@ -713,8 +958,12 @@ void	Cmd_AddCommand( const char *cmd_name, xcommand_t function ) {
 	cmd->name = CopyString( cmd_name );
 	cmd->function = function;
 	cmd->complete = NULL;
+	cmd->hashValue = hash;
 	cmd->next = cmd_functions;
 	cmd_functions = cmd;
+
+	cmd_hashTable[slot] = cmd;
+	cmd_numFunctions++;
 }
 
 /*
@@ -744,10 +993,9 @@ Cmd_SetCommandCompletionFunc
 void Cmd_SetCommandCompletionFunc( const char *command, completionFunc_t complete ) {
 	cmd_function_t	*cmd;
 
-	for( cmd = cmd_functions; cmd; cmd = cmd->next ) {
-		if( !Q_stricmp( command, cmd->name ) ) {
-			cmd->complete = complete;
-		}
+	cmd = Cmd_FindCommand( command );
+	if( cmd ) {
+		cmd->complete = complete;
 	}
 }
 
@@ -759,23 +1007,16 @@ Cmd_RemoveCommand
 void	Cmd_RemoveCommand( const char *cmd_name ) {
 	cmd_function_t	*cmd, **back;
 
-	back = &cmd_functions;
-	while( 1 ) {
-		cmd = *back;
-		if ( !cmd ) {
-			// command wasn't active
-			return;
-		}
-		if ( !strcmp( cmd_name, cmd->name ) ) {
-			*back = cmd->next;
-			if (cmd->name) {
-				Z_Free(cmd->name);
-			}
-			Z_Free (cmd);
-			return;
-		}
-		back = &cmd->next;
+	cmd = Cmd_FindCommand( cmd_name );
+	if ( !cmd || strcmp( cmd_name, cmd->name ) ) {
+		// command wasn't active
+		return;
 	}
+
+	for ( back = &cmd_functions; *back != cmd; back = &(*back)->next ) {
+	}
+
+	Cmd_FreeCommand( back );
 }
 
 /*
@@ -796,11 +1037,7 @@ void	Cmd_RemoveCommandsByFunc( xcommand_t function ) {
 			return;
 		}
 		if ( cmd->function == function ) {
-			*back = cmd->next;
-			if (cmd->name) {
-				Z_Free(cmd->name);
-			}
-			Z_Free (cmd);
+			Cmd_FreeCommand( back );
 			continue;
 		}
 		back = &cmd->next;
@@ -851,10 +1088,9 @@ Cmd_CompleteArgument
 void Cmd_CompleteArgument( const char *command, char *args, int argNum ) {
 	cmd_function_t	*cmd;
 
-	for( cmd = cmd_functions; cmd; cmd = cmd->next ) {
-		if( !Q_stricmp( command, cmd->name ) && cmd->complete ) {
-			cmd->complete( args, argNum );
-		}
+	cmd = Cmd_FindCommand( command );
+	if( cmd && cmd->complete ) {
+		cmd->complete( args, argNum );
 	}
 }
 
@@ -867,7 +1103,7 @@ A complete command line has been parsed, so try to execute it
 ============
 */
 void	Cmd_ExecuteString( const char *text ) {	
-	cmd_function_t	*cmdFunc, **prev;
+	cmd_function_t	*cmdFunc;
 
 	// execute the command line
 	Cmd_TokenizeString( text );		
@@ -876,19 +1112,11 @@ void	Cmd_ExecuteString( const char *text ) {
 	}
 
 	// check registered command functions	
-	for ( prev = &cmd_functions ; *prev ; prev = &cmdFunc->next ) {
-		cmdFunc = *prev;
-		if ( !Q_stricmp( cmd.argv[0], cmdFunc->name ) ) {
-			// rearrange the links so that the command will be
-			// near the head of the list next time it is used
-			*prev = cmdFunc->next;
-			cmdFunc->next = cmd_functions;
-			cmd_functions = cmdFunc;
-
-			// perform the action
-			cmdFunc->function ();
-			return;
-		}
+	cmdFunc = Cmd_FindCommand( cmd.argv[0] );
+	if ( cmdFunc ) {
+		// perform the action
+		cmdFunc->function ();
+		return;
 	}
 
 	// check cvars
@@ -952,5 +1180,7 @@ void Cmd_Init (void) {
 	Cmd_SetCommandCompletionFunc( "vstr", Cvar_CompleteCvarName );
 	Cmd_AddCommand ("echo",Cmd_Echo_f);
 	Cmd_AddCommand ("wait", Cmd_Wait_f);
+	Cmd_AddCommand ("execbench", Cmd_ExecBench_f);
+	Cmd_SetCommandCompletionFunc( "execbench", Cmd_CompleteCfgName );
 }
 
@@ -141,9 +141,12 @@ int			com_gameRestarting = 0;
 
 char	com_errorMessage[MAXPRINTMSG];
 
+static cvar_t	*com_pacing;
+
 int		com_playVideo = 0;
 
 void Com_WriteConfig_f( void );
+void Com_FrameStats_f( void );
 void CIN_CloseAllVideos( void );
 
 //============================================================================
@@ -386,6 +389,7 @@ void Com_Quit_f( void ) {
 		VM_Forced_Unload_Done();
 		Com_Shutdown ();
 		FS_Shutdown(qtrue);
+		Job_Shutdown();
 	}
 	Sys_Quit ();
 }
@@ -719,6 +723,25 @@ int Com_FilterPath(char *filter, char *name, int casesensitive)
 	return Com_Filter(new_filter, new_name, casesensitive);
 }
 
+/*
+================
+Com_HashStringNoCase
+
+FNV-1a hash of the lower case string, for cvar and command tables
+================
+*/
+unsigned int Com_HashStringNoCase( const char *string ) {
+	unsigned int	hash;
+
+	hash = 2166136261u;
+	while ( *string ) {
+		hash ^= (unsigned char)tolower( *string++ );
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
 /*
 ================
 Com_RealTime
@@ -759,12 +782,22 @@ The rover can be left pointing at a non-empty block
 
 The zone calls are pretty much only used for small strings and structures,
 all big things are allocated on the hunk.
+
+Allocations of up to 256 bytes come from slabs instead of the block list.
+Each zone keeps pages of equal sized slots for a few size classes, the
+slots have a regular memblock_t header so tags, Z_Free and the trash
+tester work the same. Pages are TAG_SLAB blocks in their zone.
 ==============================================================================
 */
 
 #define	ZONEID	0x1d4a11
+#define	SLABID	0x51ab1d
 #define MINFRAGMENT	64
 
+#define	NUM_SLAB_CLASSES	8
+#define	MAX_SLAB_SIZE		256
+#define	SLAB_PAGE_SIZE		8192
+
 typedef struct zonedebug_s {
 	char *label;
 	char *file;
@@ -782,13 +815,42 @@ typedef struct memblock_s {
 #endif
 } memblock_t;
 
+struct slabClass_s;
+
+typedef struct slabPage_s {
+	struct slabPage_s	*next, *prev;			// all pages of the class
+	struct slabPage_s	*nextFree, *prevFree;	// pages with free slots
+	struct slabClass_s	*slabClass;
+	int					zoneTag;		// tag of the page block while it isn't TAG_SLAB
+	memblock_t			*free;			// free slots, linked through next
+	int					used;			// slots in use
+	int					numSlots;
+} slabPage_t;
+
+typedef struct slabClass_s {
+	int			size;			// slot size including header and trash tester
+	int			maxSize;		// largest request
+	slabPage_t	*pages;
+	slabPage_t	*freePages;		// pages with free slots
+	int			numPages;
+	int			numEmptyPages;
+	int			used;			// slots in use
+	int			peak;
+} slabClass_t;
+
 typedef struct {
 	int		size;			// total bytes malloced, including header
 	int		used;			// total bytes used
 	memblock_t	blocklist;	// start / end cap for linked list
 	memblock_t	*rover;
+	slabClass_t	slabs[NUM_SLAB_CLASSES];
 } memzone_t;
 
+static const int slabSizes[NUM_SLAB_CLASSES] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+// slab class for each request size rounded up to 16 bytes
+static byte slabClassForSize[MAX_SLAB_SIZE / 16 + 1];
+
 // main zone for all "dynamic" memory allocation
 memzone_t	*mainzone;
 // we also have a small zone for small allocations that would only
@@ -797,6 +859,203 @@ memzone_t	*smallzone;
 
 void Z_CheckHeap( void );
 
+/*
+========================
+Z_InitSlabs
+========================
+*/
+static void Z_InitSlabs( memzone_t *zone ) {
+	slabClass_t	*slabClass;
+	int			i, j;
+
+	Com_Memset( zone->slabs, 0, sizeof( zone->slabs ) );
+
+	for ( i = 0, j = 0; i < NUM_SLAB_CLASSES; i++ ) {
+		slabClass = &zone->slabs[i];
+		slabClass->maxSize = slabSizes[i];
+		slabClass->size = PAD( slabSizes[i] + sizeof( memblock_t ) + 4, sizeof( intptr_t ) );
+
+		for ( ; j <= slabSizes[i] / 16; j++ ) {
+			slabClassForSize[j] = i;
+		}
+	}
+}
+
+/*
+========================
+Z_SlabSlot
+========================
+*/
+static memblock_t *Z_SlabSlot( slabPage_t *page, int slot ) {
+	return (memblock_t *)( (byte *)page + PAD( sizeof( slabPage_t ), sizeof( intptr_t ) ) + slot * page->slabClass->size );
+}
+
+/*
+========================
+Z_NewSlabPage
+========================
+*/
+static slabPage_t *Z_NewSlabPage( memzone_t *zone, slabClass_t *slabClass ) {
+	slabPage_t	*page;
+	memblock_t	*block;
+	int			i;
+
+	page = Z_TagMalloc( SLAB_PAGE_SIZE, zone == smallzone ? TAG_SMALL : TAG_GENERAL );
+
+	// Z_FreeTags must leave the page alone
+	( (memblock_t *)page - 1 )->tag = TAG_SLAB;
+
+	page->slabClass = slabClass;
+	page->zoneTag = zone == smallzone ? TAG_SMALL : TAG_GENERAL;
+	page->used = 0;
+	page->numSlots = ( SLAB_PAGE_SIZE - PAD( sizeof( slabPage_t ), sizeof( intptr_t ) ) ) / slabClass->size;
+	page->free = NULL;
+
+	for ( i = page->numSlots - 1; i >= 0; i-- ) {
+		block = Z_SlabSlot( page, i );
+		block->size = slabClass->size;
+		block->tag = 0;
+		block->id = SLABID;
+		block->prev = (memblock_t *)page;
+		block->next = page->free;
+		page->free = block;
+	}
+
+	page->prev = NULL;
+	page->next = slabClass->pages;
+	if ( page->next ) {
+		page->next->prev = page;
+	}
+	slabClass->pages = page;
+
+	page->prevFree = NULL;
+	page->nextFree = slabClass->freePages;
+	if ( page->nextFree ) {
+		page->nextFree->prevFree = page;
+	}
+	slabClass->freePages = page;
+
+	slabClass->numPages++;
+	slabClass->numEmptyPages++;
+
+	return page;
+}
+
+/*
+========================
+Z_FreeSlabPage
+========================
+*/
+static void Z_FreeSlabPage( slabPage_t *page ) {
+	slabClass_t	*slabClass = page->slabClass;
+
+	if ( page->prev ) {
+		page->prev->next = page->next;
+	} else {
+		slabClass->pages = page->next;
+	}
+	if ( page->next ) {
+		page->next->prev = page->prev;
+	}
+
+	if ( page->prevFree ) {
+		page->prevFree->nextFree = page->nextFree;
+	} else {
+		slabClass->freePages = page->nextFree;
+	}
+	if ( page->nextFree ) {
+		page->nextFree->prevFree = page->prevFree;
+	}
+
+	slabClass->numPages--;
+	slabClass->numEmptyPages--;
+
+	( (memblock_t *)page - 1 )->tag = page->zoneTag;
+	Z_Free( page );
+}
+
+/*
+========================
+Z_SlabMalloc
+
+Returns a free slot for size bytes
+========================
+*/
+static memblock_t *Z_SlabMalloc( memzone_t *zone, int size ) {
+	slabClass_t	*slabClass;
+	slabPage_t	*page;
+	memblock_t	*block;
+
+	slabClass = &zone->slabs[ slabClassForSize[ ( size + 15 ) / 16 ] ];
+
+	page = slabClass->freePages;
+	if ( !page ) {
+		page = Z_NewSlabPage( zone, slabClass );
+	}
+
+	block = page->free;
+	page->free = block->next;
+	block->next = NULL;
+
+	if ( !page->used ) {
+		slabClass->numEmptyPages--;
+	}
+	page->used++;
+
+	if ( !page->free ) {
+		// full, take it off the free list
+		slabClass->freePages = page->nextFree;
+		if ( page->nextFree ) {
+			page->nextFree->prevFree = NULL;
+		}
+		page->nextFree = page->prevFree = NULL;
+	}
+
+	slabClass->used++;
+	if ( slabClass->used > slabClass->peak ) {
+		slabClass->peak = slabClass->used;
+	}
+
+	return block;
+}
+
+/*
+========================
+Z_SlabFree
+========================
+*/
+static void Z_SlabFree( memblock_t *block ) {
+	slabPage_t	*page = (slabPage_t *)block->prev;
+	slabClass_t	*slabClass = page->slabClass;
+
+	if ( !page->free ) {
+		// it was full, put it back on the free list
+		page->prevFree = NULL;
+		page->nextFree = slabClass->freePages;
+		if ( page->nextFree ) {
+			page->nextFree->prevFree = page;
+		}
+		slabClass->freePages = page;
+	}
+
+	block->tag = 0;
+	block->next = page->free;
+	page->free = block;
+
+	slabClass->used--;
+	page->used--;
+
+	if ( !page->used ) {
+		slabClass->numEmptyPages++;
+
+		// keep one empty page around so a single slot doesn't
+		// keep allocating and freeing pages
+		if ( slabClass->numEmptyPages > 1 ) {
+			Z_FreeSlabPage( page );
+		}
+	}
+}
+
 /*
 ========================
 Z_ClearZone
@@ -820,6 +1079,8 @@ void Z_ClearZone( memzone_t *zone, int size ) {
 	block->tag = 0;			// free block
 	block->id = ZONEID;
 	block->size = size - sizeof(memzone_t);
+
+	Z_InitSlabs( zone );
 }
 
 /*
@@ -863,7 +1124,7 @@ void Z_Free( void *ptr )
 	}
 
 	block = (memblock_t *) ( (byte *)ptr - sizeof(memblock_t));
-	if (block->id != ZONEID) {
+	if (block->id != ZONEID && block->id != SLABID) {
 #ifdef ZONE_DEBUG
 		Com_Error( ERR_FATAL, "Z_Free: freed a pointer without ZONEID (%s %s:%d)", label, file, line );
 #else
@@ -891,6 +1152,14 @@ void Z_Free( void *ptr )
 #endif
 	}
 
+	if (block->id == SLABID) {
+		// set the block to something that should cause problems
+		// if it is referenced...
+		Com_Memset( ptr, 0xaa, block->size - sizeof( *block ) );
+		Z_SlabFree( block );
+		return;
+	}
+
 	if (block->tag == TAG_SMALL) {
 		zone = smallzone;
 	}
@@ -937,6 +1206,9 @@ Z_FreeTags
 void Z_FreeTags( int tag ) {
 	int			count;
 	memzone_t	*zone;
+	slabPage_t	*page, *next;
+	memblock_t	*block;
+	int			i, j;
 
 	if ( tag == TAG_SMALL ) {
 		zone = smallzone;
@@ -945,6 +1217,30 @@ void Z_FreeTags( int tag ) {
 		zone = mainzone;
 	}
 	count = 0;
+
+	// free the slots in slab pages, each page is a
+	// TAG_SLAB block that Z_FreeTags leaves alone
+	for ( i = 0; i < NUM_SLAB_CLASSES; i++ ) {
+		for ( page = zone->slabs[i].pages; page; page = next ) {
+			next = page->next;
+
+			for ( j = 0; j < page->numSlots && page->used; j++ ) {
+				block = Z_SlabSlot( page, j );
+				if ( block->tag != tag ) {
+					continue;
+				}
+
+				count++;
+				if ( page->used == 1 ) {
+					// the page might be released
+					Z_Free( (void *)( block + 1 ) );
+					break;
+				}
+				Z_Free( (void *)( block + 1 ) );
+			}
+		}
+	}
+
 	// use the rover as our pointer, because
 	// Z_Free automatically adjusts it
 	zone->rover = zone->blocklist.next;
@@ -988,6 +1284,13 @@ void *Z_TagMalloc( int size, int tag ) {
 #ifdef ZONE_DEBUG
 	allocSize = size;
 #endif
+
+	if ( size > 0 && size <= MAX_SLAB_SIZE ) {
+		base = Z_SlabMalloc( zone, size );
+		base->tag = tag;
+		goto found;
+	}
+
 	//
 	// scan through the block list looking for the first free block
 	// of sufficient size
@@ -1044,6 +1347,7 @@ void *Z_TagMalloc( int size, int tag ) {
 	
 	base->id = ZONEID;
 
+found:
 #ifdef ZONE_DEBUG
 	base->d.label = label;
 	base->d.file = file;
@@ -1116,17 +1420,61 @@ void Z_CheckHeap( void ) {
 
 /*
 ========================
-Z_LogZoneHeap
+Z_SlabClassInfo
 ========================
 */
-void Z_LogZoneHeap( memzone_t *zone, char *name ) {
+static void Z_SlabClassInfo( slabClass_t *slabClass, char *buf, int bufSize ) {
+	slabPage_t	*page;
+	int			numSlots;
+
+	numSlots = 0;
+	for ( page = slabClass->pages; page; page = page->next ) {
+		numSlots += page->numSlots;
+	}
+
+	Com_sprintf( buf, bufSize, "%3d byte slabs: %6d of %6d slots used (%3d%%), %6d peak, %4d pages",
+		slabClass->maxSize, slabClass->used, numSlots, numSlots ? slabClass->used * 100 / numSlots : 0,
+		slabClass->peak, slabClass->numPages );
+}
+
 #ifdef ZONE_DEBUG
+/*
+========================
+Z_LogBlock
+========================
+*/
+static void Z_LogBlock( memblock_t *block ) {
 	char dump[32], *ptr;
+	char buf[4096];
 	int  i, j;
+
+	ptr = ((char *) block) + sizeof(memblock_t);
+	j = 0;
+	for (i = 0; i < 20 && i < block->d.allocSize; i++) {
+		if (ptr[i] >= 32 && ptr[i] < 127) {
+			dump[j++] = ptr[i];
+		}
+		else {
+			dump[j++] = '_';
+		}
+	}
+	dump[j] = '\0';
+	Com_sprintf(buf, sizeof(buf), "size = %8d: %s, line: %d (%s) [%s]\r\n", block->d.allocSize, block->d.file, block->d.line, block->d.label, dump);
+	FS_Write(buf, strlen(buf), logfile);
+}
 #endif
-	memblock_t	*block;
+
+/*
+========================
+Z_LogZoneHeap
+========================
+*/
+void Z_LogZoneHeap( memzone_t *zone, char *name ) {
+	memblock_t	*block, *slot;
+	slabPage_t	*page;
 	char		buf[4096];
 	int size, allocSize, numBlocks;
+	int i;
 
 	if (!logfile || !FS_Initialized())
 		return;
@@ -1137,21 +1485,24 @@ void Z_LogZoneHeap( memzone_t *zone, char *name ) {
 	Com_sprintf(buf, sizeof(buf), "\r\n================\r\n%s log\r\n================\r\n", name);
 	FS_Write(buf, strlen(buf), logfile);
 	for (block = zone->blocklist.next ; block->next != &zone->blocklist; block = block->next) {
-		if (block->tag) {
+		if (block->tag == TAG_SLAB) {
+			// log the slots instead of the page
+			page = (slabPage_t *)( block + 1 );
+			for (i = 0; i < page->numSlots; i++) {
+				slot = Z_SlabSlot( page, i );
+				if (slot->tag) {
 #ifdef ZONE_DEBUG
-			ptr = ((char *) block) + sizeof(memblock_t);
-			j = 0;
-			for (i = 0; i < 20 && i < block->d.allocSize; i++) {
-				if (ptr[i] >= 32 && ptr[i] < 127) {
-					dump[j++] = ptr[i];
-				}
-				else {
-					dump[j++] = '_';
+					Z_LogBlock( slot );
+					allocSize += slot->d.allocSize;
+#endif
+					size += slot->size;
+					numBlocks++;
 				}
 			}
-			dump[j] = '\0';
-			Com_sprintf(buf, sizeof(buf), "size = %8d: %s, line: %d (%s) [%s]\r\n", block->d.allocSize, block->d.file, block->d.line, block->d.label, dump);
-			FS_Write(buf, strlen(buf), logfile);
+		}
+		else if (block->tag) {
+#ifdef ZONE_DEBUG
+			Z_LogBlock( block );
 			allocSize += block->d.allocSize;
 #endif
 			size += block->size;
@@ -1168,6 +1519,12 @@ void Z_LogZoneHeap( memzone_t *zone, char *name ) {
 	FS_Write(buf, strlen(buf), logfile);
 	Com_sprintf(buf, sizeof(buf), "%d %s memory overhead\r\n", size - allocSize, name);
 	FS_Write(buf, strlen(buf), logfile);
+
+	for (i = 0; i < NUM_SLAB_CLASSES; i++) {
+		Z_SlabClassInfo( &zone->slabs[i], buf, sizeof(buf) - 2 );
+		Q_strcat( buf, sizeof(buf), "\r\n" );
+		FS_Write(buf, strlen(buf), logfile);
+	}
 }
 
 /*
@@ -1296,13 +1653,18 @@ static	int		s_zoneTotal;
 static	int		s_smallZoneTotal;
 
 
+static void Com_FrameArenaInfo( frameArena_t arenaNum, char *buf, int bufSize );
+
 /*
 =================
 Com_Meminfo_f
 =================
 */
 void Com_Meminfo_f( void ) {
-	memblock_t	*block;
+	memblock_t	*block, *slot;
+	slabPage_t	*page;
+	char		buf[256];
+	int			i;
 	int			zoneBytes, zoneBlocks;
 	int			smallZoneBytes, smallZoneBlocks;
 	int			botlibBytes, rendererBytes;
@@ -1322,7 +1684,19 @@ void Com_Meminfo_f( void ) {
 				(void *)block, block->size, block->tag);
 #endif
 		}
-		if ( block->tag ) {
+		if ( block->tag == TAG_SLAB ) {
+			zoneBytes += block->size;
+			page = (slabPage_t *)( block + 1 );
+			for ( i = 0; i < page->numSlots; i++ ) {
+				slot = Z_SlabSlot( page, i );
+				if ( slot->tag == TAG_BOTLIB ) {
+					botlibBytes += slot->size;
+				} else if ( slot->tag == TAG_RENDERER ) {
+					rendererBytes += slot->size;
+				}
+			}
+			zoneBlocks += page->used;
+		} else if ( block->tag ) {
 			zoneBytes += block->size;
 			zoneBlocks++;
 			if ( block->tag == TAG_BOTLIB ) {
@@ -1349,7 +1723,10 @@ void Com_Meminfo_f( void ) {
 	smallZoneBytes = 0;
 	smallZoneBlocks = 0;
 	for (block = smallzone->blocklist.next ; ; block = block->next) {
-		if ( block->tag ) {
+		if ( block->tag == TAG_SLAB ) {
+			smallZoneBytes += block->size;
+			smallZoneBlocks += ( (slabPage_t *)( block + 1 ) )->used;
+		} else if ( block->tag ) {
 			smallZoneBytes += block->size;
 			smallZoneBlocks++;
 		}
@@ -1391,6 +1768,22 @@ void Com_Meminfo_f( void ) {
 	Com_Printf( "        %8i bytes in dynamic renderer\n", rendererBytes );
 	Com_Printf( "        %8i bytes in dynamic other\n", zoneBytes - ( botlibBytes + rendererBytes ) );
 	Com_Printf( "        %8i bytes in small Zone memory\n", smallZoneBytes );
+	Com_Printf( "\n" );
+	Com_Printf( "main zone:\n" );
+	for ( i = 0; i < NUM_SLAB_CLASSES; i++ ) {
+		Z_SlabClassInfo( &mainzone->slabs[i], buf, sizeof( buf ) );
+		Com_Printf( "        %s\n", buf );
+	}
+	Com_Printf( "small zone:\n" );
+	for ( i = 0; i < NUM_SLAB_CLASSES; i++ ) {
+		Z_SlabClassInfo( &smallzone->slabs[i], buf, sizeof( buf ) );
+		Com_Printf( "        %s\n", buf );
+	}
+	Com_Printf( "\n" );
+	for ( i = 0; i < NUM_FRAME_ARENAS; i++ ) {
+		Com_FrameArenaInfo( i, buf, sizeof( buf ) );
+		Com_Printf( "%s\n", buf );
+	}
 }
 
 /*
@@ -2126,130 +2519,659 @@ void Com_InitJournaling( void ) {
 /*
 ========================================================================
 
-EVENT LOOP
+FRAME ARENAS
+
+Bump allocators for data that doesn't outlive the frame, there is nothing
+to free. Each arena is cleared at the end of Com_Frame. If an arena runs
+out, blocks are malloc'd for the rest of the frame and the arena grows to
+the frame's size when it's cleared.
 
 ========================================================================
 */
 
-#define MAX_QUEUED_EVENTS  256
-#define MASK_QUEUED_EVENTS ( MAX_QUEUED_EVENTS - 1 )
+#define	FRAME_ARENA_SIZE		0x40000
+#define	MAX_FRAME_ARENA_SIZE	0x1000000
+#define	FRAME_ALIGN				16
+
+typedef struct frameBlock_s {
+	struct frameBlock_s	*next;
+} frameBlock_t;
 
-static sysEvent_t  eventQueue[ MAX_QUEUED_EVENTS ];
-static int         eventHead = 0;
-static int         eventTail = 0;
+typedef struct {
+	char			*name;
+	byte			*base;
+	int				size;
+	int				used;			// bytes used in base
+	int				frameBytes;		// all bytes allocated this frame
+	frameBlock_t	*blocks;		// malloc'd when base was full
+	int				peak;			// most bytes allocated in a frame
+	int				numOverflows;	// frames that didn't fit in base
+} frameArenaData_t;
+
+static frameArenaData_t	frameArenas[ NUM_FRAME_ARENAS ] = {
+	{ "client" },
+	{ "server" }
+};
+static frameArena_t		currentFrameArena = FRAME_ARENA_CLIENT;
+
+static cvar_t			*com_frameArenaStats;
 
 /*
-================
-Com_QueueEvent
+=================
+Com_FrameAlloc
 
-A time of 0 will get the current time
-Ptr should either be null, or point to a block of data that can
-be freed by the game later.
-================
+Returns memory that stays valid until the end of the frame
+=================
 */
-void Com_QueueEvent( int time, sysEventType_t type, int value, int value2, int ptrLength, void *ptr )
-{
-	sysEvent_t  *ev;
+void *Com_FrameAlloc( int size ) {
+	frameArenaData_t	*arena;
+	frameBlock_t		*block;
+	byte				*buf;
 
-	ev = &eventQueue[ eventHead & MASK_QUEUED_EVENTS ];
+	arena = &frameArenas[ currentFrameArena ];
 
-	if ( eventHead - eventTail >= MAX_QUEUED_EVENTS )
-	{
-		Com_Printf("Com_QueueEvent: overflow\n");
-		// we are discarding an event, but don't leak memory
-		if ( ev->evPtr )
-		{
-			Z_Free( ev->evPtr );
-		}
-		eventTail++;
+	if ( size < 0 ) {
+		Com_Error( ERR_FATAL, "Com_FrameAlloc: bad size %i", size );
 	}
 
-	eventHead++;
+	size = PAD( size, FRAME_ALIGN );
+	arena->frameBytes += size;
 
-	if ( time == 0 )
-	{
-		time = Sys_Milliseconds();
+	if ( arena->used + size <= arena->size ) {
+		buf = arena->base + arena->used;
+		arena->used += size;
+		return buf;
+	}
+
+	block = malloc( PAD( sizeof( frameBlock_t ), FRAME_ALIGN ) + size );
+	if ( !block ) {
+		Com_Error( ERR_FATAL, "Com_FrameAlloc: failed on allocation of %i bytes from the %s arena", size, arena->name );
 	}
+	block->next = arena->blocks;
+	arena->blocks = block;
 
-	ev->evTime = time;
-	ev->evType = type;
-	ev->evValue = value;
-	ev->evValue2 = value2;
-	ev->evPtrLength = ptrLength;
-	ev->evPtr = ptr;
+	return (byte *)block + PAD( sizeof( frameBlock_t ), FRAME_ALIGN );
 }
 
 /*
-================
-Com_GetSystemEvent
+=================
+Com_SetFrameArena
 
-================
+Selects the arena used by Com_FrameAlloc
+=================
 */
-sysEvent_t Com_GetSystemEvent( void )
-{
-	sysEvent_t  ev;
-	char        *s;
+frameArena_t Com_SetFrameArena( frameArena_t arena ) {
+	frameArena_t	old;
 
-	// return if we have data
-	if ( eventHead > eventTail )
-	{
-		eventTail++;
-		return eventQueue[ ( eventTail - 1 ) & MASK_QUEUED_EVENTS ];
-	}
+	old = currentFrameArena;
+	currentFrameArena = arena;
 
-	// check for console commands
-	s = Sys_ConsoleInput();
-	if ( s )
-	{
-		char  *b;
-		int   len;
+	return old;
+}
 
-		len = strlen( s ) + 1;
-		b = Z_Malloc( len );
-		strcpy( b, s );
-		Com_QueueEvent( 0, SE_CONSOLE, 0, 0, len, b );
+/*
+=================
+Com_ClearFrameArena
+
+Frees everything allocated from the arena
+=================
+*/
+void Com_ClearFrameArena( frameArena_t arenaNum ) {
+	frameArenaData_t	*arena;
+	frameBlock_t		*block, *next;
+	int					size;
+
+	arena = &frameArenas[ arenaNum ];
+
+	if ( arena->frameBytes > arena->peak ) {
+		arena->peak = arena->frameBytes;
 	}
 
-	// return if we have data
-	if ( eventHead > eventTail )
-	{
-		eventTail++;
-		return eventQueue[ ( eventTail - 1 ) & MASK_QUEUED_EVENTS ];
+	if ( arena->blocks ) {
+		for ( block = arena->blocks; block; block = next ) {
+			next = block->next;
+			free( block );
+		}
+		arena->blocks = NULL;
+		arena->numOverflows++;
+
+		// grow so the next frame like this fits
+		size = MIN( PAD( arena->frameBytes, FRAME_ARENA_SIZE ), MAX_FRAME_ARENA_SIZE );
+		if ( size > arena->size ) {
+			free( arena->base );
+			arena->base = malloc( size );
+			arena->size = arena->base ? size : 0;
+		}
 	}
 
-	// create an empty event to return
-	memset( &ev, 0, sizeof( ev ) );
-	ev.evTime = Sys_Milliseconds();
+	arena->used = 0;
+	arena->frameBytes = 0;
+}
 
-	return ev;
+/*
+=================
+Com_FrameArenaInfo
+=================
+*/
+static void Com_FrameArenaInfo( frameArena_t arenaNum, char *buf, int bufSize ) {
+	frameArenaData_t	*arena = &frameArenas[ arenaNum ];
+
+	Com_sprintf( buf, bufSize, "%s frame arena: %8i used, %8i peak, %8i size, %i overflows",
+		arena->name, arena->frameBytes, arena->peak, arena->size, arena->numOverflows );
 }
 
 /*
 =================
-Com_GetRealEvent
+Com_InitFrameArenas
 =================
 */
-sysEvent_t	Com_GetRealEvent( void ) {
-	int			r;
-	sysEvent_t	ev;
+static void Com_InitFrameArenas( void ) {
+	int		i;
 
-	// either get an event from the system or the journal file
-	if ( com_journal->integer == 2 ) {
-		r = FS_Read( &ev, sizeof(ev), com_journalFile );
-		if ( r != sizeof(ev) ) {
-			Com_Error( ERR_FATAL, "Error reading from journal file" );
-		}
-		if ( ev.evPtrLength ) {
-			ev.evPtr = Z_Malloc( ev.evPtrLength );
-			r = FS_Read( ev.evPtr, ev.evPtrLength, com_journalFile );
-			if ( r != ev.evPtrLength ) {
-				Com_Error( ERR_FATAL, "Error reading from journal file" );
-			}
+	for ( i = 0; i < NUM_FRAME_ARENAS; i++ ) {
+		frameArenas[i].base = malloc( FRAME_ARENA_SIZE );
+		if ( !frameArenas[i].base ) {
+			Sys_Error( "Frame arena data failed to allocate %i bytes", FRAME_ARENA_SIZE );
 		}
-	} else {
-		ev = Com_GetSystemEvent();
+		frameArenas[i].size = FRAME_ARENA_SIZE;
+	}
 
-		// write the journal value out if needed
+	com_frameArenaStats = Cvar_Get( "com_frameArenaStats", "0", 0 );
+}
+
+/*
+=================
+Com_EndFrameArenas
+
+Prints the frame's usage if asked to and clears the arenas
+=================
+*/
+static void Com_EndFrameArenas( void ) {
+	char	buf[256];
+	int		i;
+
+	for ( i = 0; i < NUM_FRAME_ARENAS; i++ ) {
+		// 1 only prints arenas that were used, 2 prints every frame
+		if ( com_frameArenaStats->integer > 1 || ( com_frameArenaStats->integer && frameArenas[i].frameBytes ) ) {
+			Com_FrameArenaInfo( i, buf, sizeof( buf ) );
+			Com_Printf( "%s\n", buf );
+		}
+
+		Com_ClearFrameArena( i );
+	}
+
+	currentFrameArena = FRAME_ARENA_CLIENT;
+}
+
+/*
+========================================================================
+
+EVENT LOOP
+
+========================================================================
+*/
+
+/*
+
+The event queue is a bounded lock-free queue, any thread may add events
+but only the main thread takes them off. Each slot has a sequence number
+that tells producers whether the slot is free and the consumer whether
+the event in it has been written.
+
+Event data is allocated from a small slab so producers don't need the
+zone, data that doesn't fit the slab is Z_Malloc'd by the main thread.
+
+*/
+
+#define MAX_QUEUED_EVENTS  256
+#define MASK_QUEUED_EVENTS ( MAX_QUEUED_EVENTS - 1 )
+
+typedef struct {
+	volatile int	sequence;	// index + 1 once the event is written
+	sysEvent_t		event;
+} queuedEvent_t;
+
+static queuedEvent_t	eventQueue[ MAX_QUEUED_EVENTS ];
+static volatile int		eventHead = 0;		// next slot claimed by a producer
+static int				eventTail = 0;		// next slot read by the main thread
+static volatile int		eventsDropped = 0;
+
+#define MAX_EVENT_DATA		32
+#define EVENT_DATA_SIZE		1024
+
+static byte				eventData[ MAX_EVENT_DATA ][ EVENT_DATA_SIZE ];
+static volatile int		eventDataUsed[ MAX_EVENT_DATA ];
+
+/*
+================
+Com_InitEventQueue
+================
+*/
+static void Com_InitEventQueue( void )
+{
+	int i;
+
+	Com_Memset( eventQueue, 0, sizeof( eventQueue ) );
+	for ( i = 0; i < MAX_QUEUED_EVENTS; i++ )
+	{
+		eventQueue[ i ].sequence = i;
+	}
+
+	eventHead = 0;
+	eventTail = 0;
+	eventsDropped = 0;
+	Com_Memset( (void *)eventDataUsed, 0, sizeof( eventDataUsed ) );
+}
+
+/*
+================
+Com_AllocEventData
+
+Returns a block for event data from any thread, or NULL if size is too
+large or the slab is full
+================
+*/
+void *Com_AllocEventData( int size )
+{
+	int i;
+
+	if ( size > EVENT_DATA_SIZE )
+	{
+		return NULL;
+	}
+
+	for ( i = 0; i < MAX_EVENT_DATA; i++ )
+	{
+		if ( !eventDataUsed[ i ] && Sys_AtomicCompareExchange( &eventDataUsed[ i ], 0, 1 ) )
+		{
+			return eventData[ i ];
+		}
+	}
+
+	return NULL;
+}
+
+/*
+================
+Com_FreeEventData
+
+Frees evPtr of an event, whether it is from the slab or the zone
+================
+*/
+void Com_FreeEventData( void *ptr )
+{
+	byte *data = ptr;
+
+	if ( !data )
+	{
+		return;
+	}
+
+	if ( data >= eventData[ 0 ] && data < eventData[ MAX_EVENT_DATA ] )
+	{
+		Sys_AtomicStore( &eventDataUsed[ ( data - eventData[ 0 ] ) / EVENT_DATA_SIZE ], 0 );
+		return;
+	}
+
+	Z_Free( data );
+}
+
+/*
+================
+Com_TryQueueEvent
+
+Returns qfalse if the queue is full
+================
+*/
+static qboolean Com_TryQueueEvent( int time, sysEventType_t type, int value, int value2, int ptrLength, void *ptr )
+{
+	queuedEvent_t	*slot;
+	int				head, diff;
+
+	while ( 1 )
+	{
+		head = Sys_AtomicLoad( &eventHead );
+		slot = &eventQueue[ head & MASK_QUEUED_EVENTS ];
+		diff = (int)( (unsigned)Sys_AtomicLoad( &slot->sequence ) - (unsigned)head );
+
+		if ( diff < 0 )
+		{
+			// the main thread hasn't read the event in this slot yet
+			return qfalse;
+		}
+
+		if ( diff == 0 && Sys_AtomicCompareExchange( &eventHead, head, (int)( (unsigned)head + 1 ) ) )
+		{
+			break;
+		}
+
+		// another thread claimed the slot first
+	}
+
+	slot->event.evTime = time;
+	slot->event.evType = type;
+	slot->event.evValue = value;
+	slot->event.evValue2 = value2;
+	slot->event.evValue3 = 0;
+	slot->event.evPtrLength = ptrLength;
+	slot->event.evPtr = ptr;
+
+	// publish it to the main thread
+	Sys_AtomicStore( &slot->sequence, (int)( (unsigned)head + 1 ) );
+
+	return qtrue;
+}
+
+/*
+================
+Com_QueueEvent
+
+A time of 0 will get the current time
+Ptr should either be null, or point to a block of data that can
+be freed with Com_FreeEventData later. Other threads must allocate
+it with Com_AllocEventData.
+
+Safe to call from any thread. If the queue is full the event is
+dropped.
+================
+*/
+void Com_QueueEvent( int time, sysEventType_t type, int value, int value2, int ptrLength, void *ptr )
+{
+	if ( time == 0 )
+	{
+		time = Sys_Milliseconds();
+	}
+
+	if ( !Com_TryQueueEvent( time, type, value, value2, ptrLength, ptr ) )
+	{
+		// discard the new event, but don't leak memory
+		Sys_AtomicAdd( &eventsDropped, 1 );
+		Com_FreeEventData( ptr );
+	}
+}
+
+/*
+================
+Com_ReadQueuedEvent
+
+Takes the next event off the queue, returns qfalse if there isn't one
+================
+*/
+static qboolean Com_ReadQueuedEvent( sysEvent_t *ev )
+{
+	queuedEvent_t	*slot;
+
+	slot = &eventQueue[ eventTail & MASK_QUEUED_EVENTS ];
+	if ( Sys_AtomicLoad( &slot->sequence ) != (int)( (unsigned)eventTail + 1 ) )
+	{
+		return qfalse;
+	}
+
+	*ev = slot->event;
+
+	// hand the slot back to the producers
+	Sys_AtomicStore( &slot->sequence, (int)( (unsigned)eventTail + MAX_QUEUED_EVENTS ) );
+	eventTail = (int)( (unsigned)eventTail + 1 );
+
+	return qtrue;
+}
+
+/*
+================
+Com_GetSystemEvent
+
+================
+*/
+sysEvent_t Com_GetSystemEvent( void )
+{
+	sysEvent_t  ev;
+	char        *s;
+	int         dropped;
+
+	dropped = Sys_AtomicLoad( &eventsDropped );
+	if ( dropped )
+	{
+		Sys_AtomicAdd( &eventsDropped, -dropped );
+		Com_Printf( "Com_QueueEvent: overflow, %d events dropped\n", dropped );
+	}
+
+	// return if we have data
+	if ( Com_ReadQueuedEvent( &ev ) )
+	{
+		return ev;
+	}
+
+	// check for console commands
+	s = Sys_ConsoleInput();
+	if ( s )
+	{
+		char  *b;
+		int   len;
+
+		len = strlen( s ) + 1;
+		b = Com_AllocEventData( len );
+		if ( !b )
+		{
+			b = Z_Malloc( len );
+		}
+		strcpy( b, s );
+		Com_QueueEvent( 0, SE_CONSOLE, 0, 0, len, b );
+	}
+
+	// return if we have data
+	if ( Com_ReadQueuedEvent( &ev ) )
+	{
+		return ev;
+	}
+
+	// create an empty event to return
+	memset( &ev, 0, sizeof( ev ) );
+	ev.evTime = Sys_Milliseconds();
+
+	return ev;
+}
+
+#define MAX_EVENT_TEST_THREADS	16
+
+void Com_PushEvent( sysEvent_t *event );
+
+typedef struct {
+	int		thread;
+	int		numEvents;
+} eventTestProducer_t;
+
+static volatile int	eventTestFinished;
+
+/*
+================
+Com_EventTest_Producer
+================
+*/
+static void Com_EventTest_Producer( void *data )
+{
+	eventTestProducer_t	*producer = data;
+	char				*text;
+	int					i;
+
+	for ( i = 0; i < producer->numEvents; i++ )
+	{
+		text = NULL;
+		if ( !( i & 7 ) )
+		{
+			text = Com_AllocEventData( 32 );
+			if ( text )
+			{
+				Com_sprintf( text, 32, "%d %d", producer->thread, i );
+			}
+		}
+
+		if ( producer->thread & 1 )
+		{
+			// odd threads may lose events to overflow
+			Com_QueueEvent( 1, SE_NONE, producer->thread, i, text ? 32 : 0, text );
+			continue;
+		}
+
+		while ( !Com_TryQueueEvent( 1, SE_NONE, producer->thread, i, text ? 32 : 0, text ) )
+		{
+		}
+	}
+
+	Sys_AtomicAdd( &eventTestFinished, 1 );
+}
+
+/*
+================
+Com_EventQueueTest_f
+
+Adds events from several threads while the main thread reads them,
+checking that none are reordered or corrupted. Even numbered threads
+wait for free slots, so none of their events may be lost.
+================
+*/
+static void Com_EventQueueTest_f( void )
+{
+	eventTestProducer_t	producers[ MAX_EVENT_TEST_THREADS ];
+	sysThread_t			threads[ MAX_EVENT_TEST_THREADS ];
+	int					last[ MAX_EVENT_TEST_THREADS ];
+	int					numThreads, numEvents, numRead, numDropped;
+	int					numBad, numLeaked, start, i;
+	int					thread, sequence;
+	qboolean			done;
+	sysEvent_t			ev;
+
+	numThreads = Cmd_Argc() > 1 ? atoi( Cmd_Argv( 1 ) ) : 4;
+	numEvents = Cmd_Argc() > 2 ? atoi( Cmd_Argv( 2 ) ) : 20000;
+	numThreads = Com_Clamp( 1, MAX_EVENT_TEST_THREADS, numThreads );
+	numEvents = MAX( numEvents, 1 );
+
+	numDropped = -Sys_AtomicLoad( &eventsDropped );
+	numRead = numBad = 0;
+	eventTestFinished = 0;
+
+	start = Sys_Milliseconds();
+
+	for ( i = 0; i < numThreads; i++ )
+	{
+		last[ i ] = -1;
+		producers[ i ].thread = i;
+		producers[ i ].numEvents = numEvents;
+		threads[ i ] = Sys_CreateThread( Com_EventTest_Producer, &producers[ i ] );
+		if ( !threads[ i ] )
+		{
+			// a producer can't run on this thread, it would wait forever
+			// for room in the queue, so test with the threads we have
+			Com_Printf( S_COLOR_YELLOW "Couldn't create event queue test thread %d\n", i );
+			numThreads = i;
+			break;
+		}
+	}
+
+	if ( !numThreads )
+	{
+		Com_Printf( S_COLOR_RED "Event queue test needs threads\n" );
+		return;
+	}
+
+	while ( 1 )
+	{
+		done = ( Sys_AtomicLoad( &eventTestFinished ) == numThreads );
+
+		if ( !Com_ReadQueuedEvent( &ev ) )
+		{
+			if ( done )
+			{
+				break;
+			}
+			continue;
+		}
+
+		if ( ev.evType != SE_NONE )
+		{
+			// real input, keep it for Com_EventLoop
+			Com_PushEvent( &ev );
+			continue;
+		}
+
+		numRead++;
+
+		if ( ev.evValue < 0 || ev.evValue >= numThreads || ev.evValue2 <= last[ ev.evValue ]
+			|| ( !( ev.evValue & 1 ) && ev.evValue2 != last[ ev.evValue ] + 1 ) )
+		{
+			numBad++;
+		}
+		else
+		{
+			last[ ev.evValue ] = ev.evValue2;
+		}
+
+		if ( ev.evPtr )
+		{
+			if ( sscanf( ev.evPtr, "%d %d", &thread, &sequence ) != 2
+				|| thread != ev.evValue || sequence != ev.evValue2 )
+			{
+				numBad++;
+			}
+			Com_FreeEventData( ev.evPtr );
+		}
+	}
+
+	for ( i = 0; i < numThreads; i++ )
+	{
+		if ( threads[ i ] )
+		{
+			Sys_JoinThread( threads[ i ] );
+		}
+	}
+
+	numDropped += Sys_AtomicLoad( &eventsDropped );
+	Sys_AtomicAdd( &eventsDropped, -numDropped );
+
+	numLeaked = 0;
+	for ( i = 0; i < MAX_EVENT_DATA; i++ )
+	{
+		numLeaked += Sys_AtomicLoad( &eventDataUsed[ i ] );
+	}
+
+	Com_Printf( "%d threads added %d events in %d msec: %d read, %d dropped, %d bad, %d data blocks in use\n",
+		numThreads, numThreads * numEvents, Sys_Milliseconds() - start, numRead, numDropped, numBad, numLeaked );
+
+	if ( numRead + numDropped != numThreads * numEvents || numBad )
+	{
+		Com_Printf( S_COLOR_RED "Event queue test FAILED\n" );
+	}
+	else
+	{
+		Com_Printf( "Event queue test passed\n" );
+	}
+}
+
+/*
+=================
+Com_GetRealEvent
+=================
+*/
+sysEvent_t	Com_GetRealEvent( void ) {
+	int			r;
+	sysEvent_t	ev;
+
+	// either get an event from the system or the journal file
+	if ( com_journal->integer == 2 ) {
+		r = FS_Read( &ev, sizeof(ev), com_journalFile );
+		if ( r != sizeof(ev) ) {
+			Com_Error( ERR_FATAL, "Error reading from journal file" );
+		}
+		if ( ev.evPtrLength ) {
+			ev.evPtr = Z_Malloc( ev.evPtrLength );
+			r = FS_Read( ev.evPtr, ev.evPtrLength, com_journalFile );
+			if ( r != ev.evPtrLength ) {
+				Com_Error( ERR_FATAL, "Error reading from journal file" );
+			}
+		}
+	} else {
+		ev = Com_GetSystemEvent();
+
+		// write the journal value out if needed
 		if ( com_journal->integer == 1 ) {
 			r = FS_Write( &ev, sizeof(ev), com_journalFile );
 			if ( r != sizeof(ev) ) {
@@ -2303,9 +3225,7 @@ void Com_PushEvent( sysEvent_t *event ) {
 			Com_Printf( "WARNING: Com_PushEvent overflow\n" );
 		}
 
-		if ( ev->evPtr ) {
-			Z_Free( ev->evPtr );
-		}
+		Com_FreeEventData( ev->evPtr );
 		com_pushedEventsTail++;
 	} else {
 		printedWarning = qfalse;
@@ -2336,13 +3256,17 @@ Com_RunAndTimeServerPacket
 void Com_RunAndTimeServerPacket( netadr_t *evFrom, msg_t *buf ) {
 	int		t1, t2, msec;
 
+	frameArena_t	arena;
+
 	t1 = 0;
 
 	if ( com_speeds->integer ) {
 		t1 = Sys_Milliseconds ();
 	}
 
+	arena = Com_SetFrameArena( FRAME_ARENA_SERVER );
 	SV_PacketEvent( *evFrom, buf );
+	Com_SetFrameArena( arena );
 
 	if ( com_speeds->integer ) {
 		t2 = Sys_Milliseconds ();
@@ -2413,9 +3337,7 @@ int Com_EventLoop( void ) {
 		}
 
 		// free any block data
-		if ( ev.evPtr ) {
-			Z_Free( ev.evPtr );
-		}
+		Com_FreeEventData( ev.evPtr );
 	}
 
 	return 0;	// never reached
@@ -2732,7 +3654,7 @@ void Com_Init( char *commandLine ) {
 	}
 
 	// Clear queues
-	Com_Memset( &eventQueue[ 0 ], 0, MAX_QUEUED_EVENTS * sizeof( sysEvent_t ) );
+	Com_InitEventQueue();
 
 	// initialize the weak pseudo-random number generator for use later.
 	Com_InitRand();
@@ -2779,10 +3701,12 @@ void Com_Init( char *commandLine ) {
 		Cmd_AddCommand ("error", Com_Error_f);
 		Cmd_AddCommand ("crash", Com_Crash_f);
 		Cmd_AddCommand ("freeze", Com_Freeze_f);
+		Cmd_AddCommand ("eventqueuetest", Com_EventQueueTest_f);
 	}
 	Cmd_AddCommand ("quit", Com_Quit_f);
 	Cmd_AddCommand ("changeVectors", MSG_ReportChangeVectors_f );
 	Cmd_AddCommand ("writeconfig", Com_WriteConfig_f );
+	Cmd_AddCommand ("framestats", Com_FrameStats_f );
 	Cmd_SetCommandCompletionFunc( "writeconfig", Cmd_CompleteCfgName );
 	Cmd_AddCommand("game_restart", Com_GameRestart_f);
 
@@ -2800,6 +3724,10 @@ void Com_Init( char *commandLine ) {
 #endif
 	// allocate the stack based hunk allocator
 	Com_InitHunkMemory();
+	Com_InitFrameArenas();
+
+	Job_Init();
+	Prof_Init();
 
 	// if any archived cvars are modified after this, we will trigger a writing
 	// of the config file
@@ -2836,6 +3764,7 @@ void Com_Init( char *commandLine ) {
 	com_maxfpsMinimized = Cvar_Get( "com_maxfpsMinimized", "0", CVAR_ARCHIVE );
 	com_abnormalExit = Cvar_Get( "com_abnormalExit", "0", CVAR_ROM );
 	com_busyWait = Cvar_Get("com_busyWait", "0", CVAR_ARCHIVE);
+	com_pacing = Cvar_Get("com_pacing", "0", CVAR_ARCHIVE);
 	Cvar_Get("com_errorMessage", "", CVAR_ROM | CVAR_NORESTART);
 
 	com_productName = Cvar_Get( "com_productName", PRODUCT_NAME, CVAR_ROM );
@@ -3089,6 +4018,8 @@ void Com_InitRef( refimport_t *ri ) {
 
 	ri->FS_ReadFile = FS_ReadFile;
 	ri->FS_FreeFile = FS_FreeFile;
+	ri->FS_MapFile = FS_MapFile;
+	ri->FS_UnmapFile = FS_UnmapFile;
 	ri->FS_WriteFile = FS_WriteFile;
 	ri->FS_FreeFileList = FS_FreeFileList;
 	ri->FS_ListFiles = FS_ListFiles;
@@ -3105,6 +4036,10 @@ void Com_InitRef( refimport_t *ri ) {
 	ri->Sys_SetEnv = Sys_SetEnv;
 	ri->Sys_LowPhysicalMemory = Sys_LowPhysicalMemory;
 
+	ri->Prof_Begin = Prof_Begin;
+	ri->Prof_End = Prof_End;
+	ri->profiling = &com_profiling;
+
 #ifdef DEDICATED
 	ret = GetRefAPI( REF_API_VERSION, ri, qtrue );
 #else
@@ -3231,6 +4166,163 @@ int Com_ModifyMsec( int msec ) {
 	return msec;
 }
 
+/*
+==============================================================================
+
+FRAME PACING
+
+With com_pacing set Com_Frame waits for the next frame with a microsecond
+clock. It sleeps on the network sockets with a microsecond timeout all
+the way to the deadline so packets are still read while waiting, frames
+are paced from the previous deadline rather than from when the previous
+frame woke up so the error of one sleep doesn't carry over to the next
+frame.
+
+==============================================================================
+*/
+
+#define	PACING_SLACK		1000	// usec late that still keeps the old deadline
+#define	FRAME_STATS			256
+
+static int64_t	com_frameStart;
+static int64_t	com_frameStats[FRAME_STATS];
+static int		com_numFrameStats;
+
+/*
+=================
+Com_FrameUsec
+
+Time between the start of two frames
+=================
+*/
+static int Com_FrameUsec( void ) {
+	if ( com_timedemo->integer ) {
+		return 1000;
+	}
+
+	if ( com_dedicated->integer ) {
+		return SV_FrameUsec();
+	}
+
+	if ( com_minimized->integer && com_maxfpsMinimized->integer > 0 ) {
+		return 1000000 / com_maxfpsMinimized->integer;
+	}
+
+	if ( com_unfocused->integer && com_maxfpsUnfocused->integer > 0 ) {
+		return 1000000 / com_maxfpsUnfocused->integer;
+	}
+
+	if ( com_maxfps->integer > 0 ) {
+		return 1000000 / com_maxfps->integer;
+	}
+
+	return 1000;
+}
+
+/*
+=================
+Com_PaceFrame
+
+Waits until frameUsec after the last deadline, still waking up to read
+network packets and to send queued server packets
+=================
+*/
+static void Com_PaceFrame( int frameUsec ) {
+	int64_t		deadline, now;
+	int64_t		sleepUsec;
+	int			timeValSV;
+
+	deadline = com_frameStart + frameUsec;
+
+	while ( ( now = Sys_Microseconds() ) < deadline ) {
+		sleepUsec = deadline - now;
+
+		if ( com_sv_running->integer ) {
+			timeValSV = SV_SendQueuedPackets();
+
+			if ( (int64_t)timeValSV * 1000 < sleepUsec ) {
+				sleepUsec = (int64_t)timeValSV * 1000;
+			}
+		}
+
+		if ( com_busyWait->integer ) {
+			NET_SleepMicroseconds( 0 );
+		} else {
+			NET_SleepMicroseconds( sleepUsec );
+		}
+	}
+
+	// keep the rate steady when waking up a little late,
+	// but don't try to catch up after a long frame
+	if ( now - deadline < PACING_SLACK ) {
+		com_frameStart = deadline;
+	} else {
+		com_frameStart = now;
+	}
+}
+
+/*
+=================
+Com_RecordFrameStart
+=================
+*/
+static void Com_RecordFrameStart( void ) {
+	static int64_t	lastStart = -1;
+	int64_t			now;
+
+	now = Sys_Microseconds();
+
+	if ( lastStart >= 0 ) {
+		com_frameStats[com_numFrameStats % FRAME_STATS] = now - lastStart;
+		com_numFrameStats++;
+	}
+
+	lastStart = now;
+}
+
+/*
+=================
+Com_FrameStats_f
+
+Prints the mean and variance of the time between recent frames
+=================
+*/
+void Com_FrameStats_f( void ) {
+	int			i, count;
+	double		mean, variance, delta;
+	int64_t		minTime, maxTime;
+
+	count = MIN( com_numFrameStats, FRAME_STATS );
+	if ( !count ) {
+		Com_Printf( "No frames recorded yet.\n" );
+		return;
+	}
+
+	mean = 0;
+	minTime = maxTime = com_frameStats[0];
+
+	for ( i = 0; i < count; i++ ) {
+		mean += com_frameStats[i];
+		minTime = MIN( minTime, com_frameStats[i] );
+		maxTime = MAX( maxTime, com_frameStats[i] );
+	}
+	mean /= count;
+
+	variance = 0;
+	for ( i = 0; i < count; i++ ) {
+		delta = com_frameStats[i] - mean;
+		variance += delta * delta;
+	}
+	variance /= count;
+
+	Com_Printf( "%d frames, target %.3f msec (%s pacing)\n", count, Com_FrameUsec() / 1000.0,
+		com_pacing->integer ? "usec" : "msec" );
+	Com_Printf( "frame time: mean %.3f msec, min %.3f, max %.3f\n", mean / 1000.0,
+		minTime / 1000.0, maxTime / 1000.0 );
+	Com_Printf( "variance %.4f msec^2, standard deviation %.3f msec\n", variance / 1000000.0,
+		sqrt( variance ) / 1000.0 );
+}
+
 /*
 =================
 Com_TimeVal
@@ -3273,6 +4365,12 @@ void Com_Frame( void ) {
 		return;			// an ERR_DROP was thrown
 	}
 
+	// an ERR_DROP might have left the server arena selected
+	Com_SetFrameArena( FRAME_ARENA_CLIENT );
+
+	Prof_Frame();
+	PROF_BEGIN( "Com_Frame" );
+
 	timeBeforeFirstEvents =0;
 	timeBeforeServer =0;
 	timeBeforeEvents =0;
@@ -3319,25 +4417,34 @@ void Com_Frame( void ) {
 	else
 		minMsec = 1;
 
-	do
+	if(com_pacing->integer)
+		Com_PaceFrame(Com_FrameUsec());
+	else
 	{
-		if(com_sv_running->integer)
+		do
 		{
-			timeValSV = SV_SendQueuedPackets();
+			if(com_sv_running->integer)
+			{
+				timeValSV = SV_SendQueuedPackets();
+				
+				timeVal = Com_TimeVal(minMsec);
+
+				if(timeValSV < timeVal)
+					timeVal = timeValSV;
+			}
+			else
+				timeVal = Com_TimeVal(minMsec);
 			
-			timeVal = Com_TimeVal(minMsec);
+			if(com_busyWait->integer || timeVal < 1)
+				NET_Sleep(0);
+			else
+				NET_Sleep(timeVal - 1);
+		} while(Com_TimeVal(minMsec));
 
-			if(timeValSV < timeVal)
-				timeVal = timeValSV;
-		}
-		else
-			timeVal = Com_TimeVal(minMsec);
-		
-		if(com_busyWait->integer || timeVal < 1)
-			NET_Sleep(0);
-		else
-			NET_Sleep(timeVal - 1);
-	} while(Com_TimeVal(minMsec));
+		com_frameStart = Sys_Microseconds();
+	}
+
+	Com_RecordFrameStart();
 	
 	lastTime = com_frameTime;
 	com_frameTime = Com_EventLoop();
@@ -3362,7 +4469,11 @@ void Com_Frame( void ) {
 		timeBeforeServer = Sys_Milliseconds ();
 	}
 
+	Com_SetFrameArena( FRAME_ARENA_SERVER );
+	PROF_BEGIN( "SV_Frame" );
 	SV_Frame( msec );
+	PROF_END( "SV_Frame" );
+	Com_SetFrameArena( FRAME_ARENA_CLIENT );
 
 	// if "dedicated" has been modified, start up
 	// or shut down the client system.
@@ -3400,7 +4511,9 @@ void Com_Frame( void ) {
 		timeBeforeClient = Sys_Milliseconds ();
 	}
 
+	PROF_BEGIN( "CL_Frame" );
 	CL_Frame( msec );
+	PROF_END( "CL_Frame" );
 
 	if ( com_speeds->integer ) {
 		timeAfter = Sys_Milliseconds ();
@@ -3451,6 +4564,10 @@ void Com_Frame( void ) {
 
 	Com_ReadFromPipe( );
 
+	Com_EndFrameArenas( );
+
+	PROF_END( "Com_Frame" );
+
 	com_frameNumber++;
 }
 
@@ -40,28 +40,72 @@ int			cvar_modifiedFlags;
 cvar_t		cvar_indexes[MAX_CVARS];
 int			cvar_numIndexes;
 
-#define FILE_HASH_SIZE		256
-static	cvar_t	*hashTable[FILE_HASH_SIZE];
+// open addressing with linear probing, there can't be more than
+// MAX_CVARS so the table is never more than half full
+#define	CVAR_HASH_SIZE		( MAX_CVARS * 2 )
+#define	CVAR_HASH_MASK		( CVAR_HASH_SIZE - 1 )
+static	cvar_t	*cvar_hashTable[CVAR_HASH_SIZE];
+
+// registered cvars that changed since each VM last synced
+typedef struct {
+	int			handles[MAX_CVARS];
+	int			numHandles;
+	qboolean	overflowed;
+} cvarSyncList_t;
+
+static	cvarSyncList_t	cvar_syncLists[CVAR_SYNC_LISTS];
 
 /*
-================
-return a hash value for the filename
-================
+============
+Cvar_HashSlot
+
+Returns the slot holding the named cvar, or the empty slot it would go in
+============
 */
-static long generateHashValue( const char *fname ) {
+static int Cvar_HashSlot( const char *var_name, unsigned int hash ) {
+	cvar_t	*var;
 	int		i;
-	long	hash;
-	char	letter;
 
-	hash = 0;
-	i = 0;
-	while (fname[i] != '\0') {
-		letter = tolower(fname[i]);
-		hash+=(long)(letter)*(i+119);
-		i++;
+	for ( i = hash & CVAR_HASH_MASK; ( var = cvar_hashTable[i] ) != NULL; i = ( i + 1 ) & CVAR_HASH_MASK ) {
+		if ( var->hashValue == hash && !Q_stricmp( var_name, var->name ) ) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+/*
+============
+Cvar_HashRemove
+
+Moves following cvars back into the hole so lookups don't need tombstones
+============
+*/
+static void Cvar_HashRemove( cvar_t *var ) {
+	int		i, j, home;
+
+	for ( i = var->hashValue & CVAR_HASH_MASK; cvar_hashTable[i] != var; i = ( i + 1 ) & CVAR_HASH_MASK ) {
+		if ( !cvar_hashTable[i] ) {
+			return;
+		}
+	}
+
+	j = i;
+	while ( 1 ) {
+		cvar_hashTable[i] = NULL;
+
+		do {
+			j = ( j + 1 ) & CVAR_HASH_MASK;
+			if ( !cvar_hashTable[j] ) {
+				return;
+			}
+			home = cvar_hashTable[j]->hashValue & CVAR_HASH_MASK;
+		} while ( i <= j ? ( i < home && home <= j ) : ( i < home || home <= j ) );
+
+		cvar_hashTable[i] = cvar_hashTable[j];
+		i = j;
 	}
-	hash &= (FILE_HASH_SIZE-1);
-	return hash;
 }
 
 /*
@@ -91,18 +135,7 @@ Cvar_FindVar
 ============
 */
 static cvar_t *Cvar_FindVar( const char *var_name ) {
-	cvar_t	*var;
-	long hash;
-
-	hash = generateHashValue(var_name);
-	
-	for (var=hashTable[hash] ; var ; var=var->hashNext) {
-		if (!Q_stricmp(var_name, var->name)) {
-			return var;
-		}
-	}
-
-	return NULL;
+	return cvar_hashTable[Cvar_HashSlot( var_name, Com_HashStringNoCase( var_name ) )];
 }
 
 /*
@@ -337,8 +370,8 @@ The flags will be or'ed in if the variable exists.
 */
 cvar_t *Cvar_Get( const char *var_name, const char *var_value, int flags ) {
 	cvar_t	*var;
-	long	hash;
-	int	index;
+	unsigned int	hash;
+	int	index, slot;
 
 	if ( !var_name || ! var_value ) {
 		Com_Error( ERR_FATAL, "Cvar_Get: NULL parameter" );
@@ -356,7 +389,9 @@ cvar_t *Cvar_Get( const char *var_name, const char *var_value, int flags ) {
 	}
 #endif
 
-	var = Cvar_FindVar (var_name);
+	hash = Com_HashStringNoCase( var_name );
+	slot = Cvar_HashSlot( var_name, hash );
+	var = cvar_hashTable[slot];
 	
 	if(var)
 	{
@@ -479,15 +514,8 @@ cvar_t *Cvar_Get( const char *var_name, const char *var_value, int flags ) {
 	// note what types of cvars have been modified (userinfo, archive, serverinfo, systeminfo)
 	cvar_modifiedFlags |= var->flags;
 
-	hash = generateHashValue(var_name);
-	var->hashIndex = hash;
-
-	var->hashNext = hashTable[hash];
-	if(hashTable[hash])
-		hashTable[hash]->hashPrev = var;
-
-	var->hashPrev = NULL;
-	hashTable[hash] = var;
+	var->hashValue = hash;
+	cvar_hashTable[slot] = var;
 
 	return var;
 }
@@ -558,6 +586,39 @@ void Cvar_Print( cvar_t *v ) {
 	}
 }
 
+/*
+============
+Cvar_QueueSync
+
+Adds a changed cvar to the sync list of each VM that registered it
+============
+*/
+static void Cvar_QueueSync( cvar_t *var ) {
+	cvarSyncList_t	*list;
+	int				sync, pending;
+
+	pending = var->syncMask & ~var->syncDirty;
+	if ( !pending ) {
+		return;
+	}
+
+	for ( sync = 0; sync < CVAR_SYNC_LISTS; sync++ ) {
+		if ( !( pending & ( 1 << sync ) ) ) {
+			continue;
+		}
+
+		list = &cvar_syncLists[sync];
+		if ( list->numHandles == MAX_CVARS ) {
+			list->overflowed = qtrue;
+			continue;
+		}
+
+		list->handles[list->numHandles++] = var - cvar_indexes;
+	}
+
+	var->syncDirty |= pending;
+}
+
 /*
 ============
 Cvar_Set2
@@ -663,6 +724,7 @@ cvar_t *Cvar_Set2( const char *var_name, const char *value, int defaultFlags, qb
 			var->latchedString = CopyString(value);
 			var->modified = qtrue;
 			var->modificationCount++;
+			Cvar_QueueSync( var );
 			return var;
 		}
 
@@ -686,6 +748,7 @@ cvar_t *Cvar_Set2( const char *var_name, const char *value, int defaultFlags, qb
 
 	var->modified = qtrue;
 	var->modificationCount++;
+	Cvar_QueueSync( var );
 	
 	Z_Free (var->string);	// free the old value string
 	
@@ -1197,12 +1260,7 @@ cvar_t *Cvar_Unset(cvar_t *cv)
 	if(cv->next)
 		cv->next->prev = cv->prev;
 
-	if(cv->hashPrev)
-		cv->hashPrev->hashNext = cv->hashNext;
-	else
-		hashTable[cv->hashIndex] = cv->hashNext;
-	if(cv->hashNext)
-		cv->hashNext->hashPrev = cv->hashPrev;
+	Cvar_HashRemove(cv);
 
 	Com_Memset(cv, '\0', sizeof(*cv));
 	
@@ -1412,7 +1470,7 @@ Cvar_Register
 basically a slightly modified Cvar_Get for the interpreted modules
 =====================
 */
-void Cvar_Register(vmCvar_t *vmCvar, const char *varName, const char *defaultValue, int flags)
+void Cvar_Register(vmCvar_t *vmCvar, const char *varName, const char *defaultValue, int flags, cvarSync_t sync)
 {
 	cvar_t	*cv;
 
@@ -1431,6 +1489,8 @@ void Cvar_Register(vmCvar_t *vmCvar, const char *varName, const char *defaultVal
 	if (!vmCvar)
 		return;
 
+	cv->syncMask |= 1 << sync;
+
 	vmCvar->handle = cv - cvar_indexes;
 	vmCvar->modificationCount = -1;
 	Cvar_Update( vmCvar );
@@ -1471,6 +1531,62 @@ void	Cvar_Update( vmCvar_t *vmCvar ) {
 	vmCvar->integer = cv->integer;
 }
 
+/*
+=====================
+Cvar_Sync
+
+Hands an interpreted module the handles of its cvars that changed since the
+last sync, so it only has to call Cvar_Update for those
+=====================
+*/
+int Cvar_Sync( cvarSync_t sync, int *handles, int maxHandles )
+{
+	cvarSyncList_t	*list;
+	int				i, numHandles;
+
+	if ( (unsigned)sync >= CVAR_SYNC_LISTS ) {
+		Com_Error( ERR_DROP, "Cvar_Sync: bad sync list %d", sync );
+	}
+
+	list = &cvar_syncLists[sync];
+
+	if ( list->overflowed || list->numHandles > maxHandles ) {
+		numHandles = -1;
+	} else {
+		numHandles = list->numHandles;
+	}
+
+	for ( i = 0; i < list->numHandles; i++ ) {
+		if ( numHandles > 0 ) {
+			handles[i] = list->handles[i];
+		}
+		cvar_indexes[list->handles[i]].syncDirty &= ~( 1 << sync );
+	}
+
+	list->numHandles = 0;
+	list->overflowed = qfalse;
+
+	return numHandles;
+}
+
+/*
+=====================
+Cvar_ResetSync
+=====================
+*/
+void Cvar_ResetSync( cvarSync_t sync )
+{
+	int		i;
+
+	for ( i = 0; i < cvar_numIndexes; i++ ) {
+		cvar_indexes[i].syncMask &= ~( 1 << sync );
+		cvar_indexes[i].syncDirty &= ~( 1 << sync );
+	}
+
+	cvar_syncLists[sync].numHandles = 0;
+	cvar_syncLists[sync].overflowed = qfalse;
+}
+
 /*
 ==================
 Cvar_CompleteCvarName
@@ -1498,7 +1614,7 @@ Reads in all archived cvars
 void Cvar_Init (void)
 {
 	Com_Memset(cvar_indexes, '\0', sizeof(cvar_indexes));
-	Com_Memset(hashTable, '\0', sizeof(hashTable));
+	Com_Memset(cvar_hashTable, '\0', sizeof(cvar_hashTable));
 
 	cvar_cheats = Cvar_Get("sv_cheats", "1", CVAR_ROM | CVAR_SYSTEMINFO );
 
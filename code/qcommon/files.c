@@ -232,6 +232,9 @@ typedef struct {
 	int				hashSize;					// hash table size (power of 2)
 	fileInPack_t*	*hashTable;					// hash table
 	fileInPack_t*	buildBuffer;				// buffer with the filenames etc.
+	qboolean		hasStats;					// pakSize and pakMtime are valid
+	int				pakSize;					// size of the zip on disk
+	int				pakMtime;					// modification time of the zip
 } pack_t;
 
 typedef struct {
@@ -264,6 +267,7 @@ static	int			fs_readCount;			// total bytes read
 static	int			fs_loadCount;			// total files read
 static	int			fs_loadStack;			// total files in memory
 static	int			fs_packFiles = 0;		// total number of files in packs
+static	cvar_t		*fs_pakCache;
 
 typedef union qfile_gus {
 	FILE*		o;
@@ -288,6 +292,34 @@ typedef struct {
 
 static fileHandleData_t	fsh[MAX_FILE_HANDLES];
 
+#define	MAX_FILE_MAPPINGS	16
+
+typedef struct {
+	void		*data;			// pointer returned by FS_MapFile
+	void		*base;			// start of the mapped view
+	int			baseLength;
+} fileMapping_t;
+
+static fileMapping_t	fs_mappings[MAX_FILE_MAPPINGS];
+
+#define	MAX_ASYNC_READS		256
+
+typedef struct {
+	char		name[MAX_ZPATH];	// qpath, empty if the slot is free
+	char		ospath[MAX_OSPATH];	// pk3 or loose file
+	long		offset;				// start of the data in ospath
+	long		compressedLen;
+	long		len;				// uncompressed length
+	int			method;				// 0 stored, Z_DEFLATED
+	qboolean	checkCrc;
+	unsigned long	crc;
+	qboolean	prefetch;			// taken by FS_ReadFile instead of a handle
+	int			pending;			// job counter
+	byte		*buffer;			// len + 1 bytes, NULL if the read failed
+} fsAsyncRead_t;
+
+static fsAsyncRead_t	fs_asyncReads[MAX_ASYNC_READS];
+
 // TTimo - https://zerowing.idsoftware.com/bugzilla/show_bug.cgi?id=540
 // wether we did a reorder on the current search path when joining the server
 static qboolean fs_reordered;
@@ -1869,6 +1901,123 @@ CONVENIENCE FUNCTIONS FOR ENTIRE FILES
 ======================================================================================
 */
 
+static long FS_ReadPrefetchedFile( const char *qpath, void **buffer );
+
+#define	INFLATE_CHUNK_SIZE		0x40000	// compressed bytes read at a time
+#define	INFLATE_DIRECT_SIZE		0x10000	// smaller entries are left to unzip
+
+typedef int (*inflateRead_t)( void *data, byte *buf, int len );
+
+/*
+============
+FS_InflateData
+
+Inflates a raw deflate stream of compressedLen bytes directly into out.
+unzip feeds zlib 16k at a time and zlib copies the last 32k of output to
+its sliding window after every call, reading large chunks into an output
+buffer that holds the whole file keeps matches inside inflate_fast and
+skips most of the window copies.
+
+Only uses malloc, so it can run on job threads.
+============
+*/
+static qboolean FS_InflateData( inflateRead_t read, void *data, byte *out, long len, long compressedLen ) {
+	z_stream	stream;
+	byte		*in;
+	int			chunk, err;
+
+	chunk = MIN( compressedLen, INFLATE_CHUNK_SIZE );
+	in = malloc( chunk );
+	if ( !in ) {
+		return qfalse;
+	}
+
+	Com_Memset( &stream, 0, sizeof( stream ) );
+	stream.next_out = out;
+	stream.avail_out = len;
+
+	// zip entries are raw deflate streams
+	if ( inflateInit2( &stream, -MAX_WBITS ) != Z_OK ) {
+		free( in );
+		return qfalse;
+	}
+
+	err = Z_OK;
+	while ( err == Z_OK && compressedLen > 0 ) {
+		chunk = MIN( compressedLen, INFLATE_CHUNK_SIZE );
+		if ( read( data, in, chunk ) != chunk ) {
+			break;
+		}
+		compressedLen -= chunk;
+
+		stream.next_in = in;
+		stream.avail_in = chunk;
+		err = inflate( &stream, compressedLen ? Z_NO_FLUSH : Z_FINISH );
+	}
+
+	inflateEnd( &stream );
+	free( in );
+
+	return ( err == Z_STREAM_END && stream.total_out == len );
+}
+
+/*
+============
+FS_InflateReadFile
+============
+*/
+static int FS_InflateReadFile( void *data, byte *buf, int len ) {
+	return fread( buf, 1, len, (FILE *)data );
+}
+
+/*
+============
+FS_InflateReadZip
+============
+*/
+static int FS_InflateReadZip( void *data, byte *buf, int len ) {
+	return unzReadCurrentFile( (unzFile)data, buf, len );
+}
+
+/*
+============
+FS_InflateZipFile
+
+Reads a large deflated pk3 entry with FS_InflateData instead of unzip.
+Returns qfalse without reading anything if it doesn't apply.
+============
+*/
+static qboolean FS_InflateZipFile( fileHandle_t f, byte *buf, long len ) {
+	unz_file_info	file_info;
+	unzFile			z;
+	int				method, level;
+
+	if ( !fsh[f].zipFile || len < INFLATE_DIRECT_SIZE ) {
+		return qfalse;
+	}
+
+	z = fsh[f].handleFiles.file.z;
+	if ( unzGetCurrentFileInfo( z, &file_info, NULL, 0, NULL, 0, NULL, 0 ) != UNZ_OK
+		|| file_info.compression_method != Z_DEFLATED || ( file_info.flag & 1 )
+		|| file_info.uncompressed_size != len ) {
+		return qfalse;
+	}
+
+	// reopen the entry to read the compressed data as is
+	unzCloseCurrentFile( z );
+	if ( unzOpenCurrentFile2( z, &method, &level, 1 ) == UNZ_OK
+		&& FS_InflateData( FS_InflateReadZip, z, buf, len, file_info.compressed_size )
+		&& crc32( 0L, buf, len ) == file_info.crc ) {
+		return qtrue;
+	}
+
+	Com_Printf( S_COLOR_YELLOW "WARNING: couldn't inflate %s, retrying with unzip\n", fsh[f].name );
+
+	unzCloseCurrentFile( z );
+	unzOpenCurrentFile( z );
+	return qfalse;
+}
+
 /*
 ============
 FS_ReadFileDir
@@ -1932,147 +2081,1255 @@ long FS_ReadFileDir(const char *qpath, void *searchPath, qboolean unpure, void *
 			fs_loadCount++;
 			fs_loadStack++;
 
-			// guarantee that it will have a trailing 0 for string operations
-			buf[len] = 0;
+			// guarantee that it will have a trailing 0 for string operations
+			buf[len] = 0;
+
+			return len;
+		}
+	} else {
+		isConfig = qfalse;
+	}
+
+	search = searchPath;
+
+	if(search == NULL && buffer != NULL && !isConfig)
+	{
+		// use the data if the file was prefetched
+		len = FS_ReadPrefetchedFile(qpath, buffer);
+		if(len >= 0)
+			return len;
+	}
+
+	if(search == NULL)
+	{
+		// look for it in the filesystem or pack files
+		len = FS_FOpenFileRead(qpath, &h, qfalse);
+	}
+	else
+	{
+		// look for it in a specific search path only
+		len = FS_FOpenFileReadDir(qpath, search, &h, qfalse, unpure);
+	}
+
+	if ( h == 0 ) {
+		if ( buffer ) {
+			*buffer = NULL;
+		}
+		// if we are journalling and it is a config file, write a zero to the journal file
+		if ( isConfig && com_journal && com_journal->integer == 1 ) {
+			Com_DPrintf( "Writing zero for %s to journal file.\n", qpath );
+			len = 0;
+			FS_Write( &len, sizeof( len ), com_journalDataFile );
+			FS_Flush( com_journalDataFile );
+		}
+		return -1;
+	}
+
+	if ( !buffer ) {
+		if ( isConfig && com_journal && com_journal->integer == 1 ) {
+			Com_DPrintf( "Writing len for %s to journal file.\n", qpath );
+			FS_Write( &len, sizeof( len ), com_journalDataFile );
+			FS_Flush( com_journalDataFile );
+		}
+		FS_FCloseFile( h);
+		return len;
+	}
+
+	fs_loadCount++;
+	fs_loadStack++;
+
+	buf = Hunk_AllocateTempMemory(len+1);
+	*buffer = buf;
+
+	if ( !FS_InflateZipFile( h, buf, len ) ) {
+		FS_Read (buf, len, h);
+	}
+
+	// guarantee that it will have a trailing 0 for string operations
+	buf[len] = 0;
+	FS_FCloseFile( h );
+
+	// if we are journalling and it is a config file, write it to the journal file
+	if ( isConfig && com_journal && com_journal->integer == 1 ) {
+		Com_DPrintf( "Writing %s to journal file.\n", qpath );
+		FS_Write( &len, sizeof( len ), com_journalDataFile );
+		FS_Write( buf, len, com_journalDataFile );
+		FS_Flush( com_journalDataFile );
+	}
+	return len;
+}
+
+/*
+============
+FS_ReadFile
+
+Filename are relative to the quake search path
+a null buffer will just return the file length without loading
+============
+*/
+long FS_ReadFile(const char *qpath, void **buffer)
+{
+	return FS_ReadFileDir(qpath, NULL, qfalse, buffer);
+}
+
+/*
+============
+FS_MapFileDir
+
+Stored pk3 entries and loose files are memory mapped instead of read,
+anything that needs to be decompressed falls back to FS_ReadFileDir.
+A prefetched file is taken from the prefetch buffer.
+============
+*/
+long FS_MapFileDir( const char *qpath, void *searchPath, qboolean unpure, void **buffer )
+{
+	fileHandle_t	h;
+	fileMapping_t	*mapping;
+	searchpath_t	*search;
+	unz_file_info	file_info;
+	FILE			*f;
+	qboolean		closeFile;
+	long			len, offset;
+	void			*data;
+	int				i;
+
+	if ( !fs_searchpaths ) {
+		Com_Error( ERR_FATAL, "Filesystem call made without initialization" );
+	}
+
+	if ( !qpath || !qpath[0] ) {
+		Com_Error( ERR_FATAL, "FS_MapFile with empty name" );
+	}
+
+	if ( !buffer ) {
+		return FS_ReadFileDir( qpath, searchPath, unpure, NULL );
+	}
+
+	// use the data if the file was prefetched instead of reading it twice
+	if ( searchPath == NULL ) {
+		len = FS_ReadPrefetchedFile( qpath, buffer );
+		if ( len >= 0 ) {
+			return len;
+		}
+	}
+
+	// journaled files must go through FS_ReadFile
+	mapping = NULL;
+	if ( !com_journal || !com_journal->integer ) {
+		for ( i = 0; i < MAX_FILE_MAPPINGS; i++ ) {
+			if ( !fs_mappings[i].data ) {
+				mapping = &fs_mappings[i];
+				break;
+			}
+		}
+	}
+
+	if ( !mapping ) {
+		return FS_ReadFileDir( qpath, searchPath, unpure, buffer );
+	}
+
+	if ( searchPath == NULL ) {
+		len = FS_FOpenFileRead( qpath, &h, qfalse );
+	} else {
+		len = FS_FOpenFileReadDir( qpath, searchPath, &h, qfalse, unpure );
+	}
+
+	if ( h == 0 ) {
+		*buffer = NULL;
+		return -1;
+	}
+
+	f = NULL;
+	offset = 0;
+	closeFile = qfalse;
+
+	if ( fsh[h].zipFile ) {
+		unzGetCurrentFileInfo( fsh[h].handleFiles.file.z, &file_info, NULL, 0, NULL, 0, NULL, 0 );
+
+		// only stored, unencrypted entries can be used directly
+		if ( file_info.compression_method == 0 && !( file_info.flag & 1 ) ) {
+			for ( search = fs_searchpaths; search; search = search->next ) {
+				if ( search->pack && search->pack->handle == fsh[h].handleFiles.file.z ) {
+					f = Sys_FOpen( search->pack->pakFilename, "rb" );
+					offset = unzGetCurrentFileZStreamPos( fsh[h].handleFiles.file.z );
+					closeFile = qtrue;
+					break;
+				}
+			}
+		}
+	} else {
+		f = fsh[h].handleFiles.file.o;
+	}
+
+	data = NULL;
+
+#if !id386 && !idx64
+	// lumps are accessed in place, keep them aligned on strict alignment cpus
+	if ( offset & 3 ) {
+		len = 0;
+	}
+#endif
+
+	if ( f && len > 0 && FS_fplength( f ) >= offset + len ) {
+		data = Sys_MapFile( f, offset, len, &mapping->base, &mapping->baseLength );
+	}
+
+	if ( closeFile ) {
+		fclose( f );
+	}
+	FS_FCloseFile( h );
+
+	if ( !data ) {
+		return FS_ReadFileDir( qpath, searchPath, unpure, buffer );
+	}
+
+	if ( fs_debug->integer ) {
+		Com_Printf( "FS_MapFile: %s (%ld bytes at %ld)\n", qpath, len, offset );
+	}
+
+	mapping->data = data;
+	fs_loadCount++;
+
+	*buffer = data;
+	return len;
+}
+
+/*
+============
+FS_MapFile
+============
+*/
+long FS_MapFile( const char *qpath, void **buffer )
+{
+	return FS_MapFileDir( qpath, NULL, qfalse, buffer );
+}
+
+/*
+=============
+FS_UnmapFile
+=============
+*/
+void FS_UnmapFile( void *buffer ) {
+	int		i;
+
+	if ( !buffer ) {
+		Com_Error( ERR_FATAL, "FS_UnmapFile( NULL )" );
+	}
+
+	for ( i = 0; i < MAX_FILE_MAPPINGS; i++ ) {
+		if ( fs_mappings[i].data == buffer ) {
+			Sys_UnmapFile( fs_mappings[i].base, fs_mappings[i].baseLength );
+			Com_Memset( &fs_mappings[i], 0, sizeof( fs_mappings[i] ) );
+			return;
+		}
+	}
+
+	// not mapped, it was read by FS_ReadFileDir
+	FS_FreeFile( buffer );
+}
+
+/*
+=================================================================================
+
+ASYNCHRONOUS READS
+
+The file is looked up on the main thread, a job then reads and inflates it
+without touching any filesystem state. Buffers are malloc'd, because zone
+and hunk memory are not thread safe.
+
+=================================================================================
+*/
+
+/*
+============
+FS_AsyncRead_Job
+============
+*/
+static void FS_AsyncRead_Job( void *data ) {
+	fsAsyncRead_t	*read = data;
+	FILE			*f;
+	byte			*out;
+	int				err;
+
+	out = malloc( read->len + 1 );
+	if ( !out ) {
+		return;
+	}
+
+	f = fopen( read->ospath, "rb" );
+	if ( !f || fseek( f, read->offset, SEEK_SET ) ) {
+		if ( f ) {
+			fclose( f );
+		}
+		free( out );
+		return;
+	}
+
+	if ( read->method == 0 ) {
+		err = ( fread( out, 1, read->len, f ) == read->len ) ? Z_OK : Z_DATA_ERROR;
+	} else {
+		err = FS_InflateData( FS_InflateReadFile, f, out, read->len, read->compressedLen ) ? Z_OK : Z_DATA_ERROR;
+	}
+
+	fclose( f );
+
+	if ( err == Z_OK && read->checkCrc && crc32( 0L, out, read->len ) != read->crc ) {
+		err = Z_DATA_ERROR;
+	}
+
+	if ( err != Z_OK ) {
+		free( out );
+		return;
+	}
+
+	// guarantee that it will have a trailing 0 for string operations
+	out[read->len] = 0;
+	read->buffer = out;
+}
+
+/*
+============
+FS_FreeAsyncRead
+============
+*/
+static void FS_FreeAsyncRead( fsAsyncRead_t *read ) {
+	Job_Wait( &read->pending );
+
+	free( read->buffer );
+	Com_Memset( read, 0, sizeof( *read ) );
+}
+
+/*
+============
+FS_FlushAsyncReads
+
+Waits for and frees prefetched files that haven't been used, or all
+asynchronous reads if prefetchOnly is qfalse.
+============
+*/
+void FS_FlushAsyncReads( qboolean prefetchOnly ) {
+	int		i;
+
+	for ( i = 0; i < MAX_ASYNC_READS; i++ ) {
+		if ( !fs_asyncReads[i].name[0] ) {
+			continue;
+		}
+		if ( prefetchOnly && !fs_asyncReads[i].prefetch ) {
+			continue;
+		}
+		FS_FreeAsyncRead( &fs_asyncReads[i] );
+	}
+}
+
+/*
+============
+FS_StartAsyncRead
+
+If searchPath is non-NULL only that search path is used, ignoring pure
+restrictions
+============
+*/
+static fsAsyncRead_t *FS_StartAsyncRead( const char *qpath, searchpath_t *searchPath, qboolean prefetch ) {
+	fsAsyncRead_t	*read;
+	searchpath_t	*search;
+	unz_file_info	file_info;
+	fileHandle_t	h;
+	long			len;
+	int				i;
+
+	if ( !fs_searchpaths ) {
+		Com_Error( ERR_FATAL, "Filesystem call made without initialization" );
+	}
+
+	if ( !qpath || !qpath[0] ) {
+		return NULL;
+	}
+
+	if ( qpath[0] == '/' || qpath[0] == '\\' ) {
+		qpath++;
+	}
+
+	// journaled files must go through FS_ReadFile
+	if ( com_journal && com_journal->integer ) {
+		return NULL;
+	}
+
+	read = NULL;
+	for ( i = 0; i < MAX_ASYNC_READS; i++ ) {
+		if ( !fs_asyncReads[i].name[0] ) {
+			if ( !read ) {
+				read = &fs_asyncReads[i];
+			}
+		} else if ( prefetch && fs_asyncReads[i].prefetch && !FS_FilenameCompare( fs_asyncReads[i].name, qpath ) ) {
+			// already prefetching
+			return NULL;
+		}
+	}
+
+	if ( !read ) {
+		return NULL;
+	}
+
+	h = 0;
+	len = -1;
+	if ( searchPath ) {
+		search = searchPath;
+		len = FS_FOpenFileReadDir( qpath, search, &h, qfalse, qtrue );
+	} else {
+		for ( search = fs_searchpaths; search; search = search->next ) {
+			len = FS_FOpenFileReadDir( qpath, search, &h, qfalse, qfalse );
+			if ( len >= 0 && h ) {
+				break;
+			}
+		}
+	}
+
+	if ( !search || !h ) {
+		return NULL;
+	}
+
+	Com_Memset( read, 0, sizeof( *read ) );
+	Q_strncpyz( read->name, qpath, sizeof( read->name ) );
+	read->len = len;
+	read->prefetch = prefetch;
+
+	if ( search->pack ) {
+		unzGetCurrentFileInfo( fsh[h].handleFiles.file.z, &file_info, NULL, 0, NULL, 0, NULL, 0 );
+
+		Q_strncpyz( read->ospath, search->pack->pakFilename, sizeof( read->ospath ) );
+		read->offset = unzGetCurrentFileZStreamPos( fsh[h].handleFiles.file.z );
+		read->compressedLen = file_info.compressed_size;
+		read->method = file_info.compression_method;
+		read->checkCrc = qtrue;
+		read->crc = file_info.crc;
+
+		if ( ( read->method != 0 && read->method != Z_DEFLATED ) || ( file_info.flag & 1 ) ) {
+			// not something we can read without unzip
+			FS_FCloseFile( h );
+			read->name[0] = '\0';
+			return NULL;
+		}
+	} else {
+		Q_strncpyz( read->ospath, FS_BuildOSPath( search->dir->path, search->dir->gamedir, qpath ), sizeof( read->ospath ) );
+	}
+
+	FS_FCloseFile( h );
+
+	if ( fs_debug->integer ) {
+		Com_Printf( "FS_ReadFileAsync: %s (found in '%s')\n", qpath, read->ospath );
+	}
+
+	Job_Add( FS_AsyncRead_Job, read, &read->pending );
+
+	return read;
+}
+
+/*
+============
+FS_ReadFileAsync
+
+Starts reading qpath on a job thread, returns 0 if it couldn't be started
+============
+*/
+int FS_ReadFileAsync( const char *qpath ) {
+	fsAsyncRead_t	*read;
+
+	read = FS_StartAsyncRead( qpath, NULL, qfalse );
+	if ( !read ) {
+		return 0;
+	}
+
+	return ( read - fs_asyncReads ) + 1;
+}
+
+/*
+============
+FS_AsyncReadComplete
+============
+*/
+qboolean FS_AsyncReadComplete( int handle ) {
+	if ( handle <= 0 || handle > MAX_ASYNC_READS || !fs_asyncReads[handle - 1].name[0] ) {
+		return qtrue;
+	}
+
+	return !Job_Pending( &fs_asyncReads[handle - 1].pending );
+}
+
+/*
+============
+FS_CopyAsyncRead
+
+Moves a finished read to a FS_ReadFile compatible buffer and frees it
+============
+*/
+static long FS_CopyAsyncRead( fsAsyncRead_t *read, void **buffer ) {
+	byte	*buf;
+	long	len;
+
+	Job_Wait( &read->pending );
+
+	if ( !read->buffer ) {
+		FS_FreeAsyncRead( read );
+		*buffer = NULL;
+		return -1;
+	}
+
+	len = read->len;
+
+	fs_loadCount++;
+	fs_loadStack++;
+
+	buf = Hunk_AllocateTempMemory( len + 1 );
+	Com_Memcpy( buf, read->buffer, len + 1 );
+	*buffer = buf;
+
+	FS_FreeAsyncRead( read );
+
+	return len;
+}
+
+/*
+============
+FS_FinishReadFileAsync
+
+Waits for the read to finish, returns the length and buffer like
+FS_ReadFile. The buffer must be freed with FS_FreeFile.
+If buffer is NULL the read is cancelled.
+============
+*/
+long FS_FinishReadFileAsync( int handle, void **buffer ) {
+	fsAsyncRead_t	*read;
+
+	if ( handle <= 0 || handle > MAX_ASYNC_READS || !fs_asyncReads[handle - 1].name[0] ) {
+		if ( buffer ) {
+			*buffer = NULL;
+		}
+		return -1;
+	}
+
+	read = &fs_asyncReads[handle - 1];
+
+	if ( !buffer ) {
+		FS_FreeAsyncRead( read );
+		return -1;
+	}
+
+	return FS_CopyAsyncRead( read, buffer );
+}
+
+/*
+============
+FS_PrefetchFile
+
+Reads qpath in the background, the next FS_ReadFile of it uses the data
+============
+*/
+void FS_PrefetchFile( const char *qpath ) {
+	FS_StartAsyncRead( qpath, NULL, qtrue );
+}
+
+/*
+============
+FS_ReadPrefetchedFile
+
+Returns -1 if qpath isn't prefetched
+============
+*/
+static long FS_ReadPrefetchedFile( const char *qpath, void **buffer ) {
+	int		i;
+
+	if ( qpath[0] == '/' || qpath[0] == '\\' ) {
+		qpath++;
+	}
+
+	for ( i = 0; i < MAX_ASYNC_READS; i++ ) {
+		if ( fs_asyncReads[i].prefetch && !FS_FilenameCompare( fs_asyncReads[i].name, qpath ) ) {
+			return FS_CopyAsyncRead( &fs_asyncReads[i], buffer );
+		}
+	}
+
+	return -1;
+}
+
+/*
+============
+FS_Prefetch_f
+============
+*/
+void FS_Prefetch_f( void ) {
+	int		i;
+
+	if ( Cmd_Argc() < 2 ) {
+		Com_Printf( "usage: fs_prefetch <file> [file ...]\n" );
+		return;
+	}
+
+	for ( i = 1; i < Cmd_Argc(); i++ ) {
+		FS_PrefetchFile( Cmd_Argv( i ) );
+	}
+}
+
+#define	BENCHMARK_BATCH		64
+
+/*
+============
+FS_BenchmarkPak
+
+Reads every file in the pk3 with unzip, with FS_ReadFile and on the job
+threads. Adds the bytes read and milliseconds taken by each to the totals.
+============
+*/
+static void FS_BenchmarkPak( searchpath_t *search, double bytes[3], int msec[3] ) {
+	pack_t			*pak;
+	fsAsyncRead_t	*reads[BENCHMARK_BATCH];
+	fileHandle_t	h;
+	FILE			*f;
+	void			*buf;
+	char			*name;
+	long			len;
+	int				i, j, start, numReads;
+	double			pakBytes[3];
+	int				pakMsec[3];
+
+	pak = search->pack;
+
+	// make sure every method starts with the pk3 in the OS cache
+	f = Sys_FOpen( pak->pakFilename, "rb" );
+	if ( f ) {
+		buf = malloc( INFLATE_CHUNK_SIZE );
+		while ( buf && fread( buf, 1, INFLATE_CHUNK_SIZE, f ) == INFLATE_CHUNK_SIZE ) {
+		}
+		free( buf );
+		fclose( f );
+	}
+
+	Com_Memset( pakBytes, 0, sizeof( pakBytes ) );
+
+	// unzip
+	start = Sys_Milliseconds();
+	for ( i = 0; i < pak->numfiles; i++ ) {
+		name = pak->buildBuffer[i].name;
+		if ( !name[0] || name[strlen( name ) - 1] == '/' ) {
+			continue;
+		}
+
+		len = FS_FOpenFileReadDir( name, search, &h, qfalse, qtrue );
+		if ( !h ) {
+			continue;
+		}
+		if ( len > 0 ) {
+			buf = Hunk_AllocateTempMemory( len + 1 );
+			if ( FS_Read( buf, len, h ) == len ) {
+				pakBytes[0] += len;
+			}
+			Hunk_FreeTempMemory( buf );
+		}
+		FS_FCloseFile( h );
+	}
+	pakMsec[0] = Sys_Milliseconds() - start;
+
+	// FS_ReadFile
+	start = Sys_Milliseconds();
+	for ( i = 0; i < pak->numfiles; i++ ) {
+		name = pak->buildBuffer[i].name;
+		if ( !name[0] || name[strlen( name ) - 1] == '/' ) {
+			continue;
+		}
+
+		len = FS_ReadFileDir( name, search, qtrue, &buf );
+		if ( buf ) {
+			pakBytes[1] += len;
+			FS_FreeFile( buf );
+		}
+	}
+	pakMsec[1] = Sys_Milliseconds() - start;
+
+	// job threads
+	start = Sys_Milliseconds();
+	for ( i = 0; i < pak->numfiles; ) {
+		for ( numReads = 0; numReads < BENCHMARK_BATCH && i < pak->numfiles; i++ ) {
+			name = pak->buildBuffer[i].name;
+			if ( !name[0] || name[strlen( name ) - 1] == '/' ) {
+				continue;
+			}
+
+			reads[numReads] = FS_StartAsyncRead( name, search, qfalse );
+			if ( reads[numReads] ) {
+				numReads++;
+			}
+		}
+
+		for ( j = 0; j < numReads; j++ ) {
+			Job_Wait( &reads[j]->pending );
+			if ( reads[j]->buffer ) {
+				pakBytes[2] += reads[j]->len;
+			}
+			FS_FreeAsyncRead( reads[j] );
+		}
+	}
+	pakMsec[2] = Sys_Milliseconds() - start;
+
+	Com_Printf( "%s.pk3: %d files, %.1f MB\n", pak->pakBasename, pak->numfiles, pakBytes[0] / ( 1024 * 1024 ) );
+	Com_Printf( "  unzip %.1f MB/s, FS_ReadFile %.1f MB/s, %d job threads %.1f MB/s\n",
+		pakBytes[0] / ( 1024 * 1024 ) / ( MAX( pakMsec[0], 1 ) * 0.001 ),
+		pakBytes[1] / ( 1024 * 1024 ) / ( MAX( pakMsec[1], 1 ) * 0.001 ),
+		Job_NumThreads(),
+		pakBytes[2] / ( 1024 * 1024 ) / ( MAX( pakMsec[2], 1 ) * 0.001 ) );
+
+	for ( i = 0; i < 3; i++ ) {
+		bytes[i] += pakBytes[i];
+		msec[i] += pakMsec[i];
+	}
+}
+
+/*
+============
+FS_Benchmark_f
+============
+*/
+void FS_Benchmark_f( void ) {
+	searchpath_t	*search;
+	double			bytes[3];
+	int				msec[3];
+	int				numPaks;
+
+	if ( Cmd_Argc() > 2 ) {
+		Com_Printf( "usage: fs_benchmark [pk3 basename]\n" );
+		return;
+	}
+
+	Com_Memset( bytes, 0, sizeof( bytes ) );
+	Com_Memset( msec, 0, sizeof( msec ) );
+	numPaks = 0;
+
+	for ( search = fs_searchpaths; search; search = search->next ) {
+		if ( !search->pack ) {
+			continue;
+		}
+		if ( Cmd_Argc() == 2 && Q_stricmp( search->pack->pakBasename, Cmd_Argv( 1 ) ) ) {
+			continue;
+		}
+
+		FS_BenchmarkPak( search, bytes, msec );
+		numPaks++;
+	}
+
+	if ( numPaks > 1 ) {
+		Com_Printf( "%d pk3 files, %.1f MB\n", numPaks, bytes[0] / ( 1024 * 1024 ) );
+		Com_Printf( "  unzip %.1f MB/s, FS_ReadFile %.1f MB/s, %d job threads %.1f MB/s\n",
+			bytes[0] / ( 1024 * 1024 ) / ( MAX( msec[0], 1 ) * 0.001 ),
+			bytes[1] / ( 1024 * 1024 ) / ( MAX( msec[1], 1 ) * 0.001 ),
+			Job_NumThreads(),
+			bytes[2] / ( 1024 * 1024 ) / ( MAX( msec[2], 1 ) * 0.001 ) );
+	} else if ( !numPaks ) {
+		Com_Printf( "No pk3 files loaded\n" );
+	}
+}
+
+/*
+=============
+FS_FreeFile
+=============
+*/
+void FS_FreeFile( void *buffer ) {
+	if ( !fs_searchpaths ) {
+		Com_Error( ERR_FATAL, "Filesystem call made without initialization" );
+	}
+	if ( !buffer ) {
+		Com_Error( ERR_FATAL, "FS_FreeFile( NULL )" );
+	}
+	fs_loadStack--;
+
+	Hunk_FreeTempMemory( buffer );
+
+	// if all of our temp files are free, clear all of our space
+	if ( fs_loadStack == 0 ) {
+		Hunk_ClearTempMemory();
+	}
+}
+
+/*
+============
+FS_WriteFile
+
+Filename are relative to the quake search path
+============
+*/
+void FS_WriteFile( const char *qpath, const void *buffer, int size ) {
+	fileHandle_t f;
+
+	if ( !fs_searchpaths ) {
+		Com_Error( ERR_FATAL, "Filesystem call made without initialization" );
+	}
+
+	if ( !qpath || !buffer ) {
+		Com_Error( ERR_FATAL, "FS_WriteFile: NULL parameter" );
+	}
+
+	f = FS_FOpenFileWrite( qpath );
+	if ( !f ) {
+		Com_Printf( "Failed to open %s\n", qpath );
+		return;
+	}
+
+	FS_Write( buffer, size, f );
+
+	FS_FCloseFile( f );
+}
+
+
+
+/*
+==========================================================================
+
+ZIP FILE LOADING
+
+==========================================================================
+*/
+
+/*
+=================================================================================
+
+PK3 DIRECTORY CACHE
+
+The parsed central directory of every pk3 is saved to fs_homepath/pakcache.dat,
+keyed by the pk3 os path, size and modification time. Unchanged pk3s are then
+added on the next startup without walking all of their zip file headers.
+
+file layout (all ints little endian):
+	int		ident, version, numRecords
+	numRecords times:
+		int		size, mtime, checksum, numfiles, hashSize, pathLen, namesLen
+		char	pakFilename[pathLen]			// including trailing 0
+		int		fileInfo[numfiles][2]			// zip offset, uncompressed length
+		char	names[namesLen]					// numfiles 0 terminated names
+
+=================================================================================
+*/
+
+#define PAKCACHE_FILENAME	"pakcache.dat"
+#define PAKCACHE_IDENT		(('C'<<24)+('K'<<16)+('P'<<8)+'S')	// "SPKC"
+#define PAKCACHE_VERSION	1
+#define PAKCACHE_HASH_SIZE	256
+
+typedef struct pakCacheRecord_s {
+	const char		*pakFilename;
+	int				size;
+	int				mtime;
+	int				checksum;
+	int				numfiles;
+	int				hashSize;
+	int				namesLen;
+	const byte		*fileInfo;
+	const char		*names;
+	const byte		*data;			// start of the record in the cache file
+	int				dataLen;		// length of the record in the cache file
+	qboolean		used;			// loaded by this startup
+	struct pakCacheRecord_s *next;	// next record in the hash
+} pakCacheRecord_t;
+
+static byte					*fs_pakCacheData;
+static pakCacheRecord_t		*fs_pakCacheRecords;
+static int					fs_numPakCacheRecords;
+static pakCacheRecord_t		*fs_pakCacheHash[PAKCACHE_HASH_SIZE];
+static int					fs_pakCacheHits;
+static int					fs_pakCacheMisses;
+
+/*
+=================
+FS_PakCachePath
+=================
+*/
+static const char *FS_PakCachePath( void ) {
+	static char ospath[MAX_OSPATH];
+
+	Com_sprintf( ospath, sizeof( ospath ), "%s%c%s", fs_homepath->string, PATH_SEP, PAKCACHE_FILENAME );
+	return ospath;
+}
+
+/*
+=================
+FS_PakCacheReadInt
+=================
+*/
+static qboolean FS_PakCacheReadInt( const byte **p, const byte *end, int *value ) {
+	if ( end - *p < 4 ) {
+		return qfalse;
+	}
+	Com_Memcpy( value, *p, 4 );
+	*value = LittleLong( *value );
+	*p += 4;
+	return qtrue;
+}
+
+/*
+=================
+FS_FreePakCache
+=================
+*/
+static void FS_FreePakCache( void ) {
+	if ( fs_pakCacheRecords ) {
+		Z_Free( fs_pakCacheRecords );
+	}
+	if ( fs_pakCacheData ) {
+		Z_Free( fs_pakCacheData );
+	}
+	fs_pakCacheData = NULL;
+	fs_pakCacheRecords = NULL;
+	fs_numPakCacheRecords = 0;
+	Com_Memset( fs_pakCacheHash, 0, sizeof( fs_pakCacheHash ) );
+}
+
+/*
+=================
+FS_LoadPakCache
+
+Reads the pk3 directory cache, a corrupt or outdated cache is ignored
+=================
+*/
+static void FS_LoadPakCache( void ) {
+	FILE				*f;
+	const byte			*p, *end;
+	pakCacheRecord_t	*rec;
+	int					len, ident, version, numRecords;
+	int					i, pathLen;
+	long				hash;
+
+	FS_FreePakCache();
+	fs_pakCacheHits = 0;
+	fs_pakCacheMisses = 0;
+
+	if ( !fs_pakCache->integer ) {
+		return;
+	}
+
+	f = Sys_FOpen( FS_PakCachePath(), "rb" );
+	if ( !f ) {
+		return;
+	}
+
+	len = FS_fplength( f );
+	if ( len < 12 ) {
+		fclose( f );
+		return;
+	}
 
-			return len;
-		}
-	} else {
-		isConfig = qfalse;
+	fs_pakCacheData = Z_Malloc( len );
+	if ( fread( fs_pakCacheData, 1, len, f ) != len ) {
+		fclose( f );
+		FS_FreePakCache();
+		return;
 	}
+	fclose( f );
 
-	search = searchPath;
+	p = fs_pakCacheData;
+	end = fs_pakCacheData + len;
 
-	if(search == NULL)
-	{
-		// look for it in the filesystem or pack files
-		len = FS_FOpenFileRead(qpath, &h, qfalse);
-	}
-	else
-	{
-		// look for it in a specific search path only
-		len = FS_FOpenFileReadDir(qpath, search, &h, qfalse, unpure);
+	FS_PakCacheReadInt( &p, end, &ident );
+	FS_PakCacheReadInt( &p, end, &version );
+	FS_PakCacheReadInt( &p, end, &numRecords );
+
+	if ( ident != PAKCACHE_IDENT || version != PAKCACHE_VERSION || numRecords <= 0 || numRecords > len / 28 ) {
+		FS_FreePakCache();
+		return;
 	}
 
-	if ( h == 0 ) {
-		if ( buffer ) {
-			*buffer = NULL;
+	fs_pakCacheRecords = Z_Malloc( numRecords * sizeof( pakCacheRecord_t ) );
+
+	for ( i = 0; i < numRecords; i++ ) {
+		rec = &fs_pakCacheRecords[i];
+		rec->data = p;
+
+		if ( !FS_PakCacheReadInt( &p, end, &rec->size )
+			|| !FS_PakCacheReadInt( &p, end, &rec->mtime )
+			|| !FS_PakCacheReadInt( &p, end, &rec->checksum )
+			|| !FS_PakCacheReadInt( &p, end, &rec->numfiles )
+			|| !FS_PakCacheReadInt( &p, end, &rec->hashSize )
+			|| !FS_PakCacheReadInt( &p, end, &pathLen )
+			|| !FS_PakCacheReadInt( &p, end, &rec->namesLen ) ) {
+			break;
 		}
-		// if we are journalling and it is a config file, write a zero to the journal file
-		if ( isConfig && com_journal && com_journal->integer == 1 ) {
-			Com_DPrintf( "Writing zero for %s to journal file.\n", qpath );
-			len = 0;
-			FS_Write( &len, sizeof( len ), com_journalDataFile );
-			FS_Flush( com_journalDataFile );
+
+		if ( pathLen <= 1 || pathLen > MAX_OSPATH || rec->numfiles < 0 || rec->namesLen < 0
+			|| end - p < pathLen || p[pathLen - 1] != '\0' ) {
+			break;
 		}
-		return -1;
-	}
+		rec->pakFilename = (const char *)p;
+		p += pathLen;
 
-	if ( !buffer ) {
-		if ( isConfig && com_journal && com_journal->integer == 1 ) {
-			Com_DPrintf( "Writing len for %s to journal file.\n", qpath );
-			FS_Write( &len, sizeof( len ), com_journalDataFile );
-			FS_Flush( com_journalDataFile );
+		if ( ( end - p ) / 8 < rec->numfiles ) {
+			break;
 		}
-		FS_FCloseFile( h);
-		return len;
+		rec->fileInfo = p;
+		p += rec->numfiles * 8;
+
+		if ( end - p < rec->namesLen || ( rec->namesLen > 0 && p[rec->namesLen - 1] != '\0' ) ) {
+			break;
+		}
+		rec->names = (const char *)p;
+		p += rec->namesLen;
+
+		rec->dataLen = p - rec->data;
+
+		hash = FS_HashFileName( rec->pakFilename, PAKCACHE_HASH_SIZE );
+		rec->next = fs_pakCacheHash[hash];
+		fs_pakCacheHash[hash] = rec;
 	}
 
-	fs_loadCount++;
-	fs_loadStack++;
+	if ( i != numRecords || p != end ) {
+		Com_Printf( "WARNING: ignoring corrupt %s\n", PAKCACHE_FILENAME );
+		FS_FreePakCache();
+		return;
+	}
 
-	buf = Hunk_AllocateTempMemory(len+1);
-	*buffer = buf;
+	fs_numPakCacheRecords = numRecords;
+}
 
-	FS_Read (buf, len, h);
+/*
+=================
+FS_FindPakCacheRecord
+=================
+*/
+static pakCacheRecord_t *FS_FindPakCacheRecord( const char *zipfile, int size, int mtime ) {
+	pakCacheRecord_t	*rec;
 
-	// guarantee that it will have a trailing 0 for string operations
-	buf[len] = 0;
-	FS_FCloseFile( h );
+	if ( !fs_numPakCacheRecords ) {
+		return NULL;
+	}
 
-	// if we are journalling and it is a config file, write it to the journal file
-	if ( isConfig && com_journal && com_journal->integer == 1 ) {
-		Com_DPrintf( "Writing %s to journal file.\n", qpath );
-		FS_Write( &len, sizeof( len ), com_journalDataFile );
-		FS_Write( buf, len, com_journalDataFile );
-		FS_Flush( com_journalDataFile );
+	for ( rec = fs_pakCacheHash[FS_HashFileName( zipfile, PAKCACHE_HASH_SIZE )]; rec; rec = rec->next ) {
+		if ( !strcmp( rec->pakFilename, zipfile ) ) {
+			if ( rec->size != size || rec->mtime != mtime ) {
+				return NULL;
+			}
+			return rec;
+		}
 	}
-	return len;
+
+	return NULL;
 }
 
 /*
-============
-FS_ReadFile
-
-Filename are relative to the quake search path
-a null buffer will just return the file length without loading
-============
+=================
+FS_PakCacheWriteInt
+=================
 */
-long FS_ReadFile(const char *qpath, void **buffer)
-{
-	return FS_ReadFileDir(qpath, NULL, qfalse, buffer);
+static void FS_PakCacheWriteInt( FILE *f, int value ) {
+	value = LittleLong( value );
+	fwrite( &value, 4, 1, f );
 }
 
 /*
-=============
-FS_FreeFile
-=============
+=================
+FS_WritePakCache
+
+Saves the directories of all pk3s in the search path, plus the
+records of the previous cache for pk3s that are still unchanged on disk
+=================
 */
-void FS_FreeFile( void *buffer ) {
-	if ( !fs_searchpaths ) {
-		Com_Error( ERR_FATAL, "Filesystem call made without initialization" );
+static void FS_WritePakCache( void ) {
+	searchpath_t		*search;
+	pakCacheRecord_t	*rec;
+	pack_t				*pak;
+	FILE				*f;
+	const char			*ospath;
+	char				tmppath[MAX_OSPATH];
+	int					i, numRecords, namesLen, size, mtime;
+	qboolean			dirty;
+
+	if ( !fs_pakCache->integer ) {
+		return;
 	}
-	if ( !buffer ) {
-		Com_Error( ERR_FATAL, "FS_FreeFile( NULL )" );
+
+	dirty = ( fs_pakCacheMisses > 0 );
+	numRecords = 0;
+
+	for ( search = fs_searchpaths; search; search = search->next ) {
+		if ( search->pack && search->pack->hasStats ) {
+			numRecords++;
+		}
 	}
-	fs_loadStack--;
 
-	Hunk_FreeTempMemory( buffer );
+	// keep the records of paks from other game directories around
+	for ( i = 0; i < fs_numPakCacheRecords; i++ ) {
+		rec = &fs_pakCacheRecords[i];
+		if ( rec->used ) {
+			continue;
+		}
+		if ( !Sys_FileStats( rec->pakFilename, &size, &mtime ) || size != rec->size || mtime != rec->mtime ) {
+			// mark as used so it is not written
+			rec->used = qtrue;
+			dirty = qtrue;
+			continue;
+		}
+		numRecords++;
+	}
 
-	// if all of our temp files are free, clear all of our space
-	if ( fs_loadStack == 0 ) {
-		Hunk_ClearTempMemory();
+	if ( !dirty || !numRecords ) {
+		return;
+	}
+
+	ospath = FS_PakCachePath();
+	Com_sprintf( tmppath, sizeof( tmppath ), "%s.tmp", ospath );
+
+	f = Sys_FOpen( tmppath, "wb" );
+	if ( !f ) {
+		Com_DPrintf( "Couldn't write %s\n", tmppath );
+		return;
+	}
+
+	FS_PakCacheWriteInt( f, PAKCACHE_IDENT );
+	FS_PakCacheWriteInt( f, PAKCACHE_VERSION );
+	FS_PakCacheWriteInt( f, numRecords );
+
+	for ( search = fs_searchpaths; search; search = search->next ) {
+		pak = search->pack;
+		if ( !pak || !pak->hasStats ) {
+			continue;
+		}
+
+		namesLen = 0;
+		for ( i = 0; i < pak->numfiles; i++ ) {
+			namesLen += strlen( pak->buildBuffer[i].name ) + 1;
+		}
+
+		FS_PakCacheWriteInt( f, pak->pakSize );
+		FS_PakCacheWriteInt( f, pak->pakMtime );
+		FS_PakCacheWriteInt( f, pak->checksum );
+		FS_PakCacheWriteInt( f, pak->numfiles );
+		FS_PakCacheWriteInt( f, pak->hashSize );
+		FS_PakCacheWriteInt( f, strlen( pak->pakFilename ) + 1 );
+		FS_PakCacheWriteInt( f, namesLen );
+		fwrite( pak->pakFilename, strlen( pak->pakFilename ) + 1, 1, f );
+
+		for ( i = 0; i < pak->numfiles; i++ ) {
+			FS_PakCacheWriteInt( f, pak->buildBuffer[i].pos );
+			FS_PakCacheWriteInt( f, pak->buildBuffer[i].len );
+		}
+
+		for ( i = 0; i < pak->numfiles; i++ ) {
+			fwrite( pak->buildBuffer[i].name, strlen( pak->buildBuffer[i].name ) + 1, 1, f );
+		}
+	}
+
+	for ( i = 0; i < fs_numPakCacheRecords; i++ ) {
+		rec = &fs_pakCacheRecords[i];
+		if ( !rec->used ) {
+			fwrite( rec->data, rec->dataLen, 1, f );
+		}
 	}
+
+	if ( ferror( f ) ) {
+		fclose( f );
+		FS_Remove( tmppath );
+		return;
+	}
+
+	fclose( f );
+
+	FS_Remove( ospath );
+	rename( tmppath, ospath );
 }
 
 /*
-============
-FS_WriteFile
+=================
+FS_AllocPak
 
-Filename are relative to the quake search path
-============
+Allocates a pak_t with a hash table fitting numfiles files
+=================
 */
-void FS_WriteFile( const char *qpath, const void *buffer, int size ) {
-	fileHandle_t f;
+static pack_t *FS_AllocPak( const char *zipfile, const char *basename, int numfiles )
+{
+	pack_t			*pack;
+	int				i;
 
-	if ( !fs_searchpaths ) {
-		Com_Error( ERR_FATAL, "Filesystem call made without initialization" );
+	// get the hash table size from the number of files in the zip
+	// because lots of custom pk3 files have less than 32 or 64 files
+	for (i = 1; i <= MAX_FILEHASH_SIZE; i <<= 1) {
+		if (i > numfiles) {
+			break;
+		}
 	}
 
-	if ( !qpath || !buffer ) {
-		Com_Error( ERR_FATAL, "FS_WriteFile: NULL parameter" );
+	pack = Z_Malloc( sizeof( pack_t ) + i * sizeof(fileInPack_t *) );
+	pack->hashSize = i;
+	pack->hashTable = (fileInPack_t **) (((char *) pack) + sizeof( pack_t ));
+	for(i = 0; i < pack->hashSize; i++) {
+		pack->hashTable[i] = NULL;
 	}
 
-	f = FS_FOpenFileWrite( qpath );
-	if ( !f ) {
-		Com_Printf( "Failed to open %s\n", qpath );
-		return;
+	Q_strncpyz( pack->pakFilename, zipfile, sizeof( pack->pakFilename ) );
+	Q_strncpyz( pack->pakBasename, basename, sizeof( pack->pakBasename ) );
+
+	// strip .pk3 if needed
+	if ( strlen( pack->pakBasename ) > 4 && !Q_stricmp( pack->pakBasename + strlen( pack->pakBasename ) - 4, ".pk3" ) ) {
+		pack->pakBasename[strlen( pack->pakBasename ) - 4] = 0;
 	}
 
-	FS_Write( buffer, size, f );
+	pack->numfiles = numfiles;
 
-	FS_FCloseFile( f );
+	return pack;
 }
 
+/*
+=================
+FS_LoadCachedZipFile
 
+Creates a pak_t from a pk3 directory cache record
+=================
+*/
+static pack_t *FS_LoadCachedZipFile( const char *zipfile, const char *basename, unzFile uf, const pakCacheRecord_t *rec )
+{
+	fileInPack_t	*buildBuffer;
+	pack_t			*pack;
+	const byte		*info;
+	const char		*name;
+	char			*namePtr;
+	int				i, value;
+	long			hash;
 
-/*
-==========================================================================
+	buildBuffer = Z_Malloc( (rec->numfiles * sizeof( fileInPack_t )) + rec->namesLen );
+	namePtr = ((char *) buildBuffer) + rec->numfiles * sizeof( fileInPack_t );
+	Com_Memcpy( namePtr, rec->names, rec->namesLen );
 
-ZIP FILE LOADING
+	pack = FS_AllocPak( zipfile, basename, rec->numfiles );
+	if ( pack->hashSize != rec->hashSize ) {
+		Z_Free( buildBuffer );
+		Z_Free( pack );
+		return NULL;
+	}
 
-==========================================================================
-*/
+	pack->handle = uf;
+
+	info = rec->fileInfo;
+	name = namePtr;
+	for (i = 0; i < rec->numfiles; i++)
+	{
+		if ( name >= namePtr + rec->namesLen ) {
+			// names don't match numfiles
+			Z_Free( buildBuffer );
+			Z_Free( pack );
+			return NULL;
+		}
+
+		hash = FS_HashFileName(name, pack->hashSize);
+		buildBuffer[i].name = (char *)name;
+		name += strlen( name ) + 1;
+
+		Com_Memcpy( &value, info, 4 );
+		buildBuffer[i].pos = (unsigned int)LittleLong( value );
+		Com_Memcpy( &value, info + 4, 4 );
+		buildBuffer[i].len = (unsigned int)LittleLong( value );
+		info += 8;
+
+		buildBuffer[i].next = pack->hashTable[hash];
+		pack->hashTable[hash] = &buildBuffer[i];
+	}
+
+	pack->checksum = rec->checksum;
+	pack->buildBuffer = buildBuffer;
+	return pack;
+}
 
 /*
 =================
@@ -2096,8 +3353,12 @@ static pack_t *FS_LoadZipFile(const char *zipfile, const char *basename)
 	int				fs_numHeaderLongs;
 	int				*fs_headerLongs;
 	char			*namePtr;
+	pakCacheRecord_t	*rec;
+	qboolean		hasStats;
+	int				pakSize, pakMtime;
 
 	fs_numHeaderLongs = 0;
+	pakSize = pakMtime = 0;
 
 	uf = unzOpen(zipfile);
 	err = unzGetGlobalInfo (uf,&gi);
@@ -2105,6 +3366,28 @@ static pack_t *FS_LoadZipFile(const char *zipfile, const char *basename)
 	if (err != UNZ_OK)
 		return NULL;
 
+	hasStats = Sys_FileStats( zipfile, &pakSize, &pakMtime );
+
+	if ( hasStats ) {
+		rec = FS_FindPakCacheRecord( zipfile, pakSize, pakMtime );
+
+		if ( rec && rec->numfiles == gi.number_entry ) {
+			pack = FS_LoadCachedZipFile( zipfile, basename, uf, rec );
+
+			if ( pack ) {
+				rec->used = qtrue;
+				fs_pakCacheHits++;
+
+				pack->hasStats = qtrue;
+				pack->pakSize = pakSize;
+				pack->pakMtime = pakMtime;
+				return pack;
+			}
+		}
+
+		fs_pakCacheMisses++;
+	}
+
 	len = 0;
 	unzGoToFirstFile(uf);
 	for (i = 0; i < gi.number_entry; i++)
@@ -2121,31 +3404,8 @@ static pack_t *FS_LoadZipFile(const char *zipfile, const char *basename)
 	namePtr = ((char *) buildBuffer) + gi.number_entry * sizeof( fileInPack_t );
 	fs_headerLongs = Z_Malloc( gi.number_entry * sizeof(int) );
 
-	// get the hash table size from the number of files in the zip
-	// because lots of custom pk3 files have less than 32 or 64 files
-	for (i = 1; i <= MAX_FILEHASH_SIZE; i <<= 1) {
-		if (i > gi.number_entry) {
-			break;
-		}
-	}
-
-	pack = Z_Malloc( sizeof( pack_t ) + i * sizeof(fileInPack_t *) );
-	pack->hashSize = i;
-	pack->hashTable = (fileInPack_t **) (((char *) pack) + sizeof( pack_t ));
-	for(i = 0; i < pack->hashSize; i++) {
-		pack->hashTable[i] = NULL;
-	}
-
-	Q_strncpyz( pack->pakFilename, zipfile, sizeof( pack->pakFilename ) );
-	Q_strncpyz( pack->pakBasename, basename, sizeof( pack->pakBasename ) );
-
-	// strip .pk3 if needed
-	if ( strlen( pack->pakBasename ) > 4 && !Q_stricmp( pack->pakBasename + strlen( pack->pakBasename ) - 4, ".pk3" ) ) {
-		pack->pakBasename[strlen( pack->pakBasename ) - 4] = 0;
-	}
-
+	pack = FS_AllocPak( zipfile, basename, gi.number_entry );
 	pack->handle = uf;
-	pack->numfiles = gi.number_entry;
 	unzGoToFirstFile(uf);
 
 	for (i = 0; i < gi.number_entry; i++)
@@ -2176,6 +3436,13 @@ static pack_t *FS_LoadZipFile(const char *zipfile, const char *basename)
 	Z_Free(fs_headerLongs);
 
 	pack->buildBuffer = buildBuffer;
+
+	// only cache paks whose directory was read completely
+	if ( i == gi.number_entry ) {
+		pack->hasStats = hasStats;
+		pack->pakSize = pakSize;
+		pack->pakMtime = pakMtime;
+	}
 	return pack;
 }
 
@@ -2256,12 +3523,29 @@ static int FS_ReturnPath( const char *zname, char *zpath, int *depth ) {
 	return len;
 }
 
+/*
+==================
+FS_CopyListName
+==================
+*/
+static char *FS_CopyListName( const char *name, qboolean frameAlloc ) {
+	char	*out;
+
+	if ( !frameAlloc ) {
+		return CopyString( name );
+	}
+
+	out = Com_FrameAlloc( strlen( name ) + 1 );
+	strcpy( out, name );
+	return out;
+}
+
 /*
 ==================
 FS_AddFileToList
 ==================
 */
-static int FS_AddFileToList( char *name, char *list[MAX_FOUND_FILES], int nfiles ) {
+static int FS_AddFileToList( char *name, char *list[MAX_FOUND_FILES], int nfiles, qboolean frameAlloc ) {
 	int		i, j, val;
 
 	if ( nfiles == MAX_FOUND_FILES - 1 ) {
@@ -2278,13 +3562,13 @@ static int FS_AddFileToList( char *name, char *list[MAX_FOUND_FILES], int nfiles
 				list[j+1] = list[j];
 			}
 
-			list[i] = CopyString( name );
+			list[i] = FS_CopyListName( name, frameAlloc );
 			nfiles++;
 
 			return nfiles;
 		}
 	}
-	list[nfiles] = CopyString( name );
+	list[nfiles] = FS_CopyListName( name, frameAlloc );
 	nfiles++;
 
 	return nfiles;
@@ -2296,9 +3580,12 @@ FS_ListFilteredFiles
 
 Returns a uniqued list of files that match the given criteria
 from all search paths
+
+If frameAlloc is qtrue the list is allocated with Com_FrameAlloc and
+must not be freed
 ===============
 */
-char **FS_ListFilteredFiles( const char *path, const char *extension, char *filter, int *numfiles, qboolean allowNonPureFilesOnDisk ) {
+char **FS_ListFilteredFiles( const char *path, const char *extension, char *filter, int *numfiles, qboolean allowNonPureFilesOnDisk, qboolean frameAlloc ) {
 	int				nfiles;
 	char			**listCopy;
 	char			*list[MAX_FOUND_FILES];
@@ -2359,7 +3646,7 @@ char **FS_ListFilteredFiles( const char *path, const char *extension, char *filt
 					if (!Com_FilterPath( filter, name, qfalse ))
 						continue;
 					// unique the match
-					nfiles = FS_AddFileToList( name, list, nfiles );
+					nfiles = FS_AddFileToList( name, list, nfiles, frameAlloc );
 				}
 				else {
 
@@ -2384,7 +3671,7 @@ char **FS_ListFilteredFiles( const char *path, const char *extension, char *filt
 					if (pathLength) {
 						temp++; // include the '/'
 					}
-					nfiles = FS_AddFileToList( name + temp, list, nfiles );
+					nfiles = FS_AddFileToList( name + temp, list, nfiles, frameAlloc );
 				}
 			}
 		} else if (search->dir) { // scan for files in the filesystem
@@ -2402,7 +3689,7 @@ char **FS_ListFilteredFiles( const char *path, const char *extension, char *filt
 				for ( i = 0 ; i < numSysFiles ; i++ ) {
 					// unique the match
 					name = sysFiles[i];
-					nfiles = FS_AddFileToList( name, list, nfiles );
+					nfiles = FS_AddFileToList( name, list, nfiles, frameAlloc );
 				}
 				Sys_FreeFileList( sysFiles );
 			}
@@ -2416,7 +3703,11 @@ char **FS_ListFilteredFiles( const char *path, const char *extension, char *filt
 		return NULL;
 	}
 
-	listCopy = Z_Malloc( ( nfiles + 1 ) * sizeof( *listCopy ) );
+	if ( frameAlloc ) {
+		listCopy = Com_FrameAlloc( ( nfiles + 1 ) * sizeof( *listCopy ) );
+	} else {
+		listCopy = Z_Malloc( ( nfiles + 1 ) * sizeof( *listCopy ) );
+	}
 	for ( i = 0 ; i < nfiles ; i++ ) {
 		listCopy[i] = list[i];
 	}
@@ -2431,14 +3722,15 @@ FS_ListFiles
 =================
 */
 char **FS_ListFiles( const char *path, const char *extension, int *numfiles ) {
-	return FS_ListFilteredFiles( path, extension, NULL, numfiles, qfalse );
+	return FS_ListFilteredFiles( path, extension, NULL, numfiles, qfalse, qfalse );
 }
 
 /*
 =================
 FS_ListFilesEx
 
-Create a list of files using multiple file extensions
+Create a list of files using multiple file extensions, the list is
+allocated with Com_FrameAlloc
 =================
 */
 char **FS_ListFilesEx( const char *path, const char **extensions, int numExts, int *numfiles, qboolean allowNonPureFilesOnDisk ) {
@@ -2455,13 +3747,12 @@ char **FS_ListFilesEx( const char *path, const char **extensions, int numExts, i
 
 	for (i = 0; i < numExts; i++)
 	{
-		sysFiles = FS_ListFilteredFiles( path, extensions[i], NULL, &numSysFiles, allowNonPureFilesOnDisk );
+		sysFiles = FS_ListFilteredFiles( path, extensions[i], NULL, &numSysFiles, allowNonPureFilesOnDisk, qtrue );
 		for ( j = 0 ; j < numSysFiles ; j++ ) {
 			// unique the match
 			name = sysFiles[j];
-			nfiles = FS_AddFileToList( name, list, nfiles );
+			nfiles = FS_AddFileToList( name, list, nfiles, qtrue );
 		}
-		Sys_FreeFileList( sysFiles );
 	}
 
 	// return a copy of the list
@@ -2471,7 +3762,7 @@ char **FS_ListFilesEx( const char *path, const char **extensions, int numExts, i
 		return NULL;
 	}
 
-	listCopy = Z_Malloc( ( nfiles + 1 ) * sizeof( *listCopy ) );
+	listCopy = Com_FrameAlloc( ( nfiles + 1 ) * sizeof( *listCopy ) );
 	for ( i = 0 ; i < nfiles ; i++ ) {
 		listCopy[i] = list[i];
 	}
@@ -2611,7 +3902,7 @@ int	FS_GetFileList(  const char *path, const char *extension, char *listbuf, int
 	}
 	else
 	{
-		pFiles = FS_ListFiles(path, extension, &nFiles);
+		pFiles = FS_ListFilteredFiles(path, extension, NULL, &nFiles, qfalse, qtrue);
 	}
 
 	for (i =0; i < nFiles; i++) {
@@ -2627,8 +3918,6 @@ int	FS_GetFileList(  const char *path, const char *extension, char *listbuf, int
 		}
 	}
 
-	FS_FreeFileList(pFiles);
-
 	return nFiles;
 }
 
@@ -2861,12 +4150,11 @@ void FS_Dir_f( void ) {
 	Com_Printf( "Directory of %s %s\n", path, extension );
 	Com_Printf( "---------------\n" );
 
-	dirnames = FS_ListFiles( path, extension, &ndirs );
+	dirnames = FS_ListFilteredFiles( path, extension, NULL, &ndirs, qfalse, qtrue );
 
 	for ( i = 0; i < ndirs; i++ ) {
 		Com_Printf( "%s\n", dirnames[i] );
 	}
-	FS_FreeFileList( dirnames );
 }
 
 /*
@@ -2943,14 +4231,13 @@ void FS_NewDir_f( void ) {
 
 	Com_Printf( "---------------\n" );
 
-	dirnames = FS_ListFilteredFiles( "", "", filter, &ndirs, qfalse );
+	dirnames = FS_ListFilteredFiles( "", "", filter, &ndirs, qfalse, qtrue );
 
 	for ( i = 0; i < ndirs; i++ ) {
 		FS_ConvertPath(dirnames[i]);
 		Com_Printf( "%s\n", dirnames[i] );
 	}
 	Com_Printf( "%d files listed\n", ndirs );
-	FS_FreeFileList( dirnames );
 }
 
 /*
@@ -3406,6 +4693,8 @@ void FS_Shutdown( qboolean closemfp ) {
 		}
 	}
 
+	FS_FlushAsyncReads( qfalse );
+
 	// free everything
 	for(p = fs_searchpaths; p; p = next)
 	{
@@ -3427,6 +4716,8 @@ void FS_Shutdown( qboolean closemfp ) {
 	Cmd_RemoveCommand( "fdir" );
 	Cmd_RemoveCommand( "touchFile" );
 	Cmd_RemoveCommand( "which" );
+	Cmd_RemoveCommand( "fs_prefetch" );
+	Cmd_RemoveCommand( "fs_benchmark" );
 
 #ifdef FS_MISSING
 	if (closemfp) {
@@ -3722,7 +5013,10 @@ static void FS_Startup( qboolean quiet )
 	if(!fs_gamedirvar->string[0])
 		Cvar_ForceReset("fs_game");
 
+	fs_pakCache = Cvar_Get( "fs_pakCache", "1", CVAR_INIT );
+
 	FS_ClearPakChecksums();
+	FS_LoadPakCache();
 
 	// load the game search paths so can load gameconfig.txt from a pk3.
 	FS_AddGame( fs_gamedirvar->string );
@@ -3746,6 +5040,9 @@ static void FS_Startup( qboolean quiet )
 		FS_UnstashSearchPath();
 	}
 
+	FS_WritePakCache();
+	FS_FreePakCache();
+
 	Q_strncpyz( fs_gamedir, fs_gamedirvar->string, sizeof( fs_gamedir ) );
 
 	FS_GetModDescription( fs_gamedir, description, sizeof ( description ) );
@@ -3758,6 +5055,8 @@ static void FS_Startup( qboolean quiet )
 	Cmd_AddCommand ("fdir", FS_NewDir_f );
 	Cmd_AddCommand ("touchFile", FS_TouchFile_f );
 	Cmd_AddCommand ("which", FS_Which_f );
+	Cmd_AddCommand ("fs_prefetch", FS_Prefetch_f );
+	Cmd_AddCommand ("fs_benchmark", FS_Benchmark_f );
 
 	FS_CheckPaks( quiet );
 
@@ -3779,6 +5078,9 @@ static void FS_Startup( qboolean quiet )
 
 		Com_Printf( "----------------------\n" );
 		Com_Printf( "%d files in pk3 files\n", fs_packFiles );
+		if ( fs_pakCacheHits || fs_pakCacheMisses ) {
+			Com_Printf( "%d pk3 directories cached, %d read\n", fs_pakCacheHits, fs_pakCacheMisses );
+		}
 	}
 }
 
@@ -4292,6 +5594,9 @@ void FS_PureServerSetLoadedPaks( const char *pakSums, const char *pakNames ) {
 		fs_serverPaks[i] = atoi( Cmd_Argv( i ) );
 	}
 
+	// prefetched files may come from paks that are no longer allowed
+	FS_FlushAsyncReads( qtrue );
+
 	if (fs_numServerPaks) {
 		Com_DPrintf( "Connected to a pure server.\n" );
 	}
@@ -4582,7 +5887,7 @@ void	FS_FilenameCompletion( const char *dir, const char *ext,
 	int		i;
 	char	filename[ MAX_STRING_CHARS ];
 
-	filenames = FS_ListFilteredFiles( dir, ext, NULL, &nfiles, allowNonPureFilesOnDisk );
+	filenames = FS_ListFilteredFiles( dir, ext, NULL, &nfiles, allowNonPureFilesOnDisk, qtrue );
 
 	for( i = 0; i < nfiles; i++ ) {
 		FS_ConvertPath( filenames[ i ] );
@@ -4594,7 +5899,6 @@ void	FS_FilenameCompletion( const char *dir, const char *ext,
 
 		callback( filename );
 	}
-	FS_FreeFileList( filenames );
 }
 
 const char *FS_GetCurrentGameDir(void)
@@ -0,0 +1,290 @@
+/*
+===========================================================================
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of Spearmint Source Code.
+
+Spearmint Source Code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 3 of the License,
+or (at your option) any later version.
+
+Spearmint Source Code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Spearmint Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, Spearmint Source Code is also subject to certain additional terms.
+You should have received a copy of these additional terms immediately following
+the terms and conditions of the GNU General Public License.  If not, please
+request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional
+terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc.,
+Suite 120, Rockville, Maryland 20850 USA.
+===========================================================================
+*/
+// jobs.c -- worker threads for engine tasks
+
+#include "q_shared.h"
+#include "qcommon.h"
+
+/*
+
+Jobs run on a small pool of worker threads. They may only touch the data
+they were given, zone/hunk allocation, cvars, commands and printing are
+not thread safe. Jobs are added by the main or server thread, a counter
+passed to Job_Add is raised until the job is done, Job_Wait runs queued
+jobs on the calling thread until it reaches zero.
+
+With no worker threads jobs are run immediately by Job_Add.
+
+*/
+
+#define	MAX_JOB_THREADS		16
+#define	MAX_JOBS			1024
+
+typedef struct {
+	void		(*function)( void *data );
+	void		*data;
+	int			*counter;
+} job_t;
+
+static cvar_t		*com_jobThreads;
+
+static sysThread_t	job_threads[MAX_JOB_THREADS];
+static int			job_numThreads;
+static qboolean		job_shutdown;
+
+static sysMutex_t	job_mutex;
+static sysCond_t	job_queued;		// signalled when a job is added
+static sysCond_t	job_finished;	// broadcast when a job is done
+
+static job_t		job_queue[MAX_JOBS];
+static int			job_head;		// next job to run
+static int			job_tail;		// next free slot
+
+/*
+=================
+Job_RunNext
+
+Takes the next job off the queue and runs it, job_mutex must be held.
+Returns qfalse if the queue is empty.
+=================
+*/
+static qboolean Job_RunNext( void ) {
+	job_t	job;
+
+	if ( job_head == job_tail ) {
+		return qfalse;
+	}
+
+	job = job_queue[job_head];
+	job_head = ( job_head + 1 ) % MAX_JOBS;
+
+	Sys_UnlockMutex( job_mutex );
+	job.function( job.data );
+	Sys_LockMutex( job_mutex );
+
+	if ( job.counter ) {
+		( *job.counter )--;
+	}
+	Sys_BroadcastCond( job_finished );
+
+	return qtrue;
+}
+
+/*
+=================
+Job_ThreadMain
+=================
+*/
+static void Job_ThreadMain( void *data ) {
+	Sys_LockMutex( job_mutex );
+
+	while ( !job_shutdown ) {
+		if ( !Job_RunNext() ) {
+			Sys_WaitCond( job_queued, job_mutex );
+		}
+	}
+
+	Sys_UnlockMutex( job_mutex );
+}
+
+/*
+=================
+Job_Add
+
+Queues function to run on a worker thread. If counter isn't NULL it is
+incremented now and decremented when the job has finished.
+=================
+*/
+void Job_Add( void (*function)( void *data ), void *data, int *counter ) {
+	job_t	*job;
+
+	if ( !job_numThreads ) {
+		function( data );
+		return;
+	}
+
+	Sys_LockMutex( job_mutex );
+
+	// queue is full, run the job here
+	if ( ( job_tail + 1 ) % MAX_JOBS == job_head ) {
+		Sys_UnlockMutex( job_mutex );
+		function( data );
+		return;
+	}
+
+	job = &job_queue[job_tail];
+	job->function = function;
+	job->data = data;
+	job->counter = counter;
+	job_tail = ( job_tail + 1 ) % MAX_JOBS;
+
+	if ( counter ) {
+		( *counter )++;
+	}
+
+	Sys_SignalCond( job_queued );
+	Sys_UnlockMutex( job_mutex );
+}
+
+/*
+=================
+Job_Pending
+
+Returns qtrue if jobs added with counter are still queued or running
+=================
+*/
+qboolean Job_Pending( int *counter ) {
+	qboolean	pending;
+
+	if ( !job_numThreads ) {
+		return qfalse;
+	}
+
+	Sys_LockMutex( job_mutex );
+	pending = ( *counter > 0 );
+	Sys_UnlockMutex( job_mutex );
+
+	return pending;
+}
+
+/*
+=================
+Job_Wait
+
+Waits until all jobs added with counter have finished, running
+queued jobs while waiting
+=================
+*/
+void Job_Wait( int *counter ) {
+	if ( !job_numThreads ) {
+		return;
+	}
+
+	Sys_LockMutex( job_mutex );
+
+	while ( *counter > 0 ) {
+		if ( !Job_RunNext() ) {
+			Sys_WaitCond( job_finished, job_mutex );
+		}
+	}
+
+	Sys_UnlockMutex( job_mutex );
+}
+
+/*
+=================
+Job_NumThreads
+=================
+*/
+int Job_NumThreads( void ) {
+	return job_numThreads;
+}
+
+/*
+=================
+Job_Init
+=================
+*/
+void Job_Init( void ) {
+	int		i, numThreads;
+
+	com_jobThreads = Cvar_Get( "com_jobThreads", "-1", CVAR_ARCHIVE | CVAR_LATCH );
+
+	numThreads = com_jobThreads->integer;
+	if ( numThreads < 0 ) {
+		// leave a core for the main thread
+		numThreads = Sys_ProcessorCount() - 1;
+	}
+	if ( numThreads > MAX_JOB_THREADS ) {
+		numThreads = MAX_JOB_THREADS;
+	}
+	if ( numThreads <= 0 ) {
+		return;
+	}
+
+	job_mutex = Sys_CreateMutex();
+	job_queued = Sys_CreateCond();
+	job_finished = Sys_CreateCond();
+	job_shutdown = qfalse;
+	job_head = job_tail = 0;
+
+	for ( i = 0; i < numThreads; i++ ) {
+		job_threads[i] = Sys_CreateThread( Job_ThreadMain, NULL );
+		if ( !job_threads[i] ) {
+			break;
+		}
+	}
+
+	job_numThreads = i;
+
+	if ( !job_numThreads ) {
+		Sys_DestroyCond( job_finished );
+		Sys_DestroyCond( job_queued );
+		Sys_DestroyMutex( job_mutex );
+		Com_Printf( "WARNING: couldn't create job threads\n" );
+		return;
+	}
+
+	Com_Printf( "%d job threads\n", job_numThreads );
+}
+
+/*
+=================
+Job_Shutdown
+
+Runs the remaining jobs and stops the worker threads
+=================
+*/
+void Job_Shutdown( void ) {
+	int		i, numThreads;
+
+	if ( !job_numThreads ) {
+		return;
+	}
+
+	Sys_LockMutex( job_mutex );
+	while ( Job_RunNext() ) {
+	}
+	job_shutdown = qtrue;
+	Sys_BroadcastCond( job_queued );
+	Sys_UnlockMutex( job_mutex );
+
+	numThreads = job_numThreads;
+	job_numThreads = 0;
+
+	for ( i = 0; i < numThreads; i++ ) {
+		Sys_JoinThread( job_threads[i] );
+		job_threads[i] = NULL;
+	}
+
+	Sys_DestroyCond( job_finished );
+	Sys_DestroyCond( job_queued );
+	Sys_DestroyMutex( job_mutex );
+}
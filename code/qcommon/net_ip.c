@@ -469,6 +469,8 @@ const char	*NET_AdrToString (netadr_t a)
 		Com_sprintf (s, sizeof(s), "loopback");
 	else if (a.type == NA_BOT)
 		Com_sprintf (s, sizeof(s), "bot");
+	else if (a.type == NA_BAD)
+		Com_sprintf (s, sizeof(s), "bad");
 	else if (a.type == NA_IP || a.type == NA_IP6)
 	{
 		struct sockaddr_storage sadr;
@@ -1661,14 +1663,29 @@ Sleeps msec or until something happens on the network
 ====================
 */
 void NET_Sleep(int msec)
+{
+	if(msec < 0)
+		msec = 0;
+
+	NET_SleepMicroseconds(msec * 1000);
+}
+
+/*
+====================
+NET_SleepMicroseconds
+
+Sleeps usec or until something happens on the network
+====================
+*/
+void NET_SleepMicroseconds(int usec)
 {
 	struct timeval timeout;
 	fd_set fdr;
 	int retval;
 	SOCKET highestfd = INVALID_SOCKET;
 
-	if(msec < 0)
-		msec = 0;
+	if(usec < 0)
+		usec = 0;
 
 	FD_ZERO(&fdr);
 
@@ -1690,13 +1707,13 @@ void NET_Sleep(int msec)
 	if(highestfd == INVALID_SOCKET)
 	{
 		// windows ain't happy when select is called without valid FDs
-		SleepEx(msec, 0);
+		SleepEx(usec / 1000, 0);
 		return;
 	}
 #endif
 
-	timeout.tv_sec = msec/1000;
-	timeout.tv_usec = (msec%1000)*1000;
+	timeout.tv_sec = usec/1000000;
+	timeout.tv_usec = usec%1000000;
 
 	retval = select(highestfd + 1, &fdr, NULL, NULL, &timeout);
 
@@ -0,0 +1,238 @@
+/*
+===========================================================================
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of Spearmint Source Code.
+
+Spearmint Source Code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 3 of the License,
+or (at your option) any later version.
+
+Spearmint Source Code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Spearmint Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, Spearmint Source Code is also subject to certain additional terms.
+You should have received a copy of these additional terms immediately following
+the terms and conditions of the GNU General Public License.  If not, please
+request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional
+terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc.,
+Suite 120, Rockville, Maryland 20850 USA.
+===========================================================================
+*/
+// profile.c -- scoped timing zones and chrome trace export
+
+#include "q_shared.h"
+#include "qcommon.h"
+
+/*
+
+Code between PROF_BEGIN( "name" ) and PROF_END( "name" ) is timed while
+com_profile is set. Each begin and end is stored in a ring buffer with
+a microsecond time stamp and the thread it ran on, zones can be nested
+and may be recorded by any thread. profile_dump writes the ring buffer
+as chrome trace event JSON (chrome://tracing, perfetto).
+
+com_profiling is only changed at the start of a frame so zones that
+are open when profiling is turned on or off are not cut in half.
+
+*/
+
+#define	MAX_PROF_RECORDS	32768	// must be a power of two
+#define	MAX_PROF_NAME		28
+#define	MAX_PROF_THREADS	32
+
+typedef struct {
+	int64_t			time;
+	unsigned long	thread;
+	char			phase;		// 'B' or 'E'
+	char			name[MAX_PROF_NAME];
+} profRecord_t;
+
+int						com_profiling;
+
+static cvar_t			*com_profile;
+
+static profRecord_t		prof_records[MAX_PROF_RECORDS];
+static volatile int		prof_numRecords;
+static unsigned long	prof_mainThread;
+
+/*
+================
+Prof_Record
+================
+*/
+static void Prof_Record( const char *name, char phase ) {
+	int64_t			time;
+	profRecord_t	*rec;
+
+	time = Sys_Microseconds();
+	rec = &prof_records[( Sys_AtomicAdd( &prof_numRecords, 1 ) - 1 ) & ( MAX_PROF_RECORDS - 1 )];
+
+	rec->time = time;
+	rec->thread = Sys_ThreadId();
+	rec->phase = phase;
+	Q_strncpyz( rec->name, name, sizeof( rec->name ) );
+}
+
+/*
+================
+Prof_Begin
+================
+*/
+void Prof_Begin( const char *name ) {
+	Prof_Record( name, 'B' );
+}
+
+/*
+================
+Prof_End
+================
+*/
+void Prof_End( const char *name ) {
+	Prof_Record( name, 'E' );
+}
+
+/*
+================
+Prof_Dump_f
+
+Writes the recorded zones to a chrome trace event file. Ends that have
+lost their begin to the ring buffer wrapping around are skipped.
+================
+*/
+static void Prof_Dump_f( void ) {
+	char			filename[MAX_QPATH];
+	fileHandle_t	f;
+	unsigned long	threads[MAX_PROF_THREADS];
+	int				depth[MAX_PROF_THREADS];
+	int				numThreads;
+	int				first, last, written;
+	int				i, t;
+	qboolean		profiling;
+	profRecord_t	*rec;
+
+	if ( Cmd_Argc() > 2 ) {
+		Com_Printf( "usage: profile_dump [filename]\n" );
+		return;
+	}
+
+	if ( Cmd_Argc() == 2 ) {
+		Q_strncpyz( filename, Cmd_Argv( 1 ), sizeof( filename ) );
+	} else {
+		Q_strncpyz( filename, "profile", sizeof( filename ) );
+	}
+	COM_DefaultExtension( filename, sizeof( filename ), ".json" );
+
+	last = Sys_AtomicLoad( &prof_numRecords );
+	if ( !last ) {
+		Com_Printf( "No profile zones recorded, set com_profile 1 first.\n" );
+		return;
+	}
+
+	f = FS_FOpenFileWrite( filename );
+	if ( !f ) {
+		Com_Printf( "Couldn't write %s.\n", filename );
+		return;
+	}
+
+	// don't let the ring buffer be written while it's being read
+	profiling = com_profiling;
+	com_profiling = 0;
+
+	first = MAX( 0, last - MAX_PROF_RECORDS );
+	numThreads = 0;
+	written = 0;
+
+	threads[numThreads] = prof_mainThread;
+	depth[numThreads] = 0;
+	numThreads++;
+
+	FS_Printf( f, "{\"traceEvents\":[\n" );
+	FS_Printf( f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main\"}}" );
+
+	for ( i = first; i < last; i++ ) {
+		rec = &prof_records[i & ( MAX_PROF_RECORDS - 1 )];
+
+		for ( t = 0; t < numThreads; t++ ) {
+			if ( threads[t] == rec->thread ) {
+				break;
+			}
+		}
+
+		if ( t == numThreads ) {
+			if ( numThreads == MAX_PROF_THREADS ) {
+				continue;
+			}
+			threads[numThreads] = rec->thread;
+			depth[numThreads] = 0;
+			numThreads++;
+
+			FS_Printf( f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}", t, t );
+		}
+
+		if ( rec->phase == 'E' ) {
+			if ( !depth[t] ) {
+				continue;
+			}
+			depth[t]--;
+		} else {
+			depth[t]++;
+		}
+
+		FS_Printf( f, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.0f,\"pid\":1,\"tid\":%d}",
+			rec->name, rec->phase, (double)rec->time, t );
+		written++;
+	}
+
+	FS_Printf( f, "\n],\"displayTimeUnit\":\"ms\"}\n" );
+	FS_FCloseFile( f );
+
+	com_profiling = profiling;
+
+	Com_Printf( "Wrote %d profile events from %d threads to %s.\n", written, numThreads, filename );
+}
+
+/*
+================
+Prof_Clear_f
+================
+*/
+static void Prof_Clear_f( void ) {
+	Sys_AtomicStore( &prof_numRecords, 0 );
+}
+
+/*
+================
+Prof_Frame
+
+Called at the start of each frame, before any zones are opened
+================
+*/
+void Prof_Frame( void ) {
+	com_profiling = com_profile->integer ? 1 : 0;
+}
+
+/*
+================
+Prof_Init
+================
+*/
+void Prof_Init( void ) {
+	prof_mainThread = Sys_ThreadId();
+
+	// start the time base
+	Sys_Microseconds();
+
+	com_profile = Cvar_Get( "com_profile", "0", CVAR_TEMP );
+
+	Cmd_AddCommand( "profile_dump", Prof_Dump_f );
+	Cmd_AddCommand( "profile_clear", Prof_Clear_f );
+}
@@ -1049,9 +1049,9 @@ struct cvar_s {
 
 	cvar_t *next;
 	cvar_t *prev;
-	cvar_t *hashNext;
-	cvar_t *hashPrev;
-	int			hashIndex;
+	unsigned int	hashValue;
+	int				syncMask;			// VM sync lists the cvar is registered with
+	int				syncDirty;			// VM sync lists the cvar is queued on
 };
 
 #define	MAX_CVAR_VALUE_STRING	256
@@ -1068,6 +1068,10 @@ typedef struct {
 	char		string[MAX_CVAR_VALUE_STRING];
 } vmCvar_t;
 
+// most handles returned by a single cvar sync, more changes than
+// this make the sync report an overflow and the module updates all
+#define	MAX_CVAR_SYNC_HANDLES	256
+
 
 /*
 ==============================================================
@@ -199,6 +199,7 @@ qboolean	NET_GetLoopPacket (netsrc_t sock, netadr_t *net_from, msg_t *net_messag
 void		NET_JoinMulticast6(void);
 void		NET_LeaveMulticast6(void);
 void		NET_Sleep(int msec);
+void		NET_SleepMicroseconds(int usec);
 
 
 #define	MAX_MSGLEN				32768		// max length of a message, which may
@@ -514,12 +515,27 @@ cvar_t *Cvar_Get( const char *var_name, const char *value, int flags );
 // that allows variables to be unarchived without needing bitflags
 // if value is "", the value will not override a previously set value.
 
-void	Cvar_Register( vmCvar_t *vmCvar, const char *varName, const char *defaultValue, int flags );
+typedef enum {
+	CVAR_SYNC_GAME,
+	CVAR_SYNC_CGAME,
+
+	CVAR_SYNC_LISTS
+} cvarSync_t;
+
+void	Cvar_Register( vmCvar_t *vmCvar, const char *varName, const char *defaultValue, int flags, cvarSync_t sync );
 // basically a slightly modified Cvar_Get for the interpreted modules
+// the cvar is queued on the sync list whenever it changes
 
 void	Cvar_Update( vmCvar_t *vmCvar );
 // updates an interpreted modules' version of a cvar
 
+int		Cvar_Sync( cvarSync_t sync, int *handles, int maxHandles );
+// returns the handles of registered cvars changed since the last sync,
+// or -1 if there were more than maxHandles
+
+void	Cvar_ResetSync( cvarSync_t sync );
+// forgets registrations and pending changes when a VM is (re)started
+
 cvar_t *Cvar_SetDefault( const char *var_name, const char *value );
 // if cvar exists, change the default value of the cvar. Otherwise, create using Cvar_Get.
 
@@ -703,6 +719,28 @@ void	FS_ForceFlush( fileHandle_t f );
 void	FS_FreeFile( void *buffer );
 // frees the memory returned by FS_ReadFile
 
+long	FS_MapFileDir( const char *qpath, void *searchPath, qboolean unpure, void **buffer );
+long	FS_MapFile( const char *qpath, void **buffer );
+// like FS_ReadFile, but stored pk3 entries and loose files are returned as a
+// copy-on-write memory mapping instead of being copied into the hunk.
+// The buffer may be modified, but it is NOT zero terminated.
+
+void	FS_UnmapFile( void *buffer );
+// frees the memory returned by FS_MapFile
+
+int		FS_ReadFileAsync( const char *qpath );
+// starts reading and decompressing the file on a job thread,
+// returns a handle or 0 if the file doesn't exist
+qboolean FS_AsyncReadComplete( int handle );
+long	FS_FinishReadFileAsync( int handle, void **buffer );
+// waits for the read, returns like FS_ReadFile and the buffer must be freed with
+// FS_FreeFile. A NULL buffer cancels the read.
+
+void	FS_PrefetchFile( const char *qpath );
+// reads the file in the background, the next FS_ReadFile of it uses the data
+void	FS_FlushAsyncReads( qboolean prefetchOnly );
+// frees prefetched files that were never read
+
 void	FS_WriteFile( const char *qpath, const void *buffer, int size );
 // writes a complete file, creating any subdirectories needed
 
@@ -856,9 +894,11 @@ typedef struct {
 	sysEventType_t	evType;
 	int				evValue, evValue2, evValue3;
 	int				evPtrLength;	// bytes of data pointed to by evPtr, for journaling
-	void			*evPtr;			// this must be manually freed if not NULL
+	void			*evPtr;			// must be freed with Com_FreeEventData
 } sysEvent_t;
 
+void		*Com_AllocEventData( int size );
+void		Com_FreeEventData( void *ptr );
 void		Com_QueueEvent( int time, sysEventType_t type, int value, int value2, int ptrLength, void *ptr );
 int			Com_EventLoop( void );
 sysEvent_t	Com_GetSystemEvent( void );
@@ -879,6 +919,7 @@ unsigned	Com_BlockChecksum( const void *buffer, int length );
 char		*Com_MD5File(const char *filename, int length, const char *prefix, int prefix_len);
 int			Com_Filter(char *filter, char *name, int casesensitive);
 int			Com_FilterPath(char *filter, char *name, int casesensitive);
+unsigned int	Com_HashStringNoCase( const char *string );
 int			Com_RealTime(qtime_t *qtime);
 qboolean	Com_SafeMode( void );
 void		Com_RunAndTimeServerPacket(netadr_t *evFrom, msg_t *buf);
@@ -957,7 +998,8 @@ typedef enum {
 	TAG_RENDERER,
 	TAG_SMALL,
 	TAG_STATIC,
-	TAG_GAME
+	TAG_GAME,
+	TAG_SLAB		// zone block holding small allocations
 } memtag_t;
 
 /*
@@ -1011,6 +1053,19 @@ void Hunk_FreeTempMemory( void *buf );
 int	Hunk_MemoryRemaining( void );
 void Hunk_Log( void);
 
+// memory that is only needed until the end of the frame, the
+// server and client halves of Com_Frame use separate arenas
+typedef enum {
+	FRAME_ARENA_CLIENT,
+	FRAME_ARENA_SERVER,
+
+	NUM_FRAME_ARENAS
+} frameArena_t;
+
+void *Com_FrameAlloc( int size );	// NOT 0 filled memory, main thread only
+frameArena_t Com_SetFrameArena( frameArena_t arena );	// returns the previous arena
+void Com_ClearFrameArena( frameArena_t arena );
+
 typedef struct {
 	void *pointer;
 	int maxElements;
@@ -1046,6 +1101,50 @@ void Com_Shutdown( void );
 /*
 ==============================================================
 
+JOBS
+
+==============================================================
+*/
+
+void Job_Init( void );
+void Job_Shutdown( void );
+int Job_NumThreads( void );
+
+void Job_Add( void (*function)( void *data ), void *data, int *counter );
+// runs function on a worker thread, it must not use anything that isn't
+// thread safe (memory allocation, cvars, commands, printing...).
+// counter can be NULL, otherwise it is incremented until the job is done
+
+qboolean Job_Pending( int *counter );
+void Job_Wait( int *counter );
+// waits for all jobs added with counter, helping to run queued jobs
+
+/*
+==============================================================
+
+PROFILING
+
+==============================================================
+*/
+
+extern int com_profiling;
+
+void Prof_Init( void );
+void Prof_Frame( void );
+void Prof_Begin( const char *name );
+void Prof_End( const char *name );
+
+// times the code between them while com_profile is set, zones may be
+// nested and used from any thread. profile_dump writes a chrome trace
+// the renderer has its own versions in tr_common.h
+#ifndef PROF_BEGIN
+#define PROF_BEGIN( name ) do { if ( com_profiling ) Prof_Begin( name ); } while ( 0 )
+#define PROF_END( name ) do { if ( com_profiling ) Prof_End( name ); } while ( 0 )
+#endif
+
+/*
+==============================================================
+
 REFRESH DLL
 
 ==============================================================
@@ -1129,6 +1228,7 @@ void SV_Shutdown( char *finalmsg );
 void SV_Frame( int msec );
 void SV_PacketEvent( netadr_t from, msg_t *msg );
 int SV_FrameMsec(void);
+int SV_FrameUsec(void);
 int SV_SendQueuedPackets(void);
 
 /*
@@ -1157,6 +1257,7 @@ void	Sys_Print( const char *msg );
 // Sys_Milliseconds should only be used for profiling purposes,
 // any game related timing information should come from event timestamps
 int		Sys_Milliseconds (void);
+int64_t	Sys_Microseconds( void );
 
 qboolean Sys_RandomBytes( byte *string, int len );
 
@@ -1180,6 +1281,35 @@ qboolean Sys_Mkdir( const char *path );
 qboolean Sys_Rmdir( const char *path );
 FILE	*Sys_Mkfifo( const char *ospath );
 int		Sys_StatFile( char *ospath );
+qboolean Sys_FileStats( const char *ospath, int *size, int *mtime );
+void	*Sys_MapFile( FILE *f, int offset, int length, void **base, int *baseLength );
+void	Sys_UnmapFile( void *base, int baseLength );
+
+// threads, mutexes and condition variables must be created and
+// destroyed by the main thread
+typedef void *sysThread_t;
+typedef void *sysMutex_t;
+typedef void *sysCond_t;
+
+sysThread_t	Sys_CreateThread( void (*function)( void *data ), void *data );
+void		Sys_JoinThread( sysThread_t thread );
+sysMutex_t	Sys_CreateMutex( void );
+void		Sys_DestroyMutex( sysMutex_t mutex );
+void		Sys_LockMutex( sysMutex_t mutex );
+void		Sys_UnlockMutex( sysMutex_t mutex );
+sysCond_t	Sys_CreateCond( void );
+void		Sys_DestroyCond( sysCond_t cond );
+void		Sys_WaitCond( sysCond_t cond, sysMutex_t mutex );
+void		Sys_SignalCond( sysCond_t cond );
+void		Sys_BroadcastCond( sysCond_t cond );
+int			Sys_ProcessorCount( void );
+unsigned long	Sys_ThreadId( void );
+
+// atomic operations are full memory barriers
+int			Sys_AtomicAdd( volatile int *value, int add );
+qboolean	Sys_AtomicCompareExchange( volatile int *value, int oldValue, int newValue );
+int			Sys_AtomicLoad( volatile int *value );
+void		Sys_AtomicStore( volatile int *value, int newValue );
 char	*Sys_Cwd( void );
 void	Sys_SetDefaultInstallPath(const char *path);
 char	*Sys_DefaultInstallPath(void);
@@ -1600,3 +1600,17 @@ extern int ZEXPORT unzSetOffset (file, pos)
     s->current_file_ok = (err == UNZ_OK);
     return err;
 }
+
+extern uLong ZEXPORT unzGetCurrentFileZStreamPos (file)
+    unzFile file;
+{
+    unz_s* s;
+
+    if (file==NULL)
+        return 0;
+    s=(unz_s*)file;
+    if (s->pfile_in_zip_read==NULL)
+        return 0;
+    return s->pfile_in_zip_read->pos_in_zipfile +
+           s->pfile_in_zip_read->byte_before_the_zipfile;
+}
@@ -388,7 +388,7 @@ vmHeader_t *VM_LoadQVM( vm_t *vm, qboolean alloc, qboolean unpure)
 	Com_sprintf( filename, sizeof(filename), "vm/%s.qvm", vm->name );
 	Com_DPrintf( "Loading vm file %s...\n", filename );
 
-	FS_ReadFileDir(filename, vm->searchPath, unpure, &header.v);
+	FS_MapFileDir(filename, vm->searchPath, unpure, &header.v);
 
 	if ( !header.h ) {
 		Com_Printf("Loading vm file %s failed.\n", filename);
@@ -426,7 +426,7 @@ vmHeader_t *VM_LoadQVM( vm_t *vm, qboolean alloc, qboolean unpure)
 			|| header.h->codeLength <= 0 )
 		{
 			VM_Free(vm);
-			FS_FreeFile(header.v);
+			FS_UnmapFile(header.v);
 			
 			Com_Printf(S_COLOR_YELLOW "Warning: %s has bad header\n", filename);
 			return NULL;
@@ -438,12 +438,12 @@ vmHeader_t *VM_LoadQVM( vm_t *vm, qboolean alloc, qboolean unpure)
 		FS_Which(filename, vm->searchPath);
 
 		VM_Free( vm );
-		FS_FreeFile( header.v );
+		FS_UnmapFile( header.v );
 
 		return NULL;
 	} else {
 		VM_Free( vm );
-		FS_FreeFile(header.v);
+		FS_UnmapFile(header.v);
 
 		Com_Printf(S_COLOR_YELLOW "Warning: %s does not have a recognisable "
 				"magic number in its header\n", filename);
@@ -478,7 +478,7 @@ vmHeader_t *VM_LoadQVM( vm_t *vm, qboolean alloc, qboolean unpure)
 		if(vm->dataMask + 1 != dataLength)
 		{
 			VM_Free(vm);
-			FS_FreeFile(header.v);
+			FS_UnmapFile(header.v);
 
 			Com_Printf(S_COLOR_YELLOW "Warning: Data region size of %s not matching after "
 					"VM_Restart()\n", filename);
@@ -515,7 +515,7 @@ vmHeader_t *VM_LoadQVM( vm_t *vm, qboolean alloc, qboolean unpure)
 			if(vm->numJumpTableTargets != previousNumJumpTableTargets)
 			{
 				VM_Free(vm);
-				FS_FreeFile(header.v);
+				FS_UnmapFile(header.v);
 
 				Com_Printf(S_COLOR_YELLOW "Warning: Jump table size of %s not matching after "
 						"VM_Restart()\n", filename);
@@ -576,7 +576,7 @@ vm_t *VM_Restart(vm_t *vm, qboolean unpure)
 	}
 
 	// free the original file
-	FS_FreeFile(header);
+	FS_UnmapFile(header);
 
 	return vm;
 }
@@ -689,7 +689,7 @@ vm_t *VM_Create( const char *module, intptr_t (*systemCalls)(intptr_t *),
 	}
 
 	// free the original file
-	FS_FreeFile( header );
+	FS_UnmapFile( header );
 
 	// load the map file
 	VM_LoadSymbols( vm );
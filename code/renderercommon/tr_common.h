@@ -79,6 +79,12 @@ typedef struct image_s {
 } image_t;
 
 extern	refimport_t		ri;
+
+// the renderer can't see com_profiling, go through the import table
+#undef PROF_BEGIN
+#undef PROF_END
+#define PROF_BEGIN( name ) do { if ( *ri.profiling ) ri.Prof_Begin( name ); } while ( 0 )
+#define PROF_END( name ) do { if ( *ri.profiling ) ri.Prof_End( name ); } while ( 0 )
 extern glconfig_t	glConfig;		// outside of TR since it shouldn't be cleared during ref re-init
 
 // These variables should live inside glConfig but can't because of
@@ -38,7 +38,7 @@ Suite 120, Rockville, Maryland 20850 USA.
   #include <zlib.h>
 #endif
 
-#define	REF_API_VERSION		8
+#define	REF_API_VERSION		10
 
 //
 // these are the functions exported by the refresh module
@@ -184,6 +184,10 @@ typedef struct {
 	// NULL can be passed for buf to just determine existance
 	long	(*FS_ReadFile)( const char *name, void **buf );
 	void	(*FS_FreeFile)( void *buf );
+	// like FS_ReadFile, but the buffer may be a memory mapping of the file
+	// and is not zero terminated, free with FS_UnmapFile
+	long	(*FS_MapFile)( const char *name, void **buf );
+	void	(*FS_UnmapFile)( void *buf );
 	char **	(*FS_ListFiles)( const char *name, const char *extension, int *numfilesfound );
 	void	(*FS_FreeFileList)( char **filelist );
 	void	(*FS_WriteFile)( const char *qpath, const void *buffer, int size );
@@ -211,6 +215,11 @@ typedef struct {
 	void	(*Sys_GLimpInit)( void );
 	qboolean (*Sys_LowPhysicalMemory)( void );
 
+	// scoped timing zones, only call them while *profiling is set
+	void	(*Prof_Begin)( const char *name );
+	void	(*Prof_End)( const char *name );
+	int		*profiling;
+
 	// zlib for png screenshots
 	int (*zlib_compress) (Bytef *dest, uLongf *destLen, const Bytef *source, uLong sourceLen);
 	uLong (*zlib_crc32) (uLong crc, const Bytef *buf, uInt len);
@@ -1699,6 +1699,8 @@ void R_RenderView (viewParms_t *parms) {
 		return;
 	}
 
+	PROF_BEGIN( "R_RenderView" );
+
 	tr.viewCount++;
 
 	tr.viewParms = *parms;
@@ -1720,6 +1722,8 @@ void R_RenderView (viewParms_t *parms) {
 	R_FogOff();
 	R_DebugGraphics();
 	//RB_FogOn();
+
+	PROF_END( "R_RenderView" );
 }
 
 
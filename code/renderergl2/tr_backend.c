@@ -2019,6 +2019,8 @@ void RB_ExecuteRenderCommands( const void *data ) {
 
 	t1 = ri.Milliseconds ();
 
+	PROF_BEGIN( "RB_ExecuteRenderCommands" );
+
 	while ( 1 ) {
 		data = PADP(data, sizeof(void *));
 
@@ -2074,6 +2076,8 @@ void RB_ExecuteRenderCommands( const void *data ) {
 			// stop rendering
 			t2 = ri.Milliseconds ();
 			backEnd.pc.msec = t2 - t1;
+
+			PROF_END( "RB_ExecuteRenderCommands" );
 			return;
 		}
 	}
@@ -3710,7 +3710,7 @@ void RE_LoadWorldMap( const char *name ) {
 	tr.worldDir = NULL;
 
 	// load it
-    ri.FS_ReadFile( name, &buffer.v );
+    ri.FS_MapFile( name, &buffer.v );
 	if ( !buffer.b ) {
 		ri.Error (ERR_DROP, "RE_LoadWorldMap: %s not found", name);
 	}
@@ -3999,5 +3999,5 @@ void RE_LoadWorldMap( const char *name ) {
 		R_RenderAllCubemaps();
 	}
 
-    ri.FS_FreeFile( buffer.v );
+    ri.FS_UnmapFile( buffer.v );
 }
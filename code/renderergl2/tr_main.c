@@ -2335,6 +2335,8 @@ void R_RenderView (viewParms_t *parms) {
 		return;
 	}
 
+	PROF_BEGIN( "R_RenderView" );
+
 	tr.viewCount++;
 
 	tr.viewParms = *parms;
@@ -2358,6 +2360,8 @@ void R_RenderView (viewParms_t *parms) {
 	R_FogOff();
 	R_DebugGraphics();
 	//RB_FogOn();
+
+	PROF_END( "R_RenderView" );
 }
 
 
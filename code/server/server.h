@@ -308,6 +308,7 @@ extern	cvar_t	*sv_pure;
 extern	cvar_t	*sv_floodProtect;
 extern	cvar_t	*sv_lanForceRate;
 extern	cvar_t	*sv_banFile;
+extern	cvar_t	*sv_benchBots;
 
 extern	cvar_t	*sv_public;
 
@@ -381,6 +382,8 @@ void SV_SpawnServer( char *server, qboolean killBots );
 void SV_GetChallenge(netadr_t from);
 
 void SV_DirectConnect( netadr_t from );
+client_t *SV_FakeConnect( const char *userinfo );
+void SV_SendClientGameState( client_t *client );
 
 void SV_ExecuteClientMessage( client_t *cl, msg_t *msg );
 void SV_UserinfoChanged( player_t *cl );
@@ -510,6 +513,31 @@ void SV_Trace( trace_t *results, const vec3_t start, const vec3_t mins, const ve
 void SV_ClipToEntity( trace_t *trace, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int entityNum, int contentmask, traceType_t type );
 // clip to a specific entity
 
+//
+// sv_bench.c
+//
+#define	BENCH_SEED				0x5eed	// GAME_INIT seed while benchmarking
+
+// per-subsystem times gathered while the benchmark command runs
+typedef struct {
+	qboolean	active;
+	int64_t		input;				// usercmds through SV_ExecuteClientMessage
+	int64_t		game;				// GAME_RUN_FRAME
+	int64_t		botlib;				// SV_BotFrame
+	int64_t		snapshotBuild;		// SV_BuildClientSnapshot
+	int64_t		snapshotEncode;		// writing and transmitting snapshots
+	int			snapshots;
+	int			snapshotBytes;
+} benchStats_t;
+
+extern benchStats_t	sv_benchStats;
+
+void SV_Benchmark_f( void );
+void SV_BenchRecord_f( void );
+void SV_StopBenchRecord_f( void );
+void SV_BenchRecordCmd( player_t *player, usercmd_t *cmd );
+void SV_BenchShutdown( void );
+
 //
 // sv_net_chan.c
 //
@@ -0,0 +1,456 @@
+/*
+===========================================================================
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of Spearmint Source Code.
+
+Spearmint Source Code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 3 of the License,
+or (at your option) any later version.
+
+Spearmint Source Code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Spearmint Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, Spearmint Source Code is also subject to certain additional terms.
+You should have received a copy of these additional terms immediately following
+the terms and conditions of the GNU General Public License.  If not, please
+request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional
+terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc.,
+Suite 120, Rockville, Maryland 20850 USA.
+===========================================================================
+*/
+// sv_bench.c -- headless server benchmark with fake clients replaying usercmds
+
+#include "server.h"
+
+// usercmd recordings are a header followed by the fields of each command
+#define	BENCH_CMD_MAGIC			( ( 'D' << 24 ) + ( 'M' << 16 ) + ( 'C' << 8 ) + 'U' )
+#define	BENCH_CMD_VERSION		1
+#define	BENCH_CMD_FIELDS		9
+
+// synthetic stream used when no recording is given
+#define	BENCH_SYNTH_CMDS		1024
+#define	BENCH_SYNTH_MSEC		8
+
+#define	BENCH_DEFAULT_CLIENTS	16
+#define	BENCH_DEFAULT_FRAMES	1000
+
+benchStats_t	sv_benchStats;
+
+typedef struct {
+	client_t	*client;
+	int			cursor;			// next command in the stream
+	int			timeShift;		// added to stream times to get server times
+} benchClient_t;
+
+static benchClient_t	*bench_clients;
+static usercmd_t	*bench_cmds;
+static int			bench_numCmds;
+static int			bench_duration;		// length of one pass through the stream
+
+static fileHandle_t	bench_recordFile;
+static int			bench_recordPlayer;
+
+/*
+==================
+SV_BenchRecordCmd
+
+Called for every usercmd a player thinks with
+==================
+*/
+void SV_BenchRecordCmd( player_t *player, usercmd_t *cmd ) {
+	int		fields[BENCH_CMD_FIELDS];
+
+	if ( !bench_recordFile || player - svs.players != bench_recordPlayer ) {
+		return;
+	}
+
+	fields[0] = LittleLong( cmd->serverTime );
+	fields[1] = LittleLong( cmd->angles[0] );
+	fields[2] = LittleLong( cmd->angles[1] );
+	fields[3] = LittleLong( cmd->angles[2] );
+	fields[4] = LittleLong( cmd->buttons );
+	fields[5] = LittleLong( cmd->stateValue );
+	fields[6] = LittleLong( cmd->forwardmove );
+	fields[7] = LittleLong( cmd->rightmove );
+	fields[8] = LittleLong( cmd->upmove );
+
+	FS_Write( fields, sizeof( fields ), bench_recordFile );
+}
+
+/*
+==================
+SV_BenchRecord_f
+
+benchrecord <file> [player]
+==================
+*/
+void SV_BenchRecord_f( void ) {
+	char	name[MAX_QPATH];
+	int		header[2];
+
+	if ( Cmd_Argc() < 2 || Cmd_Argc() > 3 ) {
+		Com_Printf( "usage: benchrecord <file> [player]\n" );
+		return;
+	}
+
+	if ( bench_recordFile ) {
+		Com_Printf( "Already recording usercmds.\n" );
+		return;
+	}
+
+	Q_strncpyz( name, Cmd_Argv( 1 ), sizeof( name ) );
+	COM_DefaultExtension( name, sizeof( name ), ".ucmd" );
+
+	bench_recordFile = FS_FOpenFileWrite( name );
+	if ( !bench_recordFile ) {
+		Com_Printf( "Couldn't open %s for writing.\n", name );
+		return;
+	}
+
+	bench_recordPlayer = ( Cmd_Argc() == 3 ) ? atoi( Cmd_Argv( 2 ) ) : 0;
+
+	header[0] = LittleLong( BENCH_CMD_MAGIC );
+	header[1] = LittleLong( BENCH_CMD_VERSION );
+	FS_Write( header, sizeof( header ), bench_recordFile );
+
+	Com_Printf( "Recording usercmds of player %d to %s.\n", bench_recordPlayer, name );
+}
+
+/*
+==================
+SV_StopBenchRecord_f
+==================
+*/
+void SV_StopBenchRecord_f( void ) {
+	if ( !bench_recordFile ) {
+		return;
+	}
+
+	FS_FCloseFile( bench_recordFile );
+	bench_recordFile = 0;
+
+	Com_Printf( "Stopped recording usercmds.\n" );
+}
+
+/*
+==================
+SV_BenchLoadCmds
+==================
+*/
+static qboolean SV_BenchLoadCmds( const char *filename ) {
+	char		name[MAX_QPATH];
+	union {
+		int		*i;
+		void	*v;
+	} buf;
+	int			len, i;
+	int			*fields;
+	usercmd_t	*cmd;
+
+	Q_strncpyz( name, filename, sizeof( name ) );
+	COM_DefaultExtension( name, sizeof( name ), ".ucmd" );
+
+	len = FS_ReadFile( name, &buf.v );
+	if ( !buf.v ) {
+		Com_Printf( "Couldn't read %s.\n", name );
+		return qfalse;
+	}
+
+	if ( len < (int)( 2 * sizeof( int ) ) || LittleLong( buf.i[0] ) != BENCH_CMD_MAGIC
+		|| LittleLong( buf.i[1] ) != BENCH_CMD_VERSION ) {
+		Com_Printf( "%s is not a usercmd recording.\n", name );
+		FS_FreeFile( buf.v );
+		return qfalse;
+	}
+
+	bench_numCmds = ( len - 2 * (int)sizeof( int ) ) / ( BENCH_CMD_FIELDS * (int)sizeof( int ) );
+	if ( bench_numCmds < 1 ) {
+		Com_Printf( "%s has no usercmds.\n", name );
+		FS_FreeFile( buf.v );
+		return qfalse;
+	}
+
+	bench_cmds = Z_Malloc( bench_numCmds * sizeof( usercmd_t ) );
+
+	fields = buf.i + 2;
+	for ( i = 0, cmd = bench_cmds; i < bench_numCmds; i++, cmd++, fields += BENCH_CMD_FIELDS ) {
+		cmd->serverTime = LittleLong( fields[0] );
+		cmd->angles[0] = LittleLong( fields[1] );
+		cmd->angles[1] = LittleLong( fields[2] );
+		cmd->angles[2] = LittleLong( fields[3] );
+		cmd->buttons = LittleLong( fields[4] );
+		cmd->stateValue = LittleLong( fields[5] );
+		cmd->forwardmove = LittleLong( fields[6] );
+		cmd->rightmove = LittleLong( fields[7] );
+		cmd->upmove = LittleLong( fields[8] );
+	}
+
+	FS_FreeFile( buf.v );
+
+	return qtrue;
+}
+
+/*
+==================
+SV_BenchSynthesizeCmds
+
+Runs forward while turning and strafing, with occasional jumps and
+bursts of the first button (attack in baseq3)
+==================
+*/
+static void SV_BenchSynthesizeCmds( void ) {
+	int			i, seed;
+	usercmd_t	*cmd;
+
+	bench_numCmds = BENCH_SYNTH_CMDS;
+	bench_cmds = Z_Malloc( bench_numCmds * sizeof( usercmd_t ) );
+
+	seed = BENCH_SEED;
+	for ( i = 0, cmd = bench_cmds; i < bench_numCmds; i++, cmd++ ) {
+		cmd->serverTime = i * BENCH_SYNTH_MSEC;
+		cmd->angles[YAW] = ANGLE2SHORT( i * 360.0f / BENCH_SYNTH_CMDS );
+		cmd->forwardmove = 127;
+		cmd->rightmove = ( ( i / 64 ) & 1 ) ? 127 : -127;
+		cmd->upmove = ( ( Q_rand( &seed ) & 63 ) == 0 ) ? 127 : 0;
+		cmd->buttons = ( ( i / 32 ) & 1 );
+	}
+}
+
+/*
+==================
+SV_BenchClientPacket
+
+Builds the packet a client would send for the next frame and parses it
+==================
+*/
+static void SV_BenchClientPacket( benchClient_t *bc, int frameMsec ) {
+	client_t	*cl = bc->client;
+	byte		buf[MAX_MSGLEN];
+	msg_t		msg;
+	usercmd_t	cmds[MAX_PACKET_USERCMDS];
+	usercmd_t	nullcmd, *oldcmd;
+	int			count, key, i;
+
+	if ( cl->state < CS_PRIMED ) {
+		return;		// dropped by the game
+	}
+
+	for ( count = 0; count < MAX_PACKET_USERCMDS; count++ ) {
+		cmds[count] = bench_cmds[bc->cursor];
+		cmds[count].serverTime += bc->timeShift;
+
+		if ( cmds[count].serverTime > sv.time + frameMsec ) {
+			break;
+		}
+
+		if ( ++bc->cursor == bench_numCmds ) {
+			bc->cursor = 0;
+			bc->timeShift += bench_duration;
+		}
+	}
+
+	MSG_Init( &msg, buf, sizeof( buf ) );
+	MSG_Bitstream( &msg );
+
+	// acknowledge everything the server has sent
+	MSG_WriteLong( &msg, sv.serverId );
+	MSG_WriteLong( &msg, cl->netchan.outgoingSequence - 1 );
+	MSG_WriteLong( &msg, cl->reliableSequence );
+
+	if ( count ) {
+		MSG_WriteByte( &msg, clc_move );
+		MSG_WriteByte( &msg, 1 );
+		MSG_WriteByte( &msg, count );
+
+		key = ( cl->netchan.outgoingSequence - 1 )
+			^ MSG_HashKey( cl->reliableCommands[ cl->reliableSequence & ( MAX_RELIABLE_COMMANDS - 1 ) ], 32 );
+
+		Com_Memset( &nullcmd, 0, sizeof( nullcmd ) );
+		oldcmd = &nullcmd;
+		for ( i = 0; i < count; i++ ) {
+			MSG_WriteDeltaUsercmdKey( &msg, key, oldcmd, &cmds[i] );
+			oldcmd = &cmds[i];
+		}
+	}
+
+	MSG_WriteByte( &msg, clc_EOF );
+
+	MSG_BeginReading( &msg );
+	cl->lastPacketTime = svs.time;
+	SV_ExecuteClientMessage( cl, &msg );
+}
+
+/*
+==================
+SV_BenchShutdown
+
+Frees the benchmark state, also when a run ends in Com_Error
+==================
+*/
+void SV_BenchShutdown( void ) {
+	sv_benchStats.active = qfalse;
+
+	if ( bench_clients ) {
+		Z_Free( bench_clients );
+		bench_clients = NULL;
+	}
+
+	if ( bench_cmds ) {
+		Z_Free( bench_cmds );
+		bench_cmds = NULL;
+	}
+}
+
+/*
+==================
+SV_Benchmark_f
+
+benchmark <map> [clients] [bots] [frames] [usercmd file]
+
+Loads the map, connects fake clients that replay a usercmd stream and
+adds the bots named in sv_benchBots, then runs server frames back to back
+without sleeping. The game is seeded with BENCH_SEED so runs repeat.
+==================
+*/
+void SV_Benchmark_f( void ) {
+	char			mapname[MAX_QPATH];
+	char			bots[MAX_STRING_CHARS];
+	char			*botNames, *token;
+	int				numClients, numBots, numFrames;
+	int				frameMsec, frame, connected, i;
+	int64_t			start, total;
+	double			msec;
+
+	if ( Cmd_Argc() < 2 ) {
+		Com_Printf( "usage: benchmark <map> [clients] [bots] [frames] [usercmd file]\n" );
+		return;
+	}
+
+	Q_strncpyz( mapname, Cmd_Argv( 1 ), sizeof( mapname ) );
+	numClients = ( Cmd_Argc() > 2 ) ? atoi( Cmd_Argv( 2 ) ) : BENCH_DEFAULT_CLIENTS;
+	numBots = ( Cmd_Argc() > 3 ) ? atoi( Cmd_Argv( 3 ) ) : 0;
+	numFrames = ( Cmd_Argc() > 4 ) ? atoi( Cmd_Argv( 4 ) ) : BENCH_DEFAULT_FRAMES;
+
+	numClients = Com_Clamp( 0, MAX_CLIENTS, numClients );
+	numBots = Com_Clamp( 0, MAX_CLIENTS - numClients, numBots );
+	numFrames = MAX( numFrames, 1 );
+
+	SV_BenchShutdown();
+
+	// load the stream first so a bad file doesn't restart the server
+	if ( Cmd_Argc() > 5 ) {
+		if ( !SV_BenchLoadCmds( Cmd_Argv( 5 ) ) ) {
+			return;
+		}
+	} else {
+		SV_BenchSynthesizeCmds();
+	}
+
+	bench_duration = bench_cmds[bench_numCmds - 1].serverTime - bench_cmds[0].serverTime;
+	bench_duration += ( bench_numCmds > 1 ) ? bench_duration / ( bench_numCmds - 1 ) : BENCH_SYNTH_MSEC;
+	bench_duration = MAX( bench_duration, 1 );
+
+	if ( sv_maxclients->integer < numClients + numBots ) {
+		Cvar_Set( "sv_maxclients", va( "%d", numClients + numBots ) );
+	}
+
+	if ( sv_fps->integer < 1 ) {
+		Cvar_Set( "sv_fps", "10" );
+	}
+
+	// active while loading so GAME_INIT gets the fixed seed
+	sv_benchStats.active = qtrue;
+
+	Cmd_ExecuteString( va( "map %s", mapname ) );
+
+	if ( !com_sv_running->integer ) {
+		Com_Printf( "Benchmark couldn't load %s.\n", mapname );
+		SV_BenchShutdown();
+		return;
+	}
+
+	// each client starts at a different point in the stream
+	bench_clients = Z_Malloc( MAX( numClients, 1 ) * sizeof( benchClient_t ) );
+
+	for ( connected = 0; connected < numClients; connected++ ) {
+		benchClient_t *bc = &bench_clients[connected];
+
+		bc->client = SV_FakeConnect( va( "\\name\\Bench%d\\rate\\25000\\snaps\\%d",
+			connected + 1, sv_fps->integer ) );
+
+		if ( !bc->client ) {
+			Com_Printf( "Benchmark could only connect %d of %d clients.\n", connected, numClients );
+			break;
+		}
+
+		bc->cursor = connected * bench_numCmds / numClients;
+		bc->timeShift = sv.time - bench_cmds[bc->cursor].serverTime;
+	}
+
+	// take the names in turn, starting over when the list runs out
+	Q_strncpyz( bots, sv_benchBots->string, sizeof( bots ) );
+	botNames = bots;
+
+	for ( i = 0; i < numBots; i++ ) {
+		token = COM_Parse( &botNames );
+
+		if ( !token[0] ) {
+			botNames = bots;
+			token = COM_Parse( &botNames );
+		}
+
+		if ( !token[0] ) {
+			Com_Printf( "Benchmark has no bots to add, sv_benchBots is empty.\n" );
+			numBots = 0;
+			break;
+		}
+
+		Cmd_ExecuteString( va( "addbot %s", token ) );
+	}
+
+	Com_Printf( "Benchmarking %s: %d clients, %d bots, %d frames, %d usercmds\n",
+		mapname, connected, numBots, numFrames, bench_numCmds );
+
+	Com_Memset( &sv_benchStats, 0, sizeof( sv_benchStats ) );
+	sv_benchStats.active = qtrue;
+
+	frameMsec = MAX( 1000 / sv_fps->integer, 1 );
+	start = Sys_Microseconds();
+
+	for ( frame = 0; frame < numFrames && com_sv_running->integer; frame++ ) {
+		int64_t	inputStart = Sys_Microseconds();
+
+		for ( i = 0; i < connected; i++ ) {
+			SV_BenchClientPacket( &bench_clients[i], frameMsec );
+		}
+
+		sv_benchStats.input += Sys_Microseconds() - inputStart;
+
+		SV_Frame( frameMsec );
+		SV_SendQueuedMessages();
+	}
+
+	total = Sys_Microseconds() - start;
+	sv_benchStats.active = qfalse;
+
+	msec = 0.001 / MAX( frame, 1 );
+
+	Com_Printf( "%d frames in %.3f seconds, %.1f frames per second\n",
+		frame, total / 1000000.0, frame * 1000000.0 / MAX( total, 1 ) );
+	Com_Printf( "msec per frame: %.3f total, %.3f input, %.3f game, %.3f botlib, %.3f snapshot build, %.3f encode\n",
+		total * msec, sv_benchStats.input * msec, sv_benchStats.game * msec, sv_benchStats.botlib * msec,
+		sv_benchStats.snapshotBuild * msec, sv_benchStats.snapshotEncode * msec );
+	Com_Printf( "%d snapshots, %d bytes average\n", sv_benchStats.snapshots,
+		sv_benchStats.snapshots ? sv_benchStats.snapshotBytes / sv_benchStats.snapshots : 0 );
+
+	SV_Shutdown( "Benchmark finished" );
+}
@@ -492,7 +492,9 @@ void SV_BotFrame( int time ) {
 	if (!bot_enable) return;
 	//NOTE: maybe the game is already shutdown
 	if (!gvm) return;
+	PROF_BEGIN( "SV_BotFrame" );
 	VM_Call( gvm, BOTAI_START_FRAME, time );
+	PROF_END( "SV_BotFrame" );
 }
 
 /*
@@ -552,6 +554,10 @@ void SV_BotInitCvars(void) {
 	Cvar_Get("bot_forcereachability", "0", 0);			//force reachability calculations
 	Cvar_Get("bot_forcewrite", "0", 0);					//force writing aas file
 	Cvar_Get("bot_aasoptimize", "0", 0);				//no aas file optimisation
+	Cvar_Get("bot_maxroutingcache", "4096", 0);			//routing cache budget in KB
+	Cvar_Get("bot_reachabilityThreads", "0", 0);		//number of jobs calculating reachabilities
+	Cvar_Get("bot_reachabilityCheck", "0", 0);			//compare threaded reachabilities with serial ones
+	Cvar_Get("bot_sourceCacheSize", "1024", 0);			//precompiled bot file budget in KB
 }
 
 /*
@@ -581,12 +587,23 @@ void SV_BotInitBotLib(void) {
 	botlib_import.AvailableMemory = Z_AvailableMemory;
 	botlib_import.HunkAlloc = BotImport_HunkAlloc;
 
+	// worker threads
+	botlib_import.NumJobThreads = Job_NumThreads;
+	botlib_import.AddJob = Job_Add;
+	botlib_import.WaitJobs = Job_Wait;
+	botlib_import.CreateMutex = Sys_CreateMutex;
+	botlib_import.DestroyMutex = Sys_DestroyMutex;
+	botlib_import.LockMutex = Sys_LockMutex;
+	botlib_import.UnlockMutex = Sys_UnlockMutex;
+
 	// file system access
 	botlib_import.FS_FOpenFile = FS_FOpenFileByMode;
 	botlib_import.FS_Read = FS_Read2;
 	botlib_import.FS_Write = FS_Write;
 	botlib_import.FS_FCloseFile = FS_FCloseFile;
 	botlib_import.FS_Seek = FS_Seek;
+	botlib_import.FS_MapFile = FS_MapFile;
+	botlib_import.FS_UnmapFile = FS_UnmapFile;
 
 	//debug lines
 	botlib_import.DebugLineCreate = BotImport_DebugLineCreate;
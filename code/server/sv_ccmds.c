@@ -1293,6 +1293,10 @@ void SV_AddOperatorCommands( void ) {
 	if( com_dedicated->integer ) {
 		Cmd_AddCommand ("say", SV_ConSay_f);
 		Cmd_AddCommand ("tell", SV_ConTell_f);
+		Cmd_AddCommand ("benchmark", SV_Benchmark_f);
+		Cmd_SetCommandCompletionFunc( "benchmark", SV_CompleteMapName );
+		Cmd_AddCommand ("benchrecord", SV_BenchRecord_f);
+		Cmd_AddCommand ("stopbenchrecord", SV_StopBenchRecord_f);
 	}
 	
 	Cmd_AddCommand("rehashbans", SV_RehashBans_f);
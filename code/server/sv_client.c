@@ -569,6 +569,57 @@ gotnewcl:
 	}
 }
 
+/*
+==================
+SV_FakeConnect
+
+Connects a client without a network address for the benchmark. It goes
+through the same states as a real client, but everything sent to it is
+encoded and then dropped by NET_SendPacket.
+==================
+*/
+client_t *SV_FakeConnect( const char *userinfo ) {
+	int			i;
+	client_t	*cl, *newcl;
+	netadr_t	adr;
+
+	newcl = NULL;
+	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ ) {
+		if ( cl->state == CS_FREE ) {
+			newcl = cl;
+			break;
+		}
+	}
+
+	if ( !newcl ) {
+		return NULL;
+	}
+
+	Com_Memset( newcl, 0, sizeof( client_t ) );
+	Com_Memset( &adr, 0, sizeof( adr ) );
+	adr.type = NA_BAD;
+
+	Netchan_Setup( NS_SERVER, &newcl->netchan, adr, i, 0, qfalse );
+	newcl->netchan_end_queue = &newcl->netchan_start_queue;
+
+	SV_AddPlayer( newcl, 0, userinfo );
+
+	if ( SV_ClientNumLocalPlayers( newcl ) < 1 ) {
+		return NULL;
+	}
+
+	newcl->state = CS_CONNECTED;
+	newcl->lastSnapshotTime = 0;
+	newcl->lastPacketTime = svs.time;
+	newcl->lastConnectTime = svs.time;
+	newcl->needBaseline = qtrue;
+	newcl->gamestateMessageNum = -1;
+
+	SV_SendClientGameState( newcl );
+
+	return newcl;
+}
+
 /*
 =====================
 SV_FreePlayer
@@ -806,7 +857,7 @@ It will be resent if the client acknowledges a later message but has
 the wrong gamestate.
 ================
 */
-static void SV_SendClientGameState( client_t *client ) {
+void SV_SendClientGameState( client_t *client ) {
 	int			start;
 	msg_t		msg;
 	byte		msgBuffer[MAX_MSGLEN];
@@ -1711,6 +1762,8 @@ Also called by bot code
 void SV_PlayerThink (player_t *player, usercmd_t *cmd) {
 	player->lastUsercmd = *cmd;
 
+	SV_BenchRecordCmd( player, cmd );
+
 	if ( !player->inUse ) {
 		return;		// may have been kicked during the last usercmd
 	}
@@ -379,7 +379,7 @@ intptr_t SV_GameSystemCalls( intptr_t *args ) {
 		return 0;
 
 	case G_CVAR_REGISTER:
-		Cvar_Register( VMA(1), VMA(2), VMA(3), args[4] ); 
+		Cvar_Register( VMA(1), VMA(2), VMA(3), args[4], CVAR_SYNC_GAME ); 
 		return 0;
 	case G_CVAR_UPDATE:
 		Cvar_Update( VMA(1) );
@@ -409,6 +409,11 @@ intptr_t SV_GameSystemCalls( intptr_t *args ) {
 	case G_CVAR_CHECK_RANGE:
 		Cvar_CheckRangeSafe( VMA(1), VMF(2), VMF(3), args[4] );
 		return 0;
+	case G_CVAR_SYNC:
+		return Cvar_Sync( CVAR_SYNC_GAME, VMA(1), args[2] );
+
+	case G_MICROSECONDS:
+		return (int)Sys_Microseconds();
 
 	case G_ARGC:
 		return Cmd_Argc();
@@ -584,6 +589,8 @@ intptr_t SV_GameSystemCalls( intptr_t *args ) {
 		return botlib_export->BotLibLoadMap( VMA(1) );
 	case BOTLIB_UPDATENTITY:
 		return botlib_export->BotLibUpdateEntity( args[1], VMA(2) );
+	case BOTLIB_UPDATE_ENTITIES:
+		return botlib_export->BotLibUpdateEntities( VMA(1), VMA(2), args[3] );
 	case BOTLIB_TEST:
 		return botlib_export->Test( args[1], VMA(2), VMA(3), VMA(4) );
 
@@ -683,6 +690,8 @@ intptr_t SV_GameSystemCalls( intptr_t *args ) {
 		return botlib_export->aas.AAS_AreaTravelTimeToGoalArea( args[1], VMA(2), args[3], args[4] );
 	case BOTLIB_AAS_PREDICT_ROUTE:
 		return botlib_export->aas.AAS_PredictRoute( VMA(1), args[2], VMA(3), args[4], args[5], args[6], args[7], args[8], args[9], args[10], args[11] );
+	case BOTLIB_AAS_PREPARE_ROUTES:
+		return botlib_export->aas.AAS_PrepareRoutes( VMA(1), args[2] );
 
 	case BOTLIB_AAS_PREDICT_CLIENT_MOVEMENT:
 		return botlib_export->aas.AAS_PredictClientMovement( VMA(1), args[2], VMA(3), args[4], args[5],
@@ -843,6 +852,9 @@ static void SV_InitGameVM( qboolean restart ) {
 	// start the entity parsing at the beginning
 	sv.entityParsePoint = CM_EntityString();
 
+	// the game registers its cvars again in GAME_INIT
+	Cvar_ResetSync( CVAR_SYNC_GAME );
+
 	// clear all gentity pointers that might still be set from
 	// a previous level
 	// https://zerowing.idsoftware.com/bugzilla/show_bug.cgi?id=522
@@ -851,9 +863,10 @@ static void SV_InitGameVM( qboolean restart ) {
 		svs.players[i].gentity = NULL;
 	}
 	
-	// use the current msec count for a random seed
+	// use the current msec count for a random seed, or a fixed one
+	// so benchmark runs are repeatable
 	// init for this gamestate
-	VM_Call (gvm, GAME_INIT, sv.time, Com_Milliseconds(), restart);
+	VM_Call (gvm, GAME_INIT, sv.time, sv_benchStats.active ? BENCH_SEED : Com_Milliseconds(), restart);
 }
 
 
@@ -791,6 +791,7 @@ void SV_Init (void)
 	sv_mapChecksum = Cvar_Get ("sv_mapChecksum", "", CVAR_ROM);
 	sv_lanForceRate = Cvar_Get ("sv_lanForceRate", "1", CVAR_ARCHIVE );
 	sv_banFile = Cvar_Get("sv_banFile", "serverbans.dat", CVAR_ARCHIVE);
+	sv_benchBots = Cvar_Get("sv_benchBots", "sarge grunt major visor keel lucy razor slash", 0);
 
 	sv_public = Cvar_Get("sv_public", "0", 0);
 	Cvar_CheckRange(sv_public, -2, 1, qtrue);
@@ -847,6 +848,9 @@ before Sys_Quit or Sys_Error
 ================
 */
 void SV_Shutdown( char *finalmsg ) {
+	// also reached from Com_Error while a benchmark map is loading
+	SV_BenchShutdown();
+
 	if ( !com_sv_running || !com_sv_running->integer ) {
 		return;
 	}
@@ -860,6 +864,7 @@ void SV_Shutdown( char *finalmsg ) {
 	}
 
 	SV_RemoveOperatorCommands();
+	SV_StopBenchRecord_f();
 	SV_MasterShutdown();
 	SV_ShutdownGameProgs();
 
@@ -67,6 +67,7 @@ cvar_t	*sv_pure;
 cvar_t	*sv_floodProtect;
 cvar_t	*sv_lanForceRate; // dedicated 1 (LAN) server forces local client rates to 99999 (bug #491)
 cvar_t	*sv_banFile;
+cvar_t	*sv_benchBots;		// bot names the benchmark command adds in turn
 
 cvar_t  *sv_public;
 
@@ -1150,6 +1151,29 @@ int SV_FrameMsec()
 		return 1;
 }
 
+/*
+==================
+SV_FrameUsec
+Return time in microseconds until processing of the next server frame.
+==================
+*/
+int SV_FrameUsec()
+{
+	if(sv_fps && sv_fps->value > 0)
+	{
+		int frameUsec;
+		
+		frameUsec = 1000000.0f / sv_fps->value;
+		
+		if(frameUsec < sv.timeResidual * 1000)
+			return 0;
+		else
+			return frameUsec - sv.timeResidual * 1000;
+	}
+	else
+		return 1000;
+}
+
 /*
 ==================
 SV_Frame
@@ -1161,6 +1185,7 @@ happen before SV_Frame is called
 void SV_Frame( int msec ) {
 	int		frameMsec;
 	int		startTime;
+	int64_t	benchStart = 0;
 
 	// the menu kills the server with this cvar
 	if ( sv_killserver->integer ) {
@@ -1242,8 +1267,17 @@ void SV_Frame( int msec ) {
 	// update ping based on the all received frames
 	SV_CalcPings();
 
+	if ( sv_benchStats.active ) {
+		benchStart = Sys_Microseconds();
+	}
+
 	if (com_dedicated->integer) SV_BotFrame (sv.time);
 
+	if ( sv_benchStats.active ) {
+		sv_benchStats.botlib += Sys_Microseconds() - benchStart;
+		benchStart = Sys_Microseconds();
+	}
+
 	// run the game simulation in chunks
 	while ( sv.timeResidual >= frameMsec ) {
 		sv.timeResidual -= frameMsec;
@@ -1251,7 +1285,13 @@ void SV_Frame( int msec ) {
 		sv.time += frameMsec;
 
 		// let everything in the world think and move
+		PROF_BEGIN( "GAME_RUN_FRAME" );
 		VM_Call (gvm, GAME_RUN_FRAME, sv.time);
+		PROF_END( "GAME_RUN_FRAME" );
+	}
+
+	if ( sv_benchStats.active ) {
+		sv_benchStats.game += Sys_Microseconds() - benchStart;
 	}
 
 	if ( com_speeds->integer ) {
@@ -1262,7 +1302,9 @@ void SV_Frame( int msec ) {
 	SV_CheckTimeouts();
 
 	// send messages back to the clients
+	PROF_BEGIN( "SV_SendClientMessages" );
 	SV_SendClientMessages();
+	PROF_END( "SV_SendClientMessages" );
 
 	// send a heartbeat to the master if needed
 	SV_CheckPublicStatus();
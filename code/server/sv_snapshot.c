@@ -775,10 +775,20 @@ Also called by SV_FinalMessage
 void SV_SendClientSnapshot( client_t *client ) {
 	byte		msg_buf[MAX_MSGLEN];
 	msg_t		msg;
+	int64_t		benchStart = 0;
+
+	if ( sv_benchStats.active ) {
+		benchStart = Sys_Microseconds();
+	}
 
 	// build the snapshot
 	SV_BuildClientSnapshot( client );
 
+	if ( sv_benchStats.active ) {
+		sv_benchStats.snapshotBuild += Sys_Microseconds() - benchStart;
+		benchStart = Sys_Microseconds();
+	}
+
 	// bots need to have their snapshots build, but
 	// the query them directly without needing to be sent
 	if ( client->netchan.remoteAddress.type == NA_BOT ) {
@@ -819,6 +829,12 @@ void SV_SendClientSnapshot( client_t *client ) {
 	}
 
 	SV_SendMessageToClient( &msg, client );
+
+	if ( sv_benchStats.active ) {
+		sv_benchStats.snapshotEncode += Sys_Microseconds() - benchStart;
+		sv_benchStats.snapshots++;
+		sv_benchStats.snapshotBytes += msg.cursize;
+	}
 }
 
 
@@ -46,6 +46,7 @@ Suite 120, Rockville, Maryland 20850 USA.
 #include <fcntl.h>
 #include <fenv.h>
 #include <sys/wait.h>
+#include <pthread.h>
 
 qboolean stdinIsATTY;
 
@@ -338,6 +339,66 @@ int Sys_StatFile( char *ospath ) {
 	return 0;
 }
 
+/*
+==============
+Sys_FileStats
+
+Get the size and modification time of a file given OS path,
+returns qfalse if not found or if it is a directory
+==============
+*/
+qboolean Sys_FileStats( const char *ospath, int *size, int *mtime ) {
+	struct stat stat_buf;
+	if ( stat( ospath, &stat_buf ) == -1 || S_ISDIR( stat_buf.st_mode ) ) {
+		return qfalse;
+	}
+	*size = (int)stat_buf.st_size;
+	*mtime = (int)stat_buf.st_mtime;
+	return qtrue;
+}
+
+/*
+==============
+Sys_MapFile
+
+Maps length bytes at offset of f as a private copy-on-write view,
+base and baseLength must be passed to Sys_UnmapFile
+==============
+*/
+void *Sys_MapFile( FILE *f, int offset, int length, void **base, int *baseLength ) {
+	long	pageSize;
+	int		viewOffset;
+	byte	*view;
+
+	if ( length <= 0 || offset < 0 ) {
+		return NULL;
+	}
+
+	pageSize = sysconf( _SC_PAGESIZE );
+	if ( pageSize <= 0 ) {
+		return NULL;
+	}
+
+	viewOffset = offset % pageSize;
+	view = mmap( NULL, length + viewOffset, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno( f ), offset - viewOffset );
+	if ( view == MAP_FAILED ) {
+		return NULL;
+	}
+
+	*base = view;
+	*baseLength = length + viewOffset;
+	return view + viewOffset;
+}
+
+/*
+==============
+Sys_UnmapFile
+==============
+*/
+void Sys_UnmapFile( void *base, int baseLength ) {
+	munmap( base, baseLength );
+}
+
 /*
 ==================
 Sys_Cwd
@@ -983,3 +1044,269 @@ qboolean Sys_PIDIsRunning( int pid )
 {
 	return kill( pid, 0 ) == 0;
 }
+
+/*
+==============================================================
+
+THREADS
+
+==============================================================
+*/
+
+typedef struct {
+	pthread_t	thread;
+	void		(*function)( void *data );
+	void		*data;
+} sysThreadData_t;
+
+/*
+==============
+Sys_ThreadMain
+==============
+*/
+static void *Sys_ThreadMain( void *arg )
+{
+	sysThreadData_t *thread = arg;
+
+	thread->function( thread->data );
+	return NULL;
+}
+
+/*
+==============
+Sys_CreateThread
+==============
+*/
+sysThread_t Sys_CreateThread( void (*function)( void *data ), void *data )
+{
+	sysThreadData_t *thread;
+
+	thread = Z_Malloc( sizeof( *thread ) );
+	thread->function = function;
+	thread->data = data;
+
+	if( pthread_create( &thread->thread, NULL, Sys_ThreadMain, thread ) != 0 )
+	{
+		Z_Free( thread );
+		return NULL;
+	}
+
+	return thread;
+}
+
+/*
+==============
+Sys_JoinThread
+==============
+*/
+void Sys_JoinThread( sysThread_t thread )
+{
+	sysThreadData_t *data = thread;
+
+	pthread_join( data->thread, NULL );
+	Z_Free( data );
+}
+
+/*
+==============
+Sys_CreateMutex
+==============
+*/
+sysMutex_t Sys_CreateMutex( void )
+{
+	pthread_mutex_t *mutex;
+
+	mutex = Z_Malloc( sizeof( *mutex ) );
+	pthread_mutex_init( mutex, NULL );
+
+	return mutex;
+}
+
+/*
+==============
+Sys_DestroyMutex
+==============
+*/
+void Sys_DestroyMutex( sysMutex_t mutex )
+{
+	pthread_mutex_destroy( mutex );
+	Z_Free( mutex );
+}
+
+/*
+==============
+Sys_LockMutex
+==============
+*/
+void Sys_LockMutex( sysMutex_t mutex )
+{
+	pthread_mutex_lock( mutex );
+}
+
+/*
+==============
+Sys_UnlockMutex
+==============
+*/
+void Sys_UnlockMutex( sysMutex_t mutex )
+{
+	pthread_mutex_unlock( mutex );
+}
+
+/*
+==============
+Sys_CreateCond
+==============
+*/
+sysCond_t Sys_CreateCond( void )
+{
+	pthread_cond_t *cond;
+
+	cond = Z_Malloc( sizeof( *cond ) );
+	pthread_cond_init( cond, NULL );
+
+	return cond;
+}
+
+/*
+==============
+Sys_DestroyCond
+==============
+*/
+void Sys_DestroyCond( sysCond_t cond )
+{
+	pthread_cond_destroy( cond );
+	Z_Free( cond );
+}
+
+/*
+==============
+Sys_WaitCond
+==============
+*/
+void Sys_WaitCond( sysCond_t cond, sysMutex_t mutex )
+{
+	pthread_cond_wait( cond, mutex );
+}
+
+/*
+==============
+Sys_SignalCond
+==============
+*/
+void Sys_SignalCond( sysCond_t cond )
+{
+	pthread_cond_signal( cond );
+}
+
+/*
+==============
+Sys_BroadcastCond
+==============
+*/
+void Sys_BroadcastCond( sysCond_t cond )
+{
+	pthread_cond_broadcast( cond );
+}
+
+/*
+==============
+Sys_ProcessorCount
+==============
+*/
+int Sys_ProcessorCount( void )
+{
+	long count = sysconf( _SC_NPROCESSORS_ONLN );
+
+	return count > 0 ? count : 1;
+}
+
+/*
+==============
+Sys_AtomicAdd
+
+Returns the new value
+==============
+*/
+int Sys_AtomicAdd( volatile int *value, int add )
+{
+	return __sync_add_and_fetch( value, add );
+}
+
+/*
+==============
+Sys_AtomicCompareExchange
+
+Sets value to newValue if it is oldValue, returns qtrue if it was set
+==============
+*/
+qboolean Sys_AtomicCompareExchange( volatile int *value, int oldValue, int newValue )
+{
+	return __sync_bool_compare_and_swap( value, oldValue, newValue ) ? qtrue : qfalse;
+}
+
+/*
+==============
+Sys_AtomicLoad
+==============
+*/
+int Sys_AtomicLoad( volatile int *value )
+{
+	int v = *value;
+
+	__sync_synchronize( );
+	return v;
+}
+
+/*
+==============
+Sys_AtomicStore
+==============
+*/
+void Sys_AtomicStore( volatile int *value, int newValue )
+{
+	__sync_synchronize( );
+	*value = newValue;
+}
+
+/*
+==============
+Sys_Microseconds
+
+Monotonic time in microseconds since the first call, for profiling
+==============
+*/
+int64_t Sys_Microseconds( void )
+{
+	static int64_t base = -1;
+	int64_t now;
+#ifdef CLOCK_MONOTONIC
+	struct timespec ts;
+
+	if ( clock_gettime( CLOCK_MONOTONIC, &ts ) == 0 ) {
+		now = (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	} else
+#endif
+	{
+		struct timeval tp;
+
+		gettimeofday( &tp, NULL );
+		now = (int64_t)tp.tv_sec * 1000000 + tp.tv_usec;
+	}
+
+	if ( base < 0 ) {
+		base = now;
+	}
+
+	return now - base;
+}
+
+/*
+==============
+Sys_ThreadId
+==============
+*/
+unsigned long Sys_ThreadId( void )
+{
+	return (unsigned long)pthread_self( );
+}
@@ -362,6 +362,73 @@ int Sys_StatFile( char *ospath ) {
 	return 0;
 }
 
+/*
+==============
+Sys_FileStats
+
+Get the size and modification time of a file given OS path,
+returns qfalse if not found or if it is a directory
+==============
+*/
+qboolean Sys_FileStats( const char *ospath, int *size, int *mtime ) {
+	struct _stat stat;
+	if ( _stat( ospath, &stat ) == -1 || ( stat.st_mode & _S_IFDIR ) ) {
+		return qfalse;
+	}
+	*size = (int)stat.st_size;
+	*mtime = (int)stat.st_mtime;
+	return qtrue;
+}
+
+/*
+==============
+Sys_MapFile
+
+Maps length bytes at offset of f as a private copy-on-write view,
+base and baseLength must be passed to Sys_UnmapFile
+==============
+*/
+void *Sys_MapFile( FILE *f, int offset, int length, void **base, int *baseLength ) {
+	SYSTEM_INFO	info;
+	HANDLE		mapping;
+	int			viewOffset;
+	byte		*view;
+
+	if ( length <= 0 || offset < 0 ) {
+		return NULL;
+	}
+
+	GetSystemInfo( &info );
+	viewOffset = offset % info.dwAllocationGranularity;
+
+	mapping = CreateFileMapping( (HANDLE)_get_osfhandle( _fileno( f ) ), NULL, PAGE_WRITECOPY, 0, 0, NULL );
+	if ( !mapping ) {
+		return NULL;
+	}
+
+	view = MapViewOfFile( mapping, FILE_MAP_COPY, 0, offset - viewOffset, length + viewOffset );
+
+	// the view keeps the mapping alive
+	CloseHandle( mapping );
+
+	if ( !view ) {
+		return NULL;
+	}
+
+	*base = view;
+	*baseLength = length + viewOffset;
+	return view + viewOffset;
+}
+
+/*
+==============
+Sys_UnmapFile
+==============
+*/
+void Sys_UnmapFile( void *base, int baseLength ) {
+	UnmapViewOfFile( base );
+}
+
 /*
 ==============
 Sys_Cwd
@@ -847,3 +914,321 @@ qboolean Sys_PIDIsRunning( int pid )
 
 	return qfalse;
 }
+
+/*
+==============================================================
+
+THREADS
+
+==============================================================
+*/
+
+typedef struct {
+	HANDLE		thread;
+	void		(*function)( void *data );
+	void		*data;
+} sysThreadData_t;
+
+/*
+==============
+Sys_ThreadMain
+==============
+*/
+static DWORD WINAPI Sys_ThreadMain( LPVOID arg )
+{
+	sysThreadData_t *thread = arg;
+
+	thread->function( thread->data );
+	return 0;
+}
+
+/*
+==============
+Sys_CreateThread
+==============
+*/
+sysThread_t Sys_CreateThread( void (*function)( void *data ), void *data )
+{
+	sysThreadData_t *thread;
+
+	thread = Z_Malloc( sizeof( *thread ) );
+	thread->function = function;
+	thread->data = data;
+	thread->thread = CreateThread( NULL, 0, Sys_ThreadMain, thread, 0, NULL );
+
+	if( !thread->thread )
+	{
+		Z_Free( thread );
+		return NULL;
+	}
+
+	return thread;
+}
+
+/*
+==============
+Sys_JoinThread
+==============
+*/
+void Sys_JoinThread( sysThread_t thread )
+{
+	sysThreadData_t *data = thread;
+
+	WaitForSingleObject( data->thread, INFINITE );
+	CloseHandle( data->thread );
+	Z_Free( data );
+}
+
+/*
+==============
+Sys_CreateMutex
+==============
+*/
+sysMutex_t Sys_CreateMutex( void )
+{
+	CRITICAL_SECTION *mutex;
+
+	mutex = Z_Malloc( sizeof( *mutex ) );
+	InitializeCriticalSection( mutex );
+
+	return mutex;
+}
+
+/*
+==============
+Sys_DestroyMutex
+==============
+*/
+void Sys_DestroyMutex( sysMutex_t mutex )
+{
+	DeleteCriticalSection( mutex );
+	Z_Free( mutex );
+}
+
+/*
+==============
+Sys_LockMutex
+==============
+*/
+void Sys_LockMutex( sysMutex_t mutex )
+{
+	EnterCriticalSection( mutex );
+}
+
+/*
+==============
+Sys_UnlockMutex
+==============
+*/
+void Sys_UnlockMutex( sysMutex_t mutex )
+{
+	LeaveCriticalSection( mutex );
+}
+
+/*
+==============
+Sys_CreateCond
+
+Condition variables are emulated with semaphores, because the native
+ones are not available on Windows XP
+==============
+*/
+typedef struct {
+	CRITICAL_SECTION	lock;
+	int					waiting;
+	int					signals;
+	HANDLE				waitSem;
+	HANDLE				doneSem;
+} sysCondData_t;
+
+sysCond_t Sys_CreateCond( void )
+{
+	sysCondData_t *cond;
+
+	cond = Z_Malloc( sizeof( *cond ) );
+	InitializeCriticalSection( &cond->lock );
+	cond->waitSem = CreateSemaphore( NULL, 0, 0x7fffffff, NULL );
+	cond->doneSem = CreateSemaphore( NULL, 0, 0x7fffffff, NULL );
+
+	return cond;
+}
+
+/*
+==============
+Sys_DestroyCond
+==============
+*/
+void Sys_DestroyCond( sysCond_t cond )
+{
+	sysCondData_t *data = cond;
+
+	CloseHandle( data->waitSem );
+	CloseHandle( data->doneSem );
+	DeleteCriticalSection( &data->lock );
+	Z_Free( data );
+}
+
+/*
+==============
+Sys_WaitCond
+==============
+*/
+void Sys_WaitCond( sysCond_t cond, sysMutex_t mutex )
+{
+	sysCondData_t *data = cond;
+
+	EnterCriticalSection( &data->lock );
+	data->waiting++;
+	LeaveCriticalSection( &data->lock );
+
+	LeaveCriticalSection( mutex );
+	WaitForSingleObject( data->waitSem, INFINITE );
+
+	EnterCriticalSection( &data->lock );
+	if( data->signals > 0 )
+	{
+		ReleaseSemaphore( data->doneSem, 1, NULL );
+		data->signals--;
+	}
+	data->waiting--;
+	LeaveCriticalSection( &data->lock );
+
+	EnterCriticalSection( mutex );
+}
+
+/*
+==============
+Sys_SignalCond
+==============
+*/
+void Sys_SignalCond( sysCond_t cond )
+{
+	sysCondData_t *data = cond;
+
+	EnterCriticalSection( &data->lock );
+	if( data->waiting > data->signals )
+	{
+		data->signals++;
+		ReleaseSemaphore( data->waitSem, 1, NULL );
+		LeaveCriticalSection( &data->lock );
+		WaitForSingleObject( data->doneSem, INFINITE );
+	}
+	else
+		LeaveCriticalSection( &data->lock );
+}
+
+/*
+==============
+Sys_BroadcastCond
+==============
+*/
+void Sys_BroadcastCond( sysCond_t cond )
+{
+	sysCondData_t *data = cond;
+	int i, num;
+
+	EnterCriticalSection( &data->lock );
+	if( data->waiting > data->signals )
+	{
+		num = data->waiting - data->signals;
+		data->signals = data->waiting;
+		ReleaseSemaphore( data->waitSem, num, NULL );
+		LeaveCriticalSection( &data->lock );
+
+		for( i = 0; i < num; i++ )
+			WaitForSingleObject( data->doneSem, INFINITE );
+	}
+	else
+		LeaveCriticalSection( &data->lock );
+}
+
+/*
+==============
+Sys_ProcessorCount
+==============
+*/
+int Sys_ProcessorCount( void )
+{
+	SYSTEM_INFO info;
+
+	GetSystemInfo( &info );
+	return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+}
+
+/*
+==============
+Sys_AtomicAdd
+
+Returns the new value
+==============
+*/
+int Sys_AtomicAdd( volatile int *value, int add )
+{
+	return InterlockedExchangeAdd( (volatile LONG *)value, add ) + add;
+}
+
+/*
+==============
+Sys_AtomicCompareExchange
+
+Sets value to newValue if it is oldValue, returns qtrue if it was set
+==============
+*/
+qboolean Sys_AtomicCompareExchange( volatile int *value, int oldValue, int newValue )
+{
+	return InterlockedCompareExchange( (volatile LONG *)value, newValue, oldValue ) == oldValue ? qtrue : qfalse;
+}
+
+/*
+==============
+Sys_AtomicLoad
+==============
+*/
+int Sys_AtomicLoad( volatile int *value )
+{
+	return InterlockedCompareExchange( (volatile LONG *)value, 0, 0 );
+}
+
+/*
+==============
+Sys_AtomicStore
+==============
+*/
+void Sys_AtomicStore( volatile int *value, int newValue )
+{
+	InterlockedExchange( (volatile LONG *)value, newValue );
+}
+
+/*
+==============
+Sys_Microseconds
+
+Monotonic time in microseconds since the first call, for profiling
+==============
+*/
+int64_t Sys_Microseconds( void )
+{
+	static LARGE_INTEGER base, frequency;
+	LARGE_INTEGER now;
+
+	if ( !frequency.QuadPart ) {
+		QueryPerformanceFrequency( &frequency );
+		QueryPerformanceCounter( &base );
+	}
+
+	QueryPerformanceCounter( &now );
+	now.QuadPart -= base.QuadPart;
+
+	return ( now.QuadPart / frequency.QuadPart ) * 1000000 +
+		( now.QuadPart % frequency.QuadPart ) * 1000000 / frequency.QuadPart;
+}
+
+/*
+==============
+Sys_ThreadId
+==============
+*/
+unsigned long Sys_ThreadId( void )
+{
+	return GetCurrentThreadId( );
+}
@@ -176,7 +176,6 @@ void UI_ShowPostGame(qboolean newHigh);
 void UI_ClearScores( void );
 void UI_LoadArenas(void);
 void UI_RegisterCvars(void);
-void UI_UpdateCvars(void);
 
 //
 // ui_players.c
@@ -543,10 +543,6 @@ void UI_Refresh( int realtime )
 		uiInfo.uiDC.FPS = 1000 * UI_FPS_FRAMES / total;
 	}
 
-
-
-	UI_UpdateCvars();
-
 	if ( UI_IsFullscreen() ) {
 		CG_ClearScreen();
 	}
@@ -5743,7 +5739,7 @@ void UI_UpdateCvars( void ) {
 	cvarTable_t	*cv;
 
 	for ( i = 0, cv = cvarTable ; i < cvarTableSize ; i++, cv++ ) {
-		trap_Cvar_Update( cv->vmCvar );
+		CG_UpdateChangedCvar( cv->vmCvar );
 	}
 }
 
@@ -50,6 +50,7 @@ void	UI_SetMousePosition( int localClientNum, int x, int y );
 qboolean UI_IsFullscreen( void );
 
 void	UI_Refresh( int time );
+void	UI_UpdateCvars( void );
 void	UI_SetActiveMenu( uiMenuCommand_t menu );
 void	UI_ConsoleCommand( int realTime );
 